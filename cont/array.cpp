@@ -1,4 +1,5 @@
 #include "array.h"
+#include "memory_usage.h"
 
 #include <algorithm>
 #include <iostream>
@@ -7,27 +8,31 @@
 #include <stdexcept>
 #include <utility>
 #include <cstdint>
+#include <memory>
+#include <new>
 
 // конструкторы / деструктор 
 
 MyArray::MyArray(std::size_t initialCapacity)
     : dataPtr(nullptr),
       capacity(initialCapacity),
-      length(0)
+      length(0),
+      gapBegin(0),
+      gapMode(false)
 {
     if (capacity == 0) {
         capacity = 1;
     }
 
-    dataPtr = new std::string[capacity];
+    dataPtr = allocateSlots(capacity);
 }
 
 MyArray::~MyArray()
 {
-    delete[] dataPtr;
+    destroyAll();
+    releaseSlots(dataPtr);
     dataPtr = nullptr;
     capacity = 0;
-    length = 0;
 }
 
 // копирующий конструктор 
@@ -35,11 +40,22 @@ MyArray::~MyArray()
 MyArray::MyArray(const MyArray& other)
     : dataPtr(nullptr),
       capacity(other.capacity),
-      length(other.length)
+      length(0),
+      gapBegin(0),
+      gapMode(other.gapMode)
 {
-    dataPtr = new std::string[capacity];
-    for (std::size_t i = 0; i < length; ++i) {
-        dataPtr[i] = other.dataPtr[i];
+    // копия без разрыва: элементы подряд, свободные слоты в конце
+    dataPtr = allocateSlots(capacity);
+    try {
+        for (std::size_t i = 0; i < other.length; ++i) {
+            ::new (static_cast<void*>(dataPtr + i)) std::string(other[i]);
+            ++length;
+            ++gapBegin;
+        }
+    } catch (...) {
+        destroyAll();
+        releaseSlots(dataPtr);
+        throw;
     }
 }
 
@@ -48,11 +64,14 @@ MyArray::MyArray(const MyArray& other)
 MyArray::MyArray(MyArray&& other) noexcept
     : dataPtr(other.dataPtr),
       capacity(other.capacity),
-      length(other.length)
+      length(other.length),
+      gapBegin(other.gapBegin),
+      gapMode(other.gapMode)
 {
     other.dataPtr = nullptr;
     other.capacity = 0;
     other.length = 0;
+    other.gapBegin = 0;
 }
 
 // копирующее присваивание 
@@ -76,15 +95,19 @@ MyArray& MyArray::operator=(MyArray&& other) noexcept
         return *this;
     }
 
-    delete[] dataPtr;
+    destroyAll();
+    releaseSlots(dataPtr);
 
     dataPtr = other.dataPtr;
     capacity = other.capacity;
     length = other.length;
+    gapBegin = other.gapBegin;
+    gapMode = other.gapMode;
 
     other.dataPtr = nullptr;
     other.capacity = 0;
     other.length = 0;
+    other.gapBegin = 0;
 
     return *this;
 }
@@ -97,16 +120,108 @@ void MyArray::swap(MyArray& other) noexcept
     swap(dataPtr, other.dataPtr);
     swap(capacity, other.capacity);
     swap(length, other.length);
+    swap(gapBegin, other.gapBegin);
+    swap(gapMode, other.gapMode);
+}
+
+// сырая память и разрыв 
+
+std::string* MyArray::allocateSlots(std::size_t count)
+{
+    if (count == 0) {
+        return nullptr;
+    }
+    if (count > std::numeric_limits<std::size_t>::max() / sizeof(std::string)) {
+        throw std::length_error("MyArray: capacity is too large");
+    }
+    return static_cast<std::string*>(::operator new(count * sizeof(std::string)));
+}
+
+void MyArray::releaseSlots(std::string* slots) noexcept
+{
+    ::operator delete(slots);
+}
+
+std::size_t MyArray::slotOf(std::size_t index) const noexcept
+{
+    return index < gapBegin ? index : index + (capacity - length);
+}
+
+void MyArray::moveGap(std::size_t position) noexcept
+{
+    // элементы между старым и новым местом разрыва переезжают через него;
+    // каждый целевой слот свободен к моменту переноса
+    const std::size_t gapSize = capacity - length;
+    if (gapSize == 0) {
+        gapBegin = position;
+        return;
+    }
+    while (gapBegin > position) {
+        --gapBegin;
+        ::new (static_cast<void*>(dataPtr + gapBegin + gapSize)) std::string(std::move(dataPtr[gapBegin]));
+        dataPtr[gapBegin].~basic_string();
+    }
+    while (gapBegin < position) {
+        ::new (static_cast<void*>(dataPtr + gapBegin)) std::string(std::move(dataPtr[gapBegin + gapSize]));
+        dataPtr[gapBegin + gapSize].~basic_string();
+        ++gapBegin;
+    }
+}
+
+void MyArray::destroyAll() noexcept
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        dataPtr[slotOf(i)].~basic_string();
+    }
+    length = 0;
+    gapBegin = 0;
+}
+
+void MyArray::appendLoaded(std::string&& value) noexcept
+{
+    // загрузка идёт в пустой массив: разрыв всегда в конце
+    ::new (static_cast<void*>(dataPtr + length)) std::string(std::move(value));
+    ++length;
+    ++gapBegin;
+}
+
+void MyArray::growForOneMore()
+{
+    resize(capacity == 0 ? 1 : capacity * 2);
+}
+
+void MyArray::setGapBuffer(bool enabled)
+{
+    if (!enabled) {
+        moveGap(length);
+    }
+    gapMode = enabled;
+}
+
+bool MyArray::gapBuffer() const noexcept
+{
+    return gapMode;
 }
 
 // базовые операции 
 
 void MyArray::pushBack(const std::string& value)
 {
+    if (gapMode) {
+        insert(length, value);
+        return;
+    }
+
     if (length == capacity) {
-        resize(capacity * 2);
+        // value может быть элементом этого массива: копия — до переезда
+        std::string item(value);
+        growForOneMore();
+        ::new (static_cast<void*>(dataPtr + length)) std::string(std::move(item));
+    } else {
+        ::new (static_cast<void*>(dataPtr + length)) std::string(value);
     }
-    dataPtr[length++] = value;
+    ++length;
+    ++gapBegin;
 }
 
 void MyArray::insert(std::size_t index, const std::string& value)
@@ -115,16 +230,31 @@ void MyArray::insert(std::size_t index, const std::string& value)
         throw std::out_of_range("MyArray::insert: error");
     }
 
+    std::string item(value);   // value может указывать внутрь массива
     if (length == capacity) {
-        resize(capacity * 2);
+        growForOneMore();
     }
 
-    for (std::size_t i = length; i > index; --i) {
-        dataPtr[i] = dataPtr[i - 1];
+    if (gapMode) {
+        // переезжают только элементы между разрывом и index
+        moveGap(index);
+        ::new (static_cast<void*>(dataPtr + gapBegin)) std::string(std::move(item));
+        ++gapBegin;
+        ++length;
+        return;
     }
 
-    dataPtr[index] = value;
+    if (index == length) {
+        ::new (static_cast<void*>(dataPtr + length)) std::string(std::move(item));
+    } else {
+        // сдвиг вправо перемещением: новый хвостовой слот конструируется,
+        // остальные получают строки соседей без копирования текста
+        ::new (static_cast<void*>(dataPtr + length)) std::string(std::move(dataPtr[length - 1]));
+        std::move_backward(dataPtr + index, dataPtr + length - 1, dataPtr + length);
+        dataPtr[index] = std::move(item);
+    }
     ++length;
+    ++gapBegin;
 }
 
 void MyArray::removeAt(std::size_t index)
@@ -133,10 +263,18 @@ void MyArray::removeAt(std::size_t index)
         throw std::out_of_range("MyArray::removeAt: error");
     }
 
-    for (std::size_t i = index; i + 1 < length; ++i) {
-        dataPtr[i] = dataPtr[i + 1];
+    if (gapMode) {
+        // элемент index оказывается сразу за разрывом и поглощается им
+        moveGap(index);
+        dataPtr[gapBegin + capacity - length].~basic_string();
+        --length;
+        return;
     }
+
+    std::move(dataPtr + index + 1, dataPtr + length, dataPtr + index);
+    dataPtr[length - 1].~basic_string();
     --length;
+    --gapBegin;
 }
 
 std::string& MyArray::at(std::size_t index)
@@ -144,7 +282,7 @@ std::string& MyArray::at(std::size_t index)
     if (index >= length) {
         throw std::out_of_range("MyArray::at: error");
     }
-    return dataPtr[index];
+    return dataPtr[slotOf(index)];
 }
 
 const std::string& MyArray::at(std::size_t index) const
@@ -152,7 +290,7 @@ const std::string& MyArray::at(std::size_t index) const
     if (index >= length) {
         throw std::out_of_range("MyArray::at: error");
     }
-    return dataPtr[index];
+    return dataPtr[slotOf(index)];
 }
 
 void MyArray::set(std::size_t index, const std::string& value)
@@ -160,19 +298,19 @@ void MyArray::set(std::size_t index, const std::string& value)
     if (index >= length) {
         throw std::out_of_range("MyArray::set: error");
     }
-    dataPtr[index] = value;
+    dataPtr[slotOf(index)] = value;
 }
 
 // operator[] 
 
 std::string& MyArray::operator[](std::size_t index) noexcept
 {
-    return dataPtr[index];
+    return dataPtr[slotOf(index)];
 }
 
 const std::string& MyArray::operator[](std::size_t index) const noexcept
 {
-    return dataPtr[index];
+    return dataPtr[slotOf(index)];
 }
 
 // вспомогательные методы 
@@ -192,11 +330,26 @@ bool MyArray::empty() const noexcept
     return length == 0;
 }
 
+std::size_t MyArray::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(MyArray);
+    if (dataPtr == nullptr) {
+        return total;
+    }
+
+    total += memory_usage::heapBlock(capacity * sizeof(std::string));
+    // слоты разрыва не сконструированы и памяти строк не держат
+    for (std::size_t i = 0; i < length; ++i) {
+        total += memory_usage::stringHeap((*this)[i]);
+    }
+    return total;
+}
+
 void MyArray::print() const
 {
     std::cout << "[";
     for (std::size_t i = 0; i < length; ++i) {
-        std::cout << dataPtr[i];
+        std::cout << (*this)[i];
         if (i + 1 < length) {
             std::cout << ", ";
         }
@@ -210,16 +363,34 @@ void MyArray::resize(std::size_t newCapacity)
         newCapacity = 1;
     }
 
-    length = std::min(newCapacity, length);
-
-    std::string* newData = new std::string[newCapacity];
-    for (std::size_t i = 0; i < length; ++i) {
-        newData[i] = dataPtr[i];
+    // при ошибке выделения массив не меняется; перенос строк не бросает.
+    // В новом буфере элементы подряд, разрыв — в конце
+    std::string* newData = allocateSlots(newCapacity);
+    const std::size_t kept = std::min(newCapacity, length);
+    for (std::size_t i = 0; i < kept; ++i) {
+        ::new (static_cast<void*>(newData + i)) std::string(std::move((*this)[i]));
     }
 
-    delete[] dataPtr;
+    destroyAll();
+    releaseSlots(dataPtr);
     dataPtr = newData;
     capacity = newCapacity;
+    length = kept;
+    gapBegin = kept;
+}
+
+void MyArray::reserve(std::size_t minCapacity)
+{
+    if (minCapacity > capacity) {
+        resize(minCapacity);
+    }
+}
+
+void MyArray::shrinkToFit()
+{
+    if (capacity > std::max<std::size_t>(length, 1)) {
+        resize(length);
+    }
 }
 
 // текстовая сериализация через поток 
@@ -228,7 +399,7 @@ void MyArray::serializeText(std::ostream& outputStream) const
 {
     outputStream << length << '\n';
     for (std::size_t i = 0; i < length; ++i) {
-        outputStream << dataPtr[i] << '\n';
+        outputStream << (*this)[i] << '\n';
     }
 }
 
@@ -241,15 +412,18 @@ void MyArray::deserializeText(std::istream& inputStream)
 
     inputStream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-    if (newLength > capacity) {
-        resize(newLength);
-    }
+    destroyAll();
+    reserve(memory_usage::trustedReserve(newLength));
 
-    length = newLength; 
-    for (std::size_t i = 0; i < length; ++i) {
-        if (!std::getline(inputStream, dataPtr[i])) { // чтение строки с учётом пробелов
+    std::string line;
+    for (std::size_t i = 0; i < newLength; ++i) {
+        if (!std::getline(inputStream, line)) { // чтение строки с учётом пробелов
             throw std::runtime_error("MyArray::deserializeText: error");
         }
+        if (length == capacity) {
+            growForOneMore();
+        }
+        appendLoaded(std::move(line));
     }
 }
 
@@ -276,7 +450,7 @@ void MyArray::serializeBinary(std::ostream& outputStream) const
     outputStream.write(reinterpret_cast<const char*>(&len), sizeof(len)); // запись длины
 
     for (std::size_t i = 0; i < length; ++i) { // запись каждого элемента
-        const std::string& text = dataPtr[i]; // текущая строка
+        const std::string& text = (*this)[i]; // текущая строка
         std::uint64_t sizeValue = static_cast<std::uint64_t>(text.size()); // размер строки
         outputStream.write(reinterpret_cast<const char*>(&sizeValue), sizeof(sizeValue)); // запись размера строки
         if (sizeValue > 0) { 
@@ -297,13 +471,11 @@ void MyArray::deserializeBinary(std::istream& inputStream)
         throw std::runtime_error("MyArray::deserializeBinary: error");
     }
 
-    if (len > static_cast<std::uint64_t>(capacity)) {
-        resize(static_cast<std::size_t>(len));
-    }
-
-    length = static_cast<std::size_t>(len);
+    // len из файла не проверен: резерв ограничен, дальше — обычный рост
+    destroyAll();
+    reserve(memory_usage::trustedReserve(len));
 
-    for (std::size_t i = 0; i < length; ++i) {
+    for (std::uint64_t i = 0; i < len; ++i) {
         std::uint64_t sizeValue = 0;
         inputStream.read(reinterpret_cast<char*>(&sizeValue), sizeof(sizeValue));
         if (!inputStream) {
@@ -318,6 +490,9 @@ void MyArray::deserializeBinary(std::istream& inputStream)
                 throw std::runtime_error("MyArray::deserializeBinary: error");
             }
         }
-        dataPtr[i] = std::move(tmp);
+        if (length == capacity) {
+            growForOneMore();
+        }
+        appendLoaded(std::move(tmp));
     }
 }
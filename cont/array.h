@@ -38,9 +38,20 @@ public:
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] std::size_t getCapacity() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
 
     void print() const;
+    // новая ёмкость; элементы за её пределами удаляются
     void resize(std::size_t newCapacity);
+    void reserve(std::size_t minCapacity);   // только увеличивает ёмкость
+    void shrinkToFit();                      // ёмкость = size() (не меньше 1)
+
+    // Режим буфера с разрывом: свободные слоты держатся у места последней
+    // правки, поэтому серия insert/removeAt рядом с одной позицией стоит
+    // O(1) амортизированно, а не O(n). Доступ по индексу остаётся O(1)
+    // (одно сравнение с началом разрыва). Выключение сдвигает разрыв в конец.
+    void setGapBuffer(bool enabled);
+    [[nodiscard]] bool gapBuffer() const noexcept;
 
     // ТЕКСТОВАЯ СЕРИАЛИЗАЦИЯ (в строку) 
     [[nodiscard]] std::string serialize() const;
@@ -58,7 +69,23 @@ public:
     void swap(MyArray& other) noexcept;
 
 private:
+    // Память под строки выделяется без конструирования. Элементы лежат в
+    // слотах [0, gapBegin) и [gapBegin + capacity - length, capacity),
+    // между ними — разрыв из несконструированных слотов. Без режима буфера
+    // с разрывом gapBegin == length. Рост и сдвиги перемещают строки, а не
+    // копируют их содержимое.
     std::string* dataPtr;   // указатель на массив строк
     std::size_t capacity;   // вместимость
     std::size_t length;     // текущее количество элементов
+    std::size_t gapBegin;   // первый слот разрыва
+    bool gapMode;
+
+    static std::string* allocateSlots(std::size_t count);
+    static void releaseSlots(std::string* slots) noexcept;
+    [[nodiscard]] std::size_t slotOf(std::size_t index) const noexcept;
+    void moveGap(std::size_t position) noexcept;   // разрыв перед элементом position
+    void destroyAll() noexcept;
+    void appendLoaded(std::string&& value) noexcept;   // место уже есть
+    // место под ещё один элемент (рост вдвое)
+    void growForOneMore();
 };
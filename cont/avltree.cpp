@@ -1,4 +1,6 @@
 #include "avltree.h"
+#include "memory_usage.h"
+#include "parallel.h"
 
 #include <algorithm>
 #include <iostream>
@@ -8,266 +10,1009 @@
 #include <vector>
 #include <cstdint>
 
+namespace
+{
+// первый байт бинарного снапшота: 0/1 — флаг корня в префиксном
+// формате, kSortedSnapshot — значения по возрастанию
+constexpr std::uint8_t kSortedSnapshot = 2;
+// меньшие поддеревья операций над множествами не делятся между потоками
+constexpr std::size_t kSetMinPerWorker = std::size_t{1} << 15;
+
+// сколько уровней рекурсии можно делить между потоками
+int setOperationForks(std::size_t work) noexcept
+{
+    unsigned workers = parallel::workerCount(work, kSetMinPerWorker);
+    int forks = 0;
+    while (workers > 1) {
+        workers /= 2;
+        ++forks;
+    }
+    return forks;
+}
+
+// левая половина работы — во втором потоке, если бюджет позволяет
+template <class Left, class Right>
+void forkJoin(int forks, Left&& left, Right&& right)
+{
+    if (forks <= 0) {
+        left();
+        right();
+        return;
+    }
+    try {
+        parallel::runParts(2, [&](unsigned part) {
+            if (part == 0) {
+                left();
+            } else {
+                right();
+            }
+        });
+    } catch (...) {
+        // поток не запустился — ни одна из половин ещё не выполнялась,
+        // сами половины исключений не бросают
+        left();
+        right();
+    }
+}
+} // namespace
+
 //  конструктор / деструктор 
 
 AvlTree::AvlTree()
-    : root_(nullptr),
+    : root_(kNil),
+      freeHead_(kNil),
       size_(0)
 {
 }
 
-AvlTree::~AvlTree()
+// узлы освобождаются вместе с пулом, обход дерева не нужен
+AvlTree::~AvlTree() = default;
+
+void AvlTree::clear() noexcept
 {
-    clearSubtree(root_);
-    root_ = nullptr;
+    std::vector<Node>().swap(nodes_);
+    root_ = kNil;
+    freeHead_ = kNil;
     size_ = 0;
+    if (bloom_.active()) {
+        bloom_.clearBits();
+    }
 }
 
-//  вспомогательные функции очистки/клонирования 
+//  пул узлов
 
-void AvlTree::clearSubtree(Node* node) noexcept
+void AvlTree::reserveNode()
 {
-    if (node == nullptr) {
+    if (freeHead_ != kNil) {
         return;
     }
-    clearSubtree(node->left);
-    clearSubtree(node->right);
-    delete node;
+    if (nodes_.size() >= kMaxNodes) {
+        throw std::length_error("AvlTree: too many nodes");
+    }
+    if (nodes_.size() == nodes_.capacity()) {
+        nodes_.reserve(std::max<std::size_t>(nodes_.capacity() * 2, 8));
+    }
 }
 
-AvlTree::Node* AvlTree::cloneSubtree(Node* node)
+AvlTree::Index AvlTree::allocateNode(InternedString value)
 {
-    if (node == nullptr) {
-        return nullptr;
+    reserveNode();
+    if (freeHead_ != kNil) {
+        const Index node = freeHead_;
+        freeHead_ = nodes_[node].left;
+        nodes_[node] = Node(std::move(value));
+        return node;
     }
+    nodes_.emplace_back(std::move(value));
+    return static_cast<Index>(nodes_.size() - 1);
+}
 
-    Node* newNode = new Node(node->value);
-    newNode->height = node->height;
-    newNode->left = cloneSubtree(node->left);
-    newNode->right = cloneSubtree(node->right);
-    return newNode;
+void AvlTree::freeNode(Index node) noexcept
+{
+    nodes_[node].value = InternedString{};
+    nodes_[node].left = freeHead_;
+    freeHead_ = node;
 }
 
-//  высота / баланс 
+void AvlTree::releaseNode(Index node, FreeChain& chain) noexcept
+{
+    nodes_[node].value = InternedString{};
+    nodes_[node].left = chain.head;
+    chain.head = node;
+    if (chain.tail == kNil) {
+        chain.tail = node;
+    }
+}
 
-int AvlTree::heightOf(Node* node) noexcept
+void AvlTree::mergeChains(FreeChain& into, const FreeChain& from) noexcept
 {
-    return node != nullptr ? node->height : 0;
+    if (from.head == kNil) {
+        return;
+    }
+    nodes_[from.tail].left = into.head;
+    into.head = from.head;
+    if (into.tail == kNil) {
+        into.tail = from.tail;
+    }
 }
 
-int AvlTree::balanceFactor(Node* node) noexcept
+void AvlTree::spliceFree(const FreeChain& chain) noexcept
 {
-    return node != nullptr ? heightOf(node->left) - heightOf(node->right) : 0;
+    if (chain.head == kNil) {
+        return;
+    }
+    nodes_[chain.tail].left = freeHead_;
+    freeHead_ = chain.head;
 }
 
-//  повороты 
+void AvlTree::clearSubtree(Index node, FreeChain& chain) noexcept
+{
+    // левые дети поворотами переносятся вправо: дерево вытягивается
+    // в правую цепочку и освобождается без стека и рекурсии
+    while (node != kNil) {
+        Node& current = nodes_[node];
+        if (current.left != kNil) {
+            const Index leftChild = current.left;
+            current.left = nodes_[leftChild].right;
+            nodes_[leftChild].right = node;
+            node = leftChild;
+        } else {
+            const Index nextNode = current.right;
+            releaseNode(node, chain);
+            node = nextNode;
+        }
+    }
+}
 
-AvlTree::Node* AvlTree::rotateRight(Node* parentNode)
+AvlTree::Index AvlTree::cloneSubtree(const AvlTree& source, Index node)
 {
-    Node* leftChild = parentNode->left;
-    Node* transferSubtree = leftChild->right;
+    if (node == kNil) {
+        return kNil;
+    }
 
-    leftChild->right = parentNode;
-    parentNode->left = transferSubtree;
+    // место под все копии выделяется заранее: пул не переезжает,
+    // поэтому source может быть этим же деревом
+    const std::size_t count = source.countOf(node);
+    if (nodes_.size() + count > kMaxNodes) {
+        throw std::length_error("AvlTree: too many nodes");
+    }
+    if (nodes_.capacity() - nodes_.size() < count) {
+        nodes_.reserve(std::max(nodes_.size() + count, nodes_.capacity() * 2));
+    }
 
-    parentNode->height = std::max(heightOf(parentNode->left), heightOf(parentNode->right)) + 1;
-    leftChild->height = std::max(heightOf(leftChild->left), heightOf(leftChild->right)) + 1;
+    auto copyNode = [this, &source](Index original) {
+        const Index copy = allocateNode(source.nodes_[original].value);
+        nodes_[copy].height = source.nodes_[original].height;
+        nodes_[copy].count = source.nodes_[original].count;
+        return copy;
+    };
+
+    // пары (оригинал, копия), у которых ещё не скопированы дети;
+    // в стеке не больше высоты дерева + 1 пар
+    std::pair<Index, Index> stack[kMaxHeight + 1];
+    int top = 0;
+    const Index copyRoot = copyNode(node);
+    stack[top++] = {node, copyRoot};
+
+    while (top > 0) {
+        const auto [original, copy] = stack[--top];
+        const Index right = source.nodes_[original].right;
+        const Index left = source.nodes_[original].left;
+        if (right != kNil) {
+            const Index rightCopy = copyNode(right);
+            nodes_[copy].right = rightCopy;
+            stack[top++] = {right, rightCopy};
+        }
+        if (left != kNil) {
+            const Index leftCopy = copyNode(left);
+            nodes_[copy].left = leftCopy;
+            stack[top++] = {left, leftCopy};
+        }
+    }
+    return copyRoot;
+}
 
-    return leftChild;
+void AvlTree::adoptNodes(AvlTree& loaded) noexcept
+{
+    // старые узлы уходят в loaded и освобождаются вместе с ним
+    using std::swap;
+    swap(nodes_, loaded.nodes_);
+    swap(root_, loaded.root_);
+    swap(freeHead_, loaded.freeHead_);
+    swap(size_, loaded.size_);
 }
 
-AvlTree::Node* AvlTree::rotateLeft(Node* parentNode)
+template <class Visit>
+void AvlTree::walkPreorder(Visit&& visit) const
 {
-    Node* rightChild= parentNode->right;
-    Node* transferSubtree = rightChild->left;
+    // префиксный обход с пустыми поддеревьями; в стеке не больше высоты + 1
+    Index stack[kMaxHeight + 1];
+    int top = 0;
+    stack[top++] = root_;
+
+    while (top > 0) {
+        const Index node = stack[--top];
+        if (node == kNil) {
+            visit(nullptr);
+            continue;
+        }
+        const Node& current = nodes_[node];
+        visit(&current);
+        stack[top++] = current.right;
+        stack[top++] = current.left;
+    }
+}
 
-    rightChild->left = parentNode;
-    parentNode->right = transferSubtree;
+template <class ReadValue>
+AvlTree AvlTree::buildPreorder(ReadValue&& readValue, const char* where)
+{
+    // сборка во временное дерево: при ошибке оно освобождается целиком
+    AvlTree tree;
+    std::vector<Index> order;   // узлы в префиксном порядке
+    // ещё не прочитанные поддеревья: (родитель, правый ли ребёнок)
+    std::vector<std::pair<Index, bool>> pending{{kNil, false}};
+    std::string value;
 
-    parentNode->height = std::max(heightOf(parentNode->left), heightOf(parentNode->right)) + 1;
-    rightChild->height = std::max(heightOf(rightChild->left), heightOf(rightChild->right)) + 1;
+    // форма из файла не проверена: глубина ограничена только памятью
+    while (!pending.empty()) {
+        const auto [parent, isRight] = pending.back();
+        pending.pop_back();
+        if (!readValue(value)) {
+            continue;   // пустое поддерево, ссылка уже kNil
+        }
 
-    return rightChild;
+        const Index node = tree.allocateNode(InternedString(value));
+        if (parent == kNil) {
+            tree.root_ = node;
+        } else if (isRight) {
+            tree.nodes_[parent].right = node;
+        } else {
+            tree.nodes_[parent].left = node;
+        }
+        order.push_back(node);
+        pending.emplace_back(node, true);
+        pending.emplace_back(node, false);
+    }
+
+    // в обратном префиксном порядке дети идут раньше родителей,
+    // проверка высоты не даёт ей переполнить int8_t
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        tree.updateNode(*it);
+        const int balance = tree.balanceFactor(*it);
+        if (balance > 1 || balance < -1 || tree.heightOf(*it) > kMaxHeight) {
+            throw std::runtime_error(std::string(where) + ": tree is not balanced");
+        }
+    }
+    if (!tree.isOrdered()) {
+        throw std::runtime_error(std::string(where) + ": tree is not ordered");
+    }
+
+    tree.size_ = order.size();
+    return tree;
 }
 
-//  вставка 
+bool AvlTree::isOrdered() const noexcept
+{
+    // симметричный обход: значения строго возрастают
+    Index stack[kMaxHeight];
+    int top = 0;
+    Index node = root_;
+    const Node* previous = nullptr;
+
+    while (node != kNil || top > 0) {
+        while (node != kNil) {
+            stack[top++] = node;
+            node = nodes_[node].left;
+        }
+        const Node& current = nodes_[stack[--top]];
+        if (previous != nullptr && !(previous->value.view() < current.value.view())) {
+            return false;
+        }
+        previous = &current;
+        node = current.right;
+    }
+    return true;
+}
+
+AvlTree::Index AvlTree::buildBalanced(InternedString* values, std::size_t count)
+{
+    // середина — корень, половины отличаются не больше чем на узел:
+    // дерево сбалансировано, глубина рекурсии — log2(count)
+    if (count == 0) {
+        return kNil;
+    }
+
+    const std::size_t middle = count / 2;
+    const Index left = buildBalanced(values, middle);
+    const Index node = allocateNode(std::move(values[middle]));
+    const Index right = buildBalanced(values + middle + 1, count - middle - 1);
+    nodes_[node].left = left;
+    nodes_[node].right = right;
+    updateNode(node);
+    return node;
+}
+
+void AvlTree::buildFromSorted(const std::vector<std::string>& values)
+{
+    std::vector<InternedString> interned;
+    interned.reserve(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i > 0 && !(values[i - 1] < values[i])) {
+            throw std::runtime_error("AvlTree::buildFromSorted: values are not strictly increasing");
+        }
+        interned.emplace_back(values[i]);
+    }
+
+    // при ошибке временное дерево освобождает уже созданные узлы
+    AvlTree built;
+    built.nodes_.reserve(interned.size());
+    built.root_ = built.buildBalanced(interned.data(), interned.size());
+    built.size_ = interned.size();
+    adoptNodes(built);
+
+    if (bloom_.active()) {
+        rebuildBloomFilter();
+    }
+}
+
+//  split / join и операции над множествами
 
-AvlTree::Node* AvlTree::insertNode(Node* node, const std::string& value, bool& inserted)
+AvlTree::Index AvlTree::joinRight(Index left, Index middle, Index right) noexcept
 {
-    if (node == nullptr) {
-        inserted = true;
-        return new Node(value);
+    // спуск по правому краю left до поддерева не выше right + 1
+    Node& leftNode = nodes_[left];
+    if (heightOf(leftNode.right) <= heightOf(right) + 1) {
+        nodes_[middle].left = leftNode.right;
+        nodes_[middle].right = right;
+        updateNode(middle);
+        leftNode.right = middle;
+    } else {
+        leftNode.right = joinRight(leftNode.right, middle, right);
     }
+    return rebalance(left);
+}
 
-    if (value < node->value) {
-        node->left = insertNode(node->left, value, inserted);
-    } else if (value > node->value) {
-        node->right = insertNode(node->right, value, inserted);
+AvlTree::Index AvlTree::joinLeft(Index left, Index middle, Index right) noexcept
+{
+    Node& rightNode = nodes_[right];
+    if (heightOf(rightNode.left) <= heightOf(left) + 1) {
+        nodes_[middle].left = left;
+        nodes_[middle].right = rightNode.left;
+        updateNode(middle);
+        rightNode.left = middle;
     } else {
-        inserted = false;
+        rightNode.left = joinLeft(left, middle, rightNode.left);
+    }
+    return rebalance(right);
+}
+
+AvlTree::Index AvlTree::joinNodes(Index left, Index middle, Index right) noexcept
+{
+    // O(|h(left) - h(right)| + 1); рекурсия не глубже высоты дерева
+    const int leftHeight = heightOf(left);
+    const int rightHeight = heightOf(right);
+    if (leftHeight > rightHeight + 1) {
+        return joinRight(left, middle, right);
+    }
+    if (rightHeight > leftHeight + 1) {
+        return joinLeft(left, middle, right);
+    }
+    nodes_[middle].left = left;
+    nodes_[middle].right = right;
+    updateNode(middle);
+    return middle;
+}
+
+AvlTree::Index AvlTree::splitLast(Index node, Index& last) noexcept
+{
+    Node& current = nodes_[node];
+    if (current.right == kNil) {
+        last = node;
+        const Index rest = current.left;
+        current.left = kNil;
+        updateNode(node);
+        return rest;
+    }
+    const Index rest = splitLast(current.right, last);
+    return joinNodes(current.left, node, rest);
+}
+
+AvlTree::Index AvlTree::joinPair(Index left, Index right) noexcept
+{
+    if (left == kNil) {
+        return right;
+    }
+    Index last = kNil;
+    const Index rest = splitLast(left, last);
+    return joinNodes(rest, last, right);
+}
+
+AvlTree::Index AvlTree::splitNodes(Index node, std::string_view value,
+                                   Index& left, Index& right) noexcept
+{
+    if (node == kNil) {
+        left = kNil;
+        right = kNil;
+        return kNil;
+    }
+
+    Node& current = nodes_[node];
+    const int order = value.compare(current.value.view());
+    if (order == 0) {
+        left = current.left;
+        right = current.right;
+        current.left = kNil;
+        current.right = kNil;
+        updateNode(node);
         return node;
     }
 
-    node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
-    const int balance = balanceFactor(node);
+    Index found = kNil;
+    if (order < 0) {
+        Index rightPart = kNil;
+        found = splitNodes(current.left, value, left, rightPart);
+        right = joinNodes(rightPart, node, current.right);
+    } else {
+        Index leftPart = kNil;
+        found = splitNodes(current.right, value, leftPart, right);
+        left = joinNodes(current.left, node, leftPart);
+    }
+    return found;
+}
 
-    // LL
-    if (balance > 1 && value < node->left->value) {
-        return rotateRight(node);
+// Половины работают с непересекающимися узлами одного пула: пул не
+// перевыделяется, каждая ветвь копит освобождённые узлы в своей цепочке.
+
+AvlTree::Index AvlTree::unionNodes(Index a, Index b, int forks, FreeChain& freed) noexcept
+{
+    if (a == kNil) {
+        return b;
+    }
+    if (b == kNil) {
+        return a;
     }
 
-    // RR
-    if (balance < -1 && value > node->right->value) {
-        return rotateLeft(node);
+    Index leftB = kNil;
+    Index rightB = kNil;
+    const Index duplicate = splitNodes(b, nodes_[a].value.view(), leftB, rightB);
+    if (duplicate != kNil) {
+        releaseNode(duplicate, freed);   // дубликат корня a
+    }
+
+    const Index leftA = nodes_[a].left;
+    const Index rightA = nodes_[a].right;
+    Index leftResult = kNil;
+    Index rightResult = kNil;
+    FreeChain leftFreed;
+    const int childForks = countOf(a) + countOf(leftB) + countOf(rightB) >= 2 * kSetMinPerWorker ? forks : 0;
+    forkJoin(childForks,
+             [&] { leftResult = unionNodes(leftA, leftB, forks - 1, leftFreed); },
+             [&] { rightResult = unionNodes(rightA, rightB, forks - 1, freed); });
+    mergeChains(freed, leftFreed);
+    return joinNodes(leftResult, a, rightResult);
+}
+
+AvlTree::Index AvlTree::intersectNodes(Index a, const AvlTree& other, Index b,
+                                       int forks, FreeChain& freed) noexcept
+{
+    // a делится по корню b, само other только читается
+    if (a == kNil || b == kNil) {
+        clearSubtree(a, freed);
+        return kNil;
+    }
+
+    const Node& pivot = other.nodes_[b];
+    Index leftA = kNil;
+    Index rightA = kNil;
+    const Index found = splitNodes(a, pivot.value.view(), leftA, rightA);
+
+    Index leftResult = kNil;
+    Index rightResult = kNil;
+    FreeChain leftFreed;
+    const int childForks = countOf(leftA) + countOf(rightA) + other.countOf(b) >= 2 * kSetMinPerWorker ? forks : 0;
+    forkJoin(childForks,
+             [&] { leftResult = intersectNodes(leftA, other, pivot.left, forks - 1, leftFreed); },
+             [&] { rightResult = intersectNodes(rightA, other, pivot.right, forks - 1, freed); });
+    mergeChains(freed, leftFreed);
+
+    if (found != kNil) {
+        return joinNodes(leftResult, found, rightResult);
+    }
+    return joinPair(leftResult, rightResult);
+}
+
+AvlTree::Index AvlTree::subtractNodes(Index a, const AvlTree& other, Index b,
+                                      int forks, FreeChain& freed) noexcept
+{
+    if (a == kNil || b == kNil) {
+        return a;
+    }
+
+    const Node& pivot = other.nodes_[b];
+    Index leftA = kNil;
+    Index rightA = kNil;
+    const Index removed = splitNodes(a, pivot.value.view(), leftA, rightA);
+    if (removed != kNil) {
+        releaseNode(removed, freed);   // удаляемое значение
+    }
+
+    Index leftResult = kNil;
+    Index rightResult = kNil;
+    FreeChain leftFreed;
+    const int childForks = countOf(leftA) + countOf(rightA) + other.countOf(b) >= 2 * kSetMinPerWorker ? forks : 0;
+    forkJoin(childForks,
+             [&] { leftResult = subtractNodes(leftA, other, pivot.left, forks - 1, leftFreed); },
+             [&] { rightResult = subtractNodes(rightA, other, pivot.right, forks - 1, freed); });
+    mergeChains(freed, leftFreed);
+    return joinPair(leftResult, rightResult);
+}
+
+void AvlTree::finishSetOperation(Index root, const FreeChain& freed)
+{
+    root_ = root;
+    spliceFree(freed);
+    size_ = countOf(root_);
+    if (bloom_.active()) {
+        rebuildBloomFilter();
+    }
+}
+
+void AvlTree::unionWith(const AvlTree& other)
+{
+    // результат не меньше other: его узлы всё равно придётся создать,
+    // поэтому other копируется в пул и объединяется разрушающим алгоритмом
+    const Index copy = cloneSubtree(other, other.root_);
+    FreeChain freed;
+    finishSetOperation(unionNodes(root_, copy, setOperationForks(size_ + other.size_), freed), freed);
+}
+
+void AvlTree::intersectWith(const AvlTree& other)
+{
+    if (&other == this) {
+        return;
     }
+    FreeChain freed;
+    finishSetOperation(intersectNodes(root_, other, other.root_, setOperationForks(size_ + other.size_), freed),
+                       freed);
+}
+
+void AvlTree::subtract(const AvlTree& other)
+{
+    if (&other == this) {
+        clear();
+        return;
+    }
+    FreeChain freed;
+    finishSetOperation(subtractNodes(root_, other, other.root_, setOperationForks(size_ + other.size_), freed),
+                       freed);
+}
+
+//  высота / баланс 
+
+int AvlTree::heightOf(Index node) const noexcept
+{
+    return node != kNil ? nodes_[node].height : 0;
+}
+
+int AvlTree::balanceFactor(Index node) const noexcept
+{
+    return node != kNil ? heightOf(nodes_[node].left) - heightOf(nodes_[node].right) : 0;
+}
+
+std::size_t AvlTree::countOf(Index node) const noexcept
+{
+    return node != kNil ? nodes_[node].count : 0U;
+}
+
+void AvlTree::updateNode(Index node) noexcept
+{
+    Node& current = nodes_[node];
+    current.height = static_cast<std::int8_t>(1 + std::max(heightOf(current.left), heightOf(current.right)));
+    current.count = static_cast<std::uint32_t>(1 + countOf(current.left) + countOf(current.right));
+}
+
+//  повороты 
+
+AvlTree::Index AvlTree::rotateRight(Index parentNode) noexcept
+{
+    const Index leftChild = nodes_[parentNode].left;
+    const Index transferSubtree = nodes_[leftChild].right;
+
+    nodes_[leftChild].right = parentNode;
+    nodes_[parentNode].left = transferSubtree;
+
+    updateNode(parentNode);
+    updateNode(leftChild);
+
+    return leftChild;
+}
 
-    // LR
-    if (balance > 1 && value > node->left->value) {
-        node->left = rotateLeft(node->left);
+AvlTree::Index AvlTree::rotateLeft(Index parentNode) noexcept
+{
+    const Index rightChild = nodes_[parentNode].right;
+    const Index transferSubtree = nodes_[rightChild].left;
+
+    nodes_[rightChild].left = parentNode;
+    nodes_[parentNode].right = transferSubtree;
+
+    updateNode(parentNode);
+    updateNode(rightChild);
+
+    return rightChild;
+}
+
+AvlTree::Index AvlTree::rebalance(Index node) noexcept
+{
+    updateNode(node);
+    const int balance = balanceFactor(node);
+
+    // LL / LR
+    if (balance > 1) {
+        if (balanceFactor(nodes_[node].left) < 0) {
+            nodes_[node].left = rotateLeft(nodes_[node].left);
+        }
         return rotateRight(node);
     }
 
-    // RL
-    if (balance < -1 && value < node->right->value) {
-        node->right = rotateRight(node->right);
+    // RR / RL
+    if (balance < -1) {
+        if (balanceFactor(nodes_[node].right) > 0) {
+            nodes_[node].right = rotateRight(nodes_[node].right);
+        }
         return rotateLeft(node);
     }
 
     return node;
 }
 
+void AvlTree::rebalancePath(Index* path[], int depth) noexcept
+{
+    // подъём к корню; выше поддерева, чья высота не изменилась,
+    // повороты не нужны — остаётся пересчитать размеры поддеревьев
+    bool settled = false;
+    while (depth > 0) {
+        Index* slot = path[--depth];
+        if (settled) {
+            Node& node = nodes_[*slot];
+            node.count = static_cast<std::uint32_t>(1 + countOf(node.left) + countOf(node.right));
+            continue;
+        }
+        const int heightBefore = heightOf(*slot);
+        *slot = rebalance(*slot);
+        settled = heightOf(*slot) == heightBefore;
+    }
+}
+
+//  вставка 
+
+bool AvlTree::insertNode(std::string_view value)
+{
+    // path хранит адреса ссылок на узлы пути: после поворота ссылка
+    // указывает уже на новый корень поддерева. Место под узел резервируется
+    // до спуска, чтобы пул не переехал и адреса остались верными
+    reserveNode();
+
+    Index* path[kMaxHeight];
+    int depth = 0;
+    Index* link = &root_;
+
+    while (*link != kNil) {
+        Node& node = nodes_[*link];
+        const int order = value.compare(node.value.view());
+        if (order == 0) {
+            return false;
+        }
+        path[depth++] = link;
+        link = order < 0 ? &node.left : &node.right;
+    }
+
+    *link = allocateNode(InternedString(value));
+    rebalancePath(path, depth);
+    return true;
+}
+
 void AvlTree::insert(const std::string& value)
 {
-    bool inserted = false;
-    root_ = insertNode(root_, value, inserted);
-    if (inserted) {
+    if (insertNode(value)) {
         ++size_;
+        if (bloom_.saturated()) {
+            rebuildBloomFilter();
+        } else {
+            bloom_.add(value);
+        }
     }
 }
 
 //  удаление 
 
-AvlTree::Node* AvlTree::removeNode(Node* node, const std::string& value, bool& removed)
+bool AvlTree::removeNode(std::string_view value)
 {
-    if (node == nullptr) {
-        return nullptr;
+    Index* path[kMaxHeight];
+    int depth = 0;
+    Index* link = &root_;
+
+    while (*link != kNil) {
+        Node& node = nodes_[*link];
+        const int order = value.compare(node.value.view());
+        if (order == 0) {
+            break;
+        }
+        path[depth++] = link;
+        link = order < 0 ? &node.left : &node.right;
     }
 
-    if (value < node->value) {
-        node->left = removeNode(node->left, value, removed);
-    } else if (value > node->value) {
-        node->right = removeNode(node->right, value, removed);
+    const Index target = *link;
+    if (target == kNil) {
+        return false;
+    }
+
+    Node& targetNode = nodes_[target];
+    if (targetNode.left != kNil && targetNode.right != kNil) {
+        // два ребёнка — значение inorder-преемника переносится сюда,
+        // удаляется узел преемника (у него нет левого ребёнка)
+        path[depth++] = link;
+        Index* successorLink = &targetNode.right;
+        while (nodes_[*successorLink].left != kNil) {
+            path[depth++] = successorLink;
+            successorLink = &nodes_[*successorLink].left;
+        }
+
+        const Index successor = *successorLink;
+        targetNode.value = std::move(nodes_[successor].value);
+        *successorLink = nodes_[successor].right;
+        freeNode(successor);
     } else {
-        // нашли узел
-        removed = true;
+        // 0 или 1 ребёнок — поднимаем его на место узла
+        *link = targetNode.left != kNil ? targetNode.left : targetNode.right;
+        freeNode(target);
+    }
 
-        // 0 или 1 ребёнок
-        if (node->left == nullptr || node->right == nullptr) {
-            Node* child = (node->left != nullptr) ? node->left : node->right;
+    rebalancePath(path, depth);
+    return true;
+}
 
-            if (child == nullptr) {
-                // вообще нет детей
-                delete node;
-                return nullptr;
-            }
 
-            // есть ровно один ребёнок — просто поднимаем его наверх
-            Node* toDelete = node;
-            node = child;
-            delete toDelete;
-        } else {
-            // два ребёнка — берём inorder-преемника (минимум в правом поддереве)
-            Node* succ = node->right;
-            while (succ->left != nullptr) {
-                succ = succ->left;
-            }
+void AvlTree::remove(const std::string& value)
+{
+    if (!bloom_.mayContain(value)) {
+        return;
+    }
+
+    // значение остаётся в битах фильтра до перестройки
+    if (removeNode(value) && size_ > 0U) {
+        --size_;
+    }
+}
+
+
+//  поиск 
 
-            node->value = succ->value;
-            // удаляем преемника из правого поддерева
-            node->right = removeNode(node->right, succ->value, removed);
+bool AvlTree::containsNode(std::string_view value) const noexcept
+{
+    Index node = root_;
+    while (node != kNil) {
+        const Node& current = nodes_[node];
+        const int order = value.compare(current.value.view());
+        if (order == 0) {
+            return true;
         }
+        node = order < 0 ? current.left : current.right;
     }
+    return false;
+}
+
+bool AvlTree::contains(const std::string& value) const
+{
+    return bloom_.mayContain(value) && containsNode(value);
+}
+
+//  порядковые запросы
 
-    // если после удаления поддерева здесь больше нет узла
-    if (node == nullptr) {
-        return nullptr;
+AvlTree::ConstIterator AvlTree::begin() const
+{
+    ConstIterator it;
+    it.nodes = nodes_.data();
+    it.pushLeftPath(root_);
+    return it;
+}
+
+AvlTree::ConstIterator AvlTree::end() const noexcept
+{
+    return ConstIterator{};
+}
+
+AvlTree::ConstIterator AvlTree::lowerBound(std::string_view value) const
+{
+    // в пути остаются узлы, от которых ушли влево: все они >= value
+    ConstIterator it;
+    it.nodes = nodes_.data();
+    for (Index node = root_; node != kNil;) {
+        const Node& current = nodes_[node];
+        if (value.compare(current.value.view()) <= 0) {
+            it.path[it.depth++] = node;
+            node = current.left;
+        } else {
+            node = current.right;
+        }
     }
+    return it;
+}
 
-    // обновляем высоту
-    node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
-    const int balance = balanceFactor(node);
+AvlTree::ConstIterator AvlTree::upperBound(std::string_view value) const
+{
+    ConstIterator it;
+    it.nodes = nodes_.data();
+    for (Index node = root_; node != kNil;) {
+        const Node& current = nodes_[node];
+        if (value.compare(current.value.view()) < 0) {
+            it.path[it.depth++] = node;
+            node = current.left;
+        } else {
+            node = current.right;
+        }
+    }
+    return it;
+}
 
-    // LL
-    if (balance > 1 && balanceFactor(node->left) >= 0) {
-        return rotateRight(node);
+std::pair<AvlTree::ConstIterator, AvlTree::ConstIterator>
+AvlTree::prefixRange(std::string_view prefix) const
+{
+    // конец диапазона — первое значение >= наименьшей строки, большей
+    // всех строк с этим префиксом (последний байт не 0xFF увеличивается)
+    std::string next(prefix);
+    while (!next.empty() && static_cast<unsigned char>(next.back()) == 0xFF) {
+        next.pop_back();
+    }
+    if (next.empty()) {
+        return {lowerBound(prefix), end()};
     }
+    next.back() = static_cast<char>(static_cast<unsigned char>(next.back()) + 1);
+    return {lowerBound(prefix), lowerBound(next)};
+}
 
-    // LR
-    if (balance > 1 && balanceFactor(node->left) < 0) {
-        node->left = rotateLeft(node->left);
-        return rotateRight(node);
+std::size_t AvlTree::rank(std::string_view value) const noexcept
+{
+    std::size_t less = 0;
+    for (Index node = root_; node != kNil;) {
+        const Node& current = nodes_[node];
+        if (value.compare(current.value.view()) <= 0) {
+            node = current.left;
+        } else {
+            less += countOf(current.left) + 1;
+            node = current.right;
+        }
     }
+    return less;
+}
 
-    // RR
-    if (balance < -1 && balanceFactor(node->right) <= 0) {
-        return rotateLeft(node);
+std::size_t AvlTree::countNotGreater(std::string_view value) const noexcept
+{
+    std::size_t notGreater = 0;
+    for (Index node = root_; node != kNil;) {
+        const Node& current = nodes_[node];
+        if (value.compare(current.value.view()) < 0) {
+            node = current.left;
+        } else {
+            notGreater += countOf(current.left) + 1;
+            node = current.right;
+        }
     }
+    return notGreater;
+}
 
-    // RL
-    if (balance < -1 && balanceFactor(node->right) > 0) {
-        node->right = rotateRight(node->right);
-        return rotateLeft(node);
+std::size_t AvlTree::rangeCount(std::string_view low, std::string_view high) const noexcept
+{
+    if (high < low) {
+        return 0;
+    }
+    return countNotGreater(high) - rank(low);
+}
+
+std::string_view AvlTree::nth(std::size_t index) const
+{
+    if (index >= size_) {
+        throw std::out_of_range("AvlTree::nth: index out of range");
     }
 
-    return node;
+    Index node = root_;
+    for (;;) {
+        const Node& current = nodes_[node];
+        const std::size_t leftCount = countOf(current.left);
+        if (index < leftCount) {
+            node = current.left;
+        } else if (index == leftCount) {
+            return current.value.view();
+        } else {
+            index -= leftCount + 1;
+            node = current.right;
+        }
+    }
 }
 
+//  ConstIterator
 
-void AvlTree::remove(const std::string& value)
+void AvlTree::ConstIterator::pushLeftPath(Index node) noexcept
 {
-    bool removed = false;
-    root_ = removeNode(root_, value, removed);
-    if (removed && size_ > 0U) {
-        --size_;
+    for (; node != kNil; node = nodes[node].left) {
+        path[depth++] = node;
     }
 }
 
+std::string_view AvlTree::ConstIterator::operator*() const noexcept
+{
+    return nodes[path[depth - 1]].value.view();
+}
 
-//  поиск 
+AvlTree::ConstIterator& AvlTree::ConstIterator::operator++() noexcept
+{
+    const Index current = path[--depth];
+    pushLeftPath(nodes[current].right);
+    return *this;
+}
 
-bool AvlTree::containsNode(Node* node, const std::string& value)
+AvlTree::ConstIterator AvlTree::ConstIterator::operator++(int) noexcept
 {
-    if (node == nullptr) {
-        return false;
-    }
-    if (value == node->value) {
-        return true;
-    }
-    if (value < node->value) {
-        return containsNode(node->left, value);
-    }
-    return containsNode(node->right, value);
+    ConstIterator previous = *this;
+    ++*this;
+    return previous;
 }
 
-bool AvlTree::contains(const std::string& value) const
+bool AvlTree::ConstIterator::operator==(const ConstIterator& other) const noexcept
+{
+    // итераторы одного дерева равны, когда указывают на один узел
+    const Index current = depth > 0 ? path[depth - 1] : kNil;
+    const Index otherCurrent = other.depth > 0 ? other.path[other.depth - 1] : kNil;
+    return current == otherCurrent;
+}
+
+bool AvlTree::ConstIterator::operator!=(const ConstIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+//  фильтр Блума
+
+void AvlTree::enableBloomFilter()
+{
+    rebuildBloomFilter();
+}
+
+void AvlTree::disableBloomFilter() noexcept
+{
+    bloom_.disable();
+}
+
+bool AvlTree::hasBloomFilter() const noexcept
 {
-    return containsNode(root_, value);
+    return bloom_.active();
+}
+
+void AvlTree::rebuildBloomFilter()
+{
+    // запас вдвое, как у хеш-таблиц
+    bloom_.reset(size_ * 2);
+    walkPreorder([this](const Node* node) {
+        if (node != nullptr) {
+            bloom_.add(node->value.view());
+        }
+    });
 }
 
 //  печать 
 
-void AvlTree::printRec(Node* node, int depth)
+void AvlTree::printRec(Index node, int depth) const
 {
-    if (node == nullptr) {
+    if (node == kNil) {
         return;
     }
 
-    printRec(node->right, depth + 1);
+    const Node& current = nodes_[node];
+    printRec(current.right, depth + 1);
     for (int i = 0; i < depth; ++i) {
         std::cout << "  ";
     }
-    std::cout << node->value << "\n";
-    printRec(node->left, depth + 1);
+    std::cout << current.value << "\n";
+    printRec(current.left, depth + 1);
 }
 
 void AvlTree::print() const
@@ -287,179 +1032,162 @@ bool AvlTree::empty() const noexcept
     return size_ == 0;
 }
 
-//  текстовая сериализация 
-
-void AvlTree::serializeRec(std::ostringstream& oss, Node* node)
+std::size_t AvlTree::memoryUsage() const noexcept
 {
-    if (node == nullptr) {
-        oss << "#\n";
-        return;
-    }
-
-    oss << node->value << "\n";
-    serializeRec(oss, node->left);
-    serializeRec(oss, node->right);
+    // пул — один блок, включая свободные слоты; текст значений
+    // принадлежит StringPool
+    const std::size_t pool = nodes_.capacity() > 0
+                           ? memory_usage::heapBlock(nodes_.capacity() * sizeof(Node))
+                           : 0;
+    return sizeof(AvlTree) + pool + bloom_.memoryUsage();
 }
 
+//  текстовая сериализация 
+
 std::string AvlTree::serialize() const
 {
     std::ostringstream oss;
-    serializeRec(oss, root_);
+    walkPreorder([&oss](const Node* node) {
+        if (node == nullptr) {
+            oss << "#\n";
+        } else {
+            oss << node->value << "\n";
+        }
+    });
     return oss.str();
 }
 
-AvlTree::Node* AvlTree::deserializeRec(std::istringstream& iss) //NOLINT
-{
-    std::string line;
-    if (!std::getline(iss, line)) {
-        return nullptr;
-    }
-
-    if (line == "#") {
-        return nullptr;
-    }
-
-    Node* node = new Node(line);
-    node->left = deserializeRec(iss);
-    node->right = deserializeRec(iss);
-    node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
-    return node;
-}
-
 void AvlTree::deserialize(const std::string& data)
 {
-    clearSubtree(root_);
-    root_ = nullptr;
-    size_ = 0;
-
     std::istringstream iss(data);
-    root_ = deserializeRec(iss);
-
-    // пересчёт size_
-    std::size_t count = 0;
-    std::vector<Node*> stack;
-    if (root_ != nullptr) {
-        stack.push_back(root_);
-    }
-    while (!stack.empty()) {
-        Node* node = stack.back();
-        stack.pop_back();
-        ++count;
-        if (node->left != nullptr) {
-            stack.push_back(node->left);
-        }
-        if (node->right != nullptr) {
-            stack.push_back(node->right);
-        }
+    // нехватка строк — пустые поддеревья, как и раньше
+    auto readValue = [&iss](std::string& value) {
+        return std::getline(iss, value) && value != "#";
+    };
+
+    AvlTree loaded = buildPreorder(readValue, "AvlTree::deserialize");
+    adoptNodes(loaded);
+
+    if (bloom_.active()) {
+        rebuildBloomFilter();
     }
-    size_ = count;
 }
 
 //  бинарная сериализация 
 
-void AvlTree::serializeBinaryRec(std::ostream& outputStream, Node* node)
+void AvlTree::serializeBinary(std::ostream& outputStream) const
 {
-    std::uint8_t flag = (node != nullptr) ? 1 : 0;
-    outputStream.write(reinterpret_cast<const char*>(&flag), sizeof(flag));
-    if (node == nullptr) {
-        return;
+    // значения по возрастанию без маркеров пустых поддеревьев
+    const std::uint8_t format = kSortedSnapshot;
+    const std::uint64_t count = size_;
+    outputStream.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (std::string_view value : *this) {
+        const std::uint64_t len = static_cast<std::uint64_t>(value.size());
+        outputStream.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        if (len > 0) {
+            outputStream.write(value.data(), static_cast<std::streamsize>(len));
+        }
     }
-
-    std::uint64_t len = static_cast<std::uint64_t>(node->value.size());
-    outputStream.write(reinterpret_cast<const char*>(&len), sizeof(len));
-    if (len > 0) {
-        outputStream.write(node->value.data(), static_cast<std::streamsize>(len));
+    if (bloom_.active()) {
+        bloom_.serializeBinary(outputStream);
     }
-
-    serializeBinaryRec(outputStream, node->left);
-    serializeBinaryRec(outputStream, node->right);
-}
-
-void AvlTree::serializeBinary(std::ostream& outputStream) const
-{
-    serializeBinaryRec(outputStream, root_);
     if (!outputStream) {
         throw std::runtime_error("AvlTree::serializeBinary: error");
     }
 }
 
-AvlTree::Node* AvlTree::deserializeBinaryRec(std::istream& inputStream)
+void AvlTree::deserializeBinary(std::istream& inputStream)
 {
-    std::uint8_t flag = 0;
-    inputStream.read(reinterpret_cast<char*>(&flag), sizeof(flag));
-    if (!inputStream) {
-        throw std::runtime_error("AvlTree::deserializeBinaryRec: error");
-    }
+    auto readString = [&inputStream](std::string& value) {
+        std::uint64_t len = 0;
+        inputStream.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!inputStream) {
+            throw std::runtime_error("AvlTree::deserializeBinary: error");
+        }
 
-    if (flag == 0) {
-        return nullptr;
-    }
+        value.resize(static_cast<std::size_t>(len));
+        if (len > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(len));
+            if (!inputStream) {
+                throw std::runtime_error("AvlTree::deserializeBinary: error");
+            }
+        }
+    };
 
-    std::uint64_t len = 0;
-    inputStream.read(reinterpret_cast<char*>(&len), sizeof(len));
-    if (!inputStream) {
-        throw std::runtime_error("AvlTree::deserializeBinaryRec: error");
-    }
+    AvlTree loaded;
 
-    std::string value;
-    value.resize(static_cast<std::size_t>(len));
-    if (len > 0) {
-        inputStream.read(value.data(), static_cast<std::streamsize>(len));
+    if (inputStream.peek() == kSortedSnapshot) {
+        inputStream.get();
+        std::uint64_t declared = 0;
+        inputStream.read(reinterpret_cast<char*>(&declared), sizeof(declared));
         if (!inputStream) {
-            throw std::runtime_error("AvlTree::deserializeBinaryRec: error");
+            throw std::runtime_error("AvlTree::deserializeBinary: error");
         }
-    }
-
-    Node* node = new Node(value);
-    node->left = deserializeBinaryRec(inputStream);
-    node->right = deserializeBinaryRec(inputStream);
-    node->height = 1 + std::max(heightOf(node->left), heightOf(node->right));
-    return node;
-}
 
-void AvlTree::deserializeBinary(std::istream& inputStream)
-{
-    clearSubtree(root_);
-    root_ = nullptr;
-    size_ = 0;
+        std::vector<InternedString> values;
+        values.reserve(memory_usage::trustedReserve(declared));
+        std::string value;
+        for (std::uint64_t i = 0; i < declared; ++i) {
+            readString(value);
+            if (!values.empty() && !(values.back().view() < std::string_view(value))) {
+                throw std::runtime_error("AvlTree::deserializeBinary: tree is not ordered");
+            }
+            values.emplace_back(value);
+        }
+        loaded.nodes_.reserve(values.size());
+        loaded.root_ = loaded.buildBalanced(values.data(), values.size());
+        loaded.size_ = values.size();
+    } else {
+        // старый префиксный формат: флаг 1 — узел, 0 — пустое поддерево
+        auto readValue = [&inputStream, &readString](std::string& value) {
+            std::uint8_t flag = 0;
+            inputStream.read(reinterpret_cast<char*>(&flag), sizeof(flag));
+            if (!inputStream) {
+                throw std::runtime_error("AvlTree::deserializeBinary: error");
+            }
+            if (flag == 0) {
+                return false;
+            }
+            readString(value);
+            return true;
+        };
+        loaded = buildPreorder(readValue, "AvlTree::deserializeBinary");
+    }
 
-    root_ = deserializeBinaryRec(inputStream);
+    const bool wantFilter = bloom_.active();
+    adoptNodes(loaded);
+    bloom_.disable();
 
-    // пересчёт size_
-    std::size_t count = 0;
-    std::vector<Node*> stack;
-    if (root_ != nullptr) {
-        stack.push_back(root_);
-    }
-    while (!stack.empty()) {
-        Node* node = stack.back();
-        stack.pop_back();
-        ++count;
-        if (node->left != nullptr) {
-            stack.push_back(node->left);
-        }
-        if (node->right != nullptr) {
-            stack.push_back(node->right);
-        }
+    // сохранённый фильтр берётся как есть, иначе перестраивается при необходимости
+    if (!bloom_.deserializeBinary(inputStream) && wantFilter) {
+        rebuildBloomFilter();
     }
-    size_ = count;
 }
 
 //  Rule of Five: копирование / перемещение 
 
+// индексы не зависят от адреса пула: копия — это копия массива узлов
 AvlTree::AvlTree(const AvlTree& other)
-    : root_(cloneSubtree(other.root_)),
-      size_(other.size_)
+    : nodes_(other.nodes_),
+      root_(other.root_),
+      freeHead_(other.freeHead_),
+      size_(other.size_),
+      bloom_(other.bloom_)
 {
-    
 }
 
 AvlTree::AvlTree(AvlTree&& other) noexcept
-    : root_(other.root_),
+    : nodes_(std::move(other.nodes_)),
+      root_(other.root_),
+      freeHead_(other.freeHead_),
       size_(other.size_)
 {
-    other.root_ = nullptr;
+    other.nodes_.clear();
+    other.root_ = kNil;
+    other.freeHead_ = kNil;
     other.size_ = 0;
+    bloom_.swap(other.bloom_);
 }
 
 AvlTree& AvlTree::operator=(const AvlTree& other)
@@ -479,13 +1207,8 @@ AvlTree& AvlTree::operator=(AvlTree&& other) noexcept
         return *this;
     }
 
-    clearSubtree(root_);
-    root_ = other.root_;
-    size_ = other.size_;
-
-    other.root_ = nullptr;
-    other.size_ = 0;
-
+    AvlTree tmp(std::move(other));
+    swap(tmp);
     return *this;
 }
 
@@ -494,6 +1217,9 @@ AvlTree& AvlTree::operator=(AvlTree&& other) noexcept
 void AvlTree::swap(AvlTree& other) noexcept
 {
     using std::swap;
+    swap(nodes_, other.nodes_);
     swap(root_, other.root_);
+    swap(freeHead_, other.freeHead_);
     swap(size_, other.size_);
+    bloom_.swap(other.bloom_);
 }
@@ -1,7 +1,16 @@
 #pragma once
 
+#include "bloom_filter.h"
+#include "string_pool.h"
+
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <iosfwd>
 
 class AvlTree
@@ -22,62 +31,198 @@ public:
     void remove(const std::string& value);
     [[nodiscard]] bool contains(const std::string& value) const;
 
+    // замена содержимого идеально сбалансированным деревом за O(n);
+    // values должны строго возрастать, иначе std::runtime_error и дерево
+    // остаётся прежним
+    void buildFromSorted(const std::vector<std::string>& values);
+
+    // Операции над множествами на split/join: O(m log(n/m + 1)) сравнений
+    // для m <= n, половины большого дерева обрабатываются параллельно.
+    // Узлы этого дерева переиспользуются; other только читается
+    // (объединение копирует его узлы).
+    void unionWith(const AvlTree& other);
+    void intersectWith(const AvlTree& other);
+    void subtract(const AvlTree& other);          // убрать значения other
+
+    // Порядковые запросы: узлы хранят размеры поддеревьев, поэтому rank,
+    // nth и rangeCount — O(log n), обход диапазона — O(log n + k).
+    // Любое изменение дерева делает итераторы и строки из nth недействительными.
+    class ConstIterator;
+
+    [[nodiscard]] ConstIterator begin() const;
+    [[nodiscard]] ConstIterator end() const noexcept;
+    [[nodiscard]] ConstIterator lowerBound(std::string_view value) const;   // первое >= value
+    [[nodiscard]] ConstIterator upperBound(std::string_view value) const;   // первое > value
+    // значения, начинающиеся с prefix: [first, second)
+    [[nodiscard]] std::pair<ConstIterator, ConstIterator> prefixRange(std::string_view prefix) const;
+
+    [[nodiscard]] std::size_t rank(std::string_view value) const noexcept;  // сколько значений < value
+    [[nodiscard]] std::size_t rangeCount(std::string_view low, std::string_view high) const noexcept; // в [low, high]
+    [[nodiscard]] std::string_view nth(std::size_t index) const;            // с нуля; std::out_of_range
+
     // Вспомогательные методы
     void print() const;
 
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
+    // освобождает пул целиком, без обхода дерева, но не за O(1): каждый
+    // слот держит ссылку на строку StringPool — n атомарных уменьшений
+    // счётчика, а последняя ссылка берёт мьютекс пула и удаляет запись
+    void clear() noexcept;
+    // байты: объект + пул узлов (текст значений учитывается в StringPool)
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;
+
+    // фильтр Блума перед спуском по дереву: промах не сравнивает строки
+    void enableBloomFilter();
+    void disableBloomFilter() noexcept;
+    [[nodiscard]] bool hasBloomFilter() const noexcept;
 
     //  текстовая сериализация (префиксный обход, '#' для nullptr) 
     [[nodiscard]] std::string serialize() const;
     void deserialize(const std::string& data);
 
-    //  бинарная сериализация 
+    //  бинарная сериализация: [u8 2][u64 count] и count раз [u64 len][bytes]
+    //  по возрастанию, включённый фильтр — хвостом. Загрузка собирает дерево
+    //  за O(n) и читает и старый префиксный формат с флагами 0/1
     void serializeBinary(std::ostream& outputStream) const;
     void deserializeBinary(std::istream& inputStream);
 
     void swap(AvlTree& other) noexcept;
 
 private:
-    struct Node //NOLINT
+    using Index = std::uint32_t;
+    static constexpr Index kNil = std::numeric_limits<Index>::max();   // пустое поддерево
+    static constexpr std::size_t kMaxNodes = kNil;
+
+    // значения интернируются в StringPool::global(): одинаковые ключи
+    // разных деревьев хранятся один раз, копирование узла не копирует текст.
+    // Узлы лежат в пуле дерева и ссылаются друг на друга индексами: 24 байта
+    // на узел вместо отдельного блока кучи на 48.
+    struct Node
+    {
+        InternedString value;
+        Index left{kNil};       // у свободного слота — следующий свободный
+        Index right{kNil};
+        std::uint32_t count{1}; // узлов в поддереве
+        std::int8_t height{1};
+
+        Node() noexcept = default;
+        explicit Node(InternedString v) noexcept
+            : value(std::move(v))
+        {
+        }
+    };
+
+    // освобождённые слоты, собранные одной ветвью параллельной операции
+    struct FreeChain
     {
-        std::string value; //NOLINT
-        Node* left; //NOLINT 
-        Node* right; //NOLINT 
-        int height; //NOLINT
-
-        explicit Node(const std::string& v) //NOLINT
-            : value(v),
-              left(nullptr),
-              right(nullptr),
-              height(1)
-            {}; 
-              
-        
+        Index head{kNil};
+        Index tail{kNil};
     };
 
-    Node* root_; //NOLINT
-    std::size_t size_; //NOLINT
+    std::vector<Node> nodes_;   // пул; не уменьшается до clear()
+    Index root_;
+    Index freeHead_;
+    std::size_t size_;
+    BloomFilter bloom_;
+
+    void rebuildBloomFilter();
+
+    // высота AVL-дерева из n узлов < 1.45 * log2(n + 2): для любого
+    // адресуемого числа узлов путь от корня короче kMaxHeight, поэтому
+    // обходы используют массивы фиксированного размера вместо рекурсии
+    static constexpr int kMaxHeight = 96;
+
+    // пул узлов
+    void reserveNode();                           // место под узел без переезда пула
+    Index allocateNode(InternedString value);
+    void freeNode(Index node) noexcept;
+    void releaseNode(Index node, FreeChain& chain) noexcept;
+    void mergeChains(FreeChain& into, const FreeChain& from) noexcept;
+    void spliceFree(const FreeChain& chain) noexcept;
+    void clearSubtree(Index node, FreeChain& chain) noexcept;
+    Index cloneSubtree(const AvlTree& source, Index node);   // в пул этого дерева
+    void adoptNodes(AvlTree& loaded) noexcept;               // узлы loaded вместо своих
 
     // Вспомогательные функции
-    static int heightOf(Node* node) noexcept;
-    static int balanceFactor(Node* node) noexcept;
+    [[nodiscard]] int heightOf(Index node) const noexcept;
+    [[nodiscard]] int balanceFactor(Index node) const noexcept;
+    [[nodiscard]] std::size_t countOf(Index node) const noexcept;
+    void updateNode(Index node) noexcept;   // высота и размер по детям
+
+    Index rotateRight(Index parentNode) noexcept;
+    Index rotateLeft(Index parentNode) noexcept;
+    Index rebalance(Index node) noexcept;
+    // path — адреса ссылок от корня вниз; балансировка снизу вверх
+    void rebalancePath(Index* path[], int depth) noexcept;
+
+    bool insertNode(std::string_view value);
+    bool removeNode(std::string_view value);
+    [[nodiscard]] bool containsNode(std::string_view value) const noexcept;
+    [[nodiscard]] std::size_t countNotGreater(std::string_view value) const noexcept;
+
+    void printRec(Index node, int depth) const;
+
+    // префиксный обход, visit(nullptr) для пустых поддеревьев
+    template <class Visit>
+    void walkPreorder(Visit&& visit) const;
+    // сборка из префиксной записи с проверкой баланса и порядка;
+    // readValue(value) == false — пустое поддерево
+    template <class ReadValue>
+    static AvlTree buildPreorder(ReadValue&& readValue, const char* where);
+    [[nodiscard]] bool isOrdered() const noexcept;
+    // values строго возрастают; значения перемещаются в узлы
+    Index buildBalanced(InternedString* values, std::size_t count);
+
+    // join: все значения left < middle < все значения right; middle отсоединён
+    Index joinNodes(Index left, Index middle, Index right) noexcept;
+    Index joinRight(Index left, Index middle, Index right) noexcept;
+    Index joinLeft(Index left, Index middle, Index right) noexcept;
+    Index joinPair(Index left, Index right) noexcept;
+    Index splitLast(Index node, Index& last) noexcept;
+    // делит дерево по value; возвращает отсоединённый узел value или kNil
+    Index splitNodes(Index node, std::string_view value, Index& left, Index& right) noexcept;
+
+    // операции над поддеревьями: a (и b у объединения) разбирается на узлы
+    // результата, лишние узлы уходят в freed; forks — сколько ещё уровней
+    // рекурсии можно отдать второму потоку
+    Index unionNodes(Index a, Index b, int forks, FreeChain& freed) noexcept;
+    Index intersectNodes(Index a, const AvlTree& other, Index b, int forks, FreeChain& freed) noexcept;
+    Index subtractNodes(Index a, const AvlTree& other, Index b, int forks, FreeChain& freed) noexcept;
+    void finishSetOperation(Index root, const FreeChain& freed);
+};
 
-    static Node* rotateRight(Node* parentNode);
-    static Node* rotateLeft(Node* parentNode);
 
-    static Node* insertNode(Node* node, const std::string& value, bool& inserted);
-    static Node* removeNode(Node* node, const std::string& value, bool& removed);
-    static bool containsNode(Node* node, const std::string& value);
+//  AvlTree::ConstIterator — симметричный обход
+//
+//  Хранит путь от корня (индексы в пуле): узлы, которые ещё предстоит
+//  выдать, на вершине — текущий. Высота дерева ограничена, поэтому путь —
+//  массив фиксированного размера; ++ выполняется за амортизированное O(1).
 
-    static void printRec(Node* node, int depth);
+class AvlTree::ConstIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = std::string_view;
+
+    ConstIterator() noexcept = default;
 
-    static void serializeRec(std::ostringstream& oss, Node* node);
-    static Node* deserializeRec(std::istringstream& iss);
+    [[nodiscard]] std::string_view operator*() const noexcept;
+    ConstIterator& operator++() noexcept;
+    ConstIterator operator++(int) noexcept;
+
+    [[nodiscard]] bool operator==(const ConstIterator& other) const noexcept;
+    [[nodiscard]] bool operator!=(const ConstIterator& other) const noexcept;
+
+private:
+    friend class AvlTree;
 
-    static void serializeBinaryRec(std::ostream& outputStream, Node* node);
-    static Node* deserializeBinaryRec(std::istream& inputStream);
+    void pushLeftPath(Index node) noexcept;
 
-    static void clearSubtree(Node* node) noexcept;
-    static Node* cloneSubtree(Node* node);
+    const Node* nodes{nullptr};   // пул дерева
+    Index path[kMaxHeight]{};
+    int depth{0};
 };
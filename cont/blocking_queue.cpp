@@ -0,0 +1,75 @@
+#include "blocking_queue.h"
+
+#include <utility>
+
+BlockingQueue::BlockingQueue(std::size_t capacityLimit)
+{
+    queue.setCapacityLimit(capacityLimit);
+}
+
+bool BlockingQueue::push(std::string value)
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [this] { return isClosed || !queue.full(); });
+        if (isClosed) {
+            return false;
+        }
+        queue.push(std::move(value));
+    }
+    notEmpty.notify_one();
+    return true;
+}
+
+bool BlockingQueue::popWait(std::string& out, std::chrono::milliseconds timeout)
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (!notEmpty.wait_for(guard, timeout, [this] { return isClosed || !queue.empty(); })
+            || queue.empty()) {
+            return false;
+        }
+        out = queue.pop();
+    }
+    notFull.notify_one();
+    return true;
+}
+
+std::size_t BlockingQueue::popBatch(std::size_t maxCount, std::vector<std::string>& out,
+                                    std::chrono::milliseconds timeout)
+{
+    std::size_t taken = 0;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (!notEmpty.wait_for(guard, timeout, [this] { return isClosed || !queue.empty(); })) {
+            return 0;
+        }
+        taken = queue.popBatch(maxCount, out);
+    }
+    if (taken > 0) {
+        notFull.notify_all();
+    }
+    return taken;
+}
+
+void BlockingQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        isClosed = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+}
+
+bool BlockingQueue::closed() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return isClosed;
+}
+
+std::size_t BlockingQueue::size() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return queue.size();
+}
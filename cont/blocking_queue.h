@@ -0,0 +1,68 @@
+#pragma once
+
+#include "queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//  BlockingQueue — Queue под мьютексом для конвейеров из потоков
+//
+//  Потребители ждут элементы с таймаутом вместо опроса pop. Пакетные
+//  операции берут мьютекс и будят соседей один раз на пакет. При пределе
+//  размера производители ждут свободного места. close() будит всех
+//  ожидающих: после него push не принимает новое, а pop дочитывает остаток.
+
+class BlockingQueue
+{
+public:
+    explicit BlockingQueue(std::size_t capacityLimit = 0);   // 0 — без предела
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    // ждёт места при пределе; false, если очередь закрыта
+    bool push(std::string value);
+    template <class InputIt>
+    std::size_t pushBatch(InputIt first, InputIt last);   // сколько принято до закрытия
+
+    // false — истёк таймаут или очередь закрыта и пуста
+    [[nodiscard]] bool popWait(std::string& out, std::chrono::milliseconds timeout);
+    // ждёт хотя бы один элемент и забирает до maxCount; 0 — как false у popWait
+    std::size_t popBatch(std::size_t maxCount, std::vector<std::string>& out,
+                         std::chrono::milliseconds timeout);
+
+    void close();
+    [[nodiscard]] bool closed() const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    mutable std::mutex      lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    Queue                   queue;
+    bool                    isClosed{false};
+};
+
+template <class InputIt>
+std::size_t BlockingQueue::pushBatch(InputIt first, InputIt last)
+{
+    std::size_t pushed = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (first != last) {
+        notFull.wait(guard, [this] { return isClosed || !queue.full(); });
+        if (isClosed) {
+            break;
+        }
+        // всё, что влезает, — под одним захватом мьютекса
+        for (; first != last && !queue.full(); ++first) {
+            queue.push(*first);
+            ++pushed;
+        }
+        notEmpty.notify_all();
+    }
+    return pushed;
+}
@@ -0,0 +1,196 @@
+#include "bloom_filter.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+constexpr std::uint32_t kMagic = 0x464D4C42;   // "BLMF"
+constexpr std::uint64_t kMaxBlocks = std::uint64_t{1} << 28;
+
+// FNV-1a с финальным перемешиванием; не зависит от хешей самих таблиц
+std::uint64_t hashKey(std::string_view key) noexcept
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char characterValue : key) {
+        hash ^= characterValue;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+} // namespace
+
+BloomFilter::BloomFilter(std::size_t expectedItems)
+{
+    reset(expectedItems);
+}
+
+void BloomFilter::reset(std::size_t expectedItems)
+{
+    designItems = std::max<std::size_t>(expectedItems, 64);
+    const std::size_t blocks = (designItems * kBitsPerItem + 511) / 512;
+    words.assign(blocks * kWordsPerBlock, 0);
+    addedItems = 0;
+}
+
+void BloomFilter::disable() noexcept
+{
+    std::vector<std::uint64_t>().swap(words);
+    designItems = 0;
+    addedItems = 0;
+}
+
+void BloomFilter::clearBits() noexcept
+{
+    std::fill(words.begin(), words.end(), 0);
+    addedItems = 0;
+}
+
+void BloomFilter::add(std::string_view key) noexcept
+{
+    if (words.empty()) {
+        return;
+    }
+
+    const std::uint64_t hash = hashKey(key);
+    std::uint64_t* block = words.data() + ((hash >> 32) % blockCount()) * kWordsPerBlock;
+    std::uint32_t bit = static_cast<std::uint32_t>(hash);
+    const std::uint32_t step = static_cast<std::uint32_t>(hash >> 41) | 1U;
+    for (unsigned probe = 0; probe < kProbes; ++probe) {
+        block[(bit >> 6) & 7U] |= std::uint64_t{1} << (bit & 63U);
+        bit += step;
+    }
+    ++addedItems;
+}
+
+bool BloomFilter::mayContain(std::string_view key) const noexcept
+{
+    if (words.empty()) {
+        return true;
+    }
+
+    const std::uint64_t hash = hashKey(key);
+    const std::uint64_t* block = words.data() + ((hash >> 32) % blockCount()) * kWordsPerBlock;
+    std::uint32_t bit = static_cast<std::uint32_t>(hash);
+    const std::uint32_t step = static_cast<std::uint32_t>(hash >> 41) | 1U;
+    for (unsigned probe = 0; probe < kProbes; ++probe) {
+        if ((block[(bit >> 6) & 7U] & (std::uint64_t{1} << (bit & 63U))) == 0) {
+            return false;
+        }
+        bit += step;
+    }
+    return true;
+}
+
+bool BloomFilter::active() const noexcept
+{
+    return !words.empty();
+}
+
+bool BloomFilter::saturated() const noexcept
+{
+    return !words.empty() && addedItems >= designItems;
+}
+
+std::size_t BloomFilter::itemCount() const noexcept
+{
+    return addedItems;
+}
+
+std::size_t BloomFilter::designCapacity() const noexcept
+{
+    return designItems;
+}
+
+std::size_t BloomFilter::blockCount() const noexcept
+{
+    return words.size() / kWordsPerBlock;
+}
+
+std::size_t BloomFilter::memoryUsage() const noexcept
+{
+    if (words.capacity() == 0) {
+        return 0;
+    }
+    return memory_usage::heapBlock(words.capacity() * sizeof(std::uint64_t));
+}
+
+//  бинарная сериализация
+
+void BloomFilter::serializeBinary(std::ostream& outputStream) const
+{
+    const std::uint32_t magic = kMagic;
+    const std::uint64_t design = designItems;
+    const std::uint64_t added = addedItems;
+    const std::uint64_t blocks = blockCount();
+
+    outputStream.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    outputStream.write(reinterpret_cast<const char*>(&design), sizeof(design));
+    outputStream.write(reinterpret_cast<const char*>(&added), sizeof(added));
+    outputStream.write(reinterpret_cast<const char*>(&blocks), sizeof(blocks));
+    outputStream.write(reinterpret_cast<const char*>(words.data()),
+                       static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t)));
+
+    if (!outputStream) {
+        throw std::runtime_error("BloomFilter::serializeBinary: error");
+    }
+}
+
+bool BloomFilter::deserializeBinary(std::istream& inputStream)
+{
+    disable();
+
+    if (inputStream.peek() == std::char_traits<char>::eof()) {
+        // конец данных владельца: фильтра нет, eofbit от peek не нужен
+        inputStream.clear(inputStream.rdstate() & ~std::ios::eofbit);
+        return false;
+    }
+
+    const std::istream::pos_type start = inputStream.tellg();
+    std::uint32_t magic = 0;
+    inputStream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!inputStream || magic != kMagic) {
+        // дальше в потоке другие данные — возвращаемся
+        inputStream.clear();
+        inputStream.seekg(start);
+        return false;
+    }
+
+    std::uint64_t design = 0;
+    std::uint64_t added = 0;
+    std::uint64_t blocks = 0;
+    inputStream.read(reinterpret_cast<char*>(&design), sizeof(design));
+    inputStream.read(reinterpret_cast<char*>(&added), sizeof(added));
+    inputStream.read(reinterpret_cast<char*>(&blocks), sizeof(blocks));
+    if (!inputStream || blocks == 0 || blocks > kMaxBlocks) {
+        throw std::runtime_error("BloomFilter::deserializeBinary: error");
+    }
+
+    std::vector<std::uint64_t> loaded(static_cast<std::size_t>(blocks) * kWordsPerBlock);
+    inputStream.read(reinterpret_cast<char*>(loaded.data()),
+                     static_cast<std::streamsize>(loaded.size() * sizeof(std::uint64_t)));
+    if (!inputStream) {
+        throw std::runtime_error("BloomFilter::deserializeBinary: error");
+    }
+
+    words.swap(loaded);
+    designItems = static_cast<std::size_t>(design);
+    addedItems = static_cast<std::size_t>(added);
+    return true;
+}
+
+void BloomFilter::swap(BloomFilter& other) noexcept
+{
+    words.swap(other.words);
+    std::swap(designItems, other.designItems);
+    std::swap(addedItems, other.addedItems);
+}
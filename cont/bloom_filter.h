@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+//  BloomFilter — блочный фильтр Блума
+//
+//  Все биты одного ключа лежат в одном блоке из 512 бит (8 слов по 64),
+//  поэтому проверка читает одну кеш-линию. Ложноотрицательных ответов нет:
+//  mayContain() == false означает, что ключа точно нет. Удалять ключи нельзя —
+//  владелец перестраивает фильтр, когда тот насыщается.
+//  Неактивный (по умолчанию) фильтр не занимает памяти и всегда отвечает true.
+
+class BloomFilter
+{
+public:
+    BloomFilter() noexcept = default;
+    explicit BloomFilter(std::size_t expectedItems);
+
+    // активировать под expectedItems ключей, все биты сбрасываются
+    void reset(std::size_t expectedItems);
+    // выключить и освободить память
+    void disable() noexcept;
+    // сбросить биты, сохранив размер
+    void clearBits() noexcept;
+
+    void add(std::string_view key) noexcept;
+    [[nodiscard]] bool mayContain(std::string_view key) const noexcept;
+
+    [[nodiscard]] bool active() const noexcept;
+    // добавлено не меньше ключей, чем рассчитан фильтр — пора перестроить
+    [[nodiscard]] bool saturated() const noexcept;
+    [[nodiscard]] std::size_t itemCount() const noexcept;
+    [[nodiscard]] std::size_t designCapacity() const noexcept;
+    [[nodiscard]] std::size_t blockCount() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты кучи
+
+    //  бинарная сериализация (хвост снапшота владельца)
+    //  [u32 magic][u64 designCapacity][u64 itemCount][u64 blocks][blocks * 64 байт]
+    void serializeBinary(std::ostream& outputStream) const;
+    // читает хвост, если он есть; без хвоста поток не сдвигается и фильтр выключается
+    bool deserializeBinary(std::istream& inputStream);
+
+    void swap(BloomFilter& other) noexcept;
+
+private:
+    static constexpr std::size_t kWordsPerBlock = 8;
+    static constexpr std::size_t kBitsPerItem   = 10;
+    static constexpr unsigned    kProbes        = 7;
+
+    std::vector<std::uint64_t> words;
+    std::size_t designItems{0};
+    std::size_t addedItems{0};
+};
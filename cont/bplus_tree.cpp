@@ -0,0 +1,1089 @@
+#include "bplus_tree.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//  конструктор / деструктор
+
+BPlusTree::~BPlusTree()
+{
+    freeNode(root_);
+}
+
+//  узлы
+
+void BPlusTree::deleteNode(NodeBase* node) noexcept
+{
+    if (node->leaf) {
+        delete static_cast<Leaf*>(node);
+    } else {
+        delete static_cast<Inner*>(node);
+    }
+}
+
+void BPlusTree::freeNode(NodeBase* node) noexcept
+{
+    // глубина не больше kMaxDepth — рекурсия безопасна
+    if (node == nullptr) {
+        return;
+    }
+    if (!node->leaf) {
+        Inner* inner = static_cast<Inner*>(node);
+        for (int i = 0; i < inner->count; ++i) {
+            freeNode(inner->children[i]);
+        }
+    }
+    deleteNode(node);
+}
+
+BPlusTree::NodeBase* BPlusTree::cloneNode(const NodeBase* node, Leaf*& lastLeaf)
+{
+    if (node->leaf) {
+        const Leaf* source = static_cast<const Leaf*>(node);
+        Leaf* copy = new Leaf();
+        try {
+            for (int i = 0; i < source->count; ++i) {
+                copy->prefixes[i] = source->prefixes[i];
+                copy->keys[i] = source->keys[i];
+            }
+        } catch (...) {
+            delete copy;
+            throw;
+        }
+        copy->count = source->count;
+        copy->prev = lastLeaf;
+        if (lastLeaf != nullptr) {
+            lastLeaf->next = copy;
+        }
+        lastLeaf = copy;
+        return copy;
+    }
+
+    const Inner* source = static_cast<const Inner*>(node);
+    Inner* copy = new Inner();
+    try {
+        for (int i = 0; i + 1 < source->count; ++i) {
+            copy->prefixes[i] = source->prefixes[i];
+            copy->keys[i] = source->keys[i];
+        }
+        // count растёт вместе с готовыми детьми: при исключении
+        // freeNode освободит ровно их
+        for (int i = 0; i < source->count; ++i) {
+            copy->children[i] = cloneNode(source->children[i], lastLeaf);
+            copy->sizes[i] = source->sizes[i];
+            ++copy->count;
+        }
+    } catch (...) {
+        freeNode(copy);
+        throw;
+    }
+    return copy;
+}
+
+std::size_t BPlusTree::nodeMemory(const NodeBase* node) noexcept
+{
+    std::size_t total = 0;
+    if (node->leaf) {
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        total += memory_usage::heapBlock(sizeof(Leaf));
+        for (const std::string& key : leaf->keys) {
+            total += memory_usage::stringHeap(key);
+        }
+        return total;
+    }
+
+    const Inner* inner = static_cast<const Inner*>(node);
+    total += memory_usage::heapBlock(sizeof(Inner));
+    for (const std::string& key : inner->keys) {
+        total += memory_usage::stringHeap(key);
+    }
+    for (int i = 0; i < inner->count; ++i) {
+        total += nodeMemory(inner->children[i]);
+    }
+    return total;
+}
+
+//  сравнение ключей и поиск в узле
+
+std::uint64_t BPlusTree::prefixOf(std::string_view key) noexcept
+{
+    // первые 8 байт big-endian, недостающие — нули: числа упорядочены
+    // так же, как строки
+    std::uint64_t prefix = 0;
+    const std::size_t length = std::min<std::size_t>(key.size(), 8);
+    for (std::size_t i = 0; i < length; ++i) {
+        prefix |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+int BPlusTree::compareKey(std::uint64_t prefix, std::string_view key,
+                          std::uint64_t slotPrefix, const std::string& slotKey) noexcept
+{
+    if (prefix != slotPrefix) {
+        return prefix < slotPrefix ? -1 : 1;
+    }
+    if (key.size() <= 8 && slotKey.size() <= 8) {
+        // префиксы равны: короткие строки отличаются только длиной
+        return (key.size() > slotKey.size()) - (key.size() < slotKey.size());
+    }
+    return key.compare(slotKey);
+}
+
+int BPlusTree::childIndex(const Inner* inner, std::uint64_t prefix, std::string_view key) noexcept
+{
+    // число разделителей <= key
+    int low = 0;
+    int high = inner->count - 1;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (compareKey(prefix, key, inner->prefixes[middle], inner->keys[middle]) < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+int BPlusTree::lowerSlot(const Leaf* leaf, std::uint64_t prefix, std::string_view key) noexcept
+{
+    int low = 0;
+    int high = leaf->count;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (compareKey(prefix, key, leaf->prefixes[middle], leaf->keys[middle]) <= 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+int BPlusTree::upperSlot(const Leaf* leaf, std::uint64_t prefix, std::string_view key) noexcept
+{
+    int low = 0;
+    int high = leaf->count;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (compareKey(prefix, key, leaf->prefixes[middle], leaf->keys[middle]) < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+std::size_t BPlusTree::totalOf(const NodeBase* node) noexcept
+{
+    if (node->leaf) {
+        return static_cast<std::size_t>(node->count);
+    }
+    const Inner* inner = static_cast<const Inner*>(node);
+    std::size_t total = 0;
+    for (int i = 0; i < inner->count; ++i) {
+        total += inner->sizes[i];
+    }
+    return total;
+}
+
+BPlusTree::Leaf* BPlusTree::descend(std::uint64_t prefix, std::string_view key,
+                                    PathStep* path, int& depth) const noexcept
+{
+    depth = 0;
+    NodeBase* node = root_;
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (!node->leaf) {
+        Inner* inner = static_cast<Inner*>(node);
+        const int index = childIndex(inner, prefix, key);
+        if (path != nullptr) {
+            path[depth] = {inner, index};
+        }
+        ++depth;
+        node = inner->children[index];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+//  вставка
+
+void BPlusTree::insert(const std::string& value)
+{
+    const std::uint64_t prefix = prefixOf(value);
+    if (root_ == nullptr) {
+        Leaf* leaf = new Leaf();
+        try {
+            leaf->keys[0] = value;
+        } catch (...) {
+            delete leaf;
+            throw;
+        }
+        leaf->prefixes[0] = prefix;
+        leaf->count = 1;
+        root_ = first_ = leaf;
+        size_ = 1;
+        return;
+    }
+
+    PathStep path[kMaxDepth];
+    int depth = 0;
+    Leaf* leaf = descend(prefix, value, path, depth);
+    const int position = lowerSlot(leaf, prefix, value);
+    if (position < leaf->count
+        && compareKey(prefix, value, leaf->prefixes[position], leaf->keys[position]) == 0) {
+        return;
+    }
+
+    // копия делается до сдвига: дальше ничего не выделяет память
+    std::string key(value);
+    for (int i = leaf->count; i > position; --i) {
+        leaf->prefixes[i] = leaf->prefixes[i - 1];
+        leaf->keys[i].swap(leaf->keys[i - 1]);
+    }
+    leaf->prefixes[position] = prefix;
+    leaf->keys[position].swap(key);
+    ++leaf->count;
+    ++size_;
+    for (int level = 0; level < depth; ++level) {
+        ++path[level].node->sizes[path[level].index];
+    }
+
+    if (leaf->count <= kLeafSlots) {
+        return;
+    }
+    try {
+        splitUpward(path, depth, leaf);
+    } catch (...) {
+        // память под разделение не выделилась — вставка откатывается
+        for (int i = position; i + 1 < leaf->count; ++i) {
+            leaf->prefixes[i] = leaf->prefixes[i + 1];
+            leaf->keys[i].swap(leaf->keys[i + 1]);
+        }
+        --leaf->count;
+        std::string().swap(leaf->keys[leaf->count]);
+        --size_;
+        for (int level = 0; level < depth; ++level) {
+            --path[level].node->sizes[path[level].index];
+        }
+        throw;
+    }
+}
+
+void BPlusTree::splitUpward(PathStep* path, int depth, Leaf* leaf)
+{
+    // делятся лист и подряд идущие заполненные предки; если заполнены
+    // все — появляется новый корень
+    int splits = 1;
+    while (splits <= depth && path[depth - splits].node->count == kInnerSlots) {
+        ++splits;
+    }
+    const int innerNeeded = (splits - 1) + (splits > depth ? 1 : 0);
+
+    std::string upKey = leaf->keys[leaf->count / 2];
+    Leaf* rightLeaf = new Leaf();
+    Inner* spare[kMaxDepth + 1] = {};
+    try {
+        for (int i = 0; i < innerNeeded; ++i) {
+            spare[i] = new Inner();
+        }
+    } catch (...) {
+        for (int i = 0; i < innerNeeded; ++i) {
+            delete spare[i];
+        }
+        delete rightLeaf;
+        throw;
+    }
+
+    splitLeaf(leaf, rightLeaf);
+    NodeBase* left = leaf;
+    NodeBase* right = rightLeaf;
+    int used = 0;
+
+    for (int level = depth - 1; level >= 0; --level) {
+        Inner* parent = path[level].node;
+        const int index = path[level].index;
+
+        for (int i = parent->count; i > index + 1; --i) {
+            parent->children[i] = parent->children[i - 1];
+            parent->sizes[i] = parent->sizes[i - 1];
+        }
+        for (int i = parent->count - 1; i > index; --i) {
+            parent->keys[i].swap(parent->keys[i - 1]);
+            parent->prefixes[i] = parent->prefixes[i - 1];
+        }
+        parent->children[index + 1] = right;
+        parent->sizes[index + 1] = totalOf(right);
+        parent->sizes[index] = totalOf(left);
+        parent->keys[index].swap(upKey);
+        parent->prefixes[index] = prefixOf(parent->keys[index]);
+        ++parent->count;
+
+        if (parent->count <= kInnerSlots) {
+            return;
+        }
+        Inner* rightInner = spare[used++];
+        splitInner(parent, rightInner, upKey);
+        left = parent;
+        right = rightInner;
+    }
+
+    Inner* root = spare[used];
+    root->children[0] = left;
+    root->children[1] = right;
+    root->sizes[0] = totalOf(left);
+    root->sizes[1] = totalOf(right);
+    root->keys[0].swap(upKey);
+    root->prefixes[0] = prefixOf(root->keys[0]);
+    root->count = 2;
+    root_ = root;
+}
+
+void BPlusTree::splitLeaf(Leaf* leaf, Leaf* right) noexcept
+{
+    const int keep = leaf->count / 2;
+    const int moved = leaf->count - keep;
+    for (int i = 0; i < moved; ++i) {
+        right->prefixes[i] = leaf->prefixes[keep + i];
+        right->keys[i].swap(leaf->keys[keep + i]);
+    }
+    right->count = moved;
+    leaf->count = keep;
+
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != nullptr) {
+        leaf->next->prev = right;
+    }
+    leaf->next = right;
+}
+
+void BPlusTree::splitInner(Inner* inner, Inner* right, std::string& upKey) noexcept
+{
+    // слева остаются keep детей, разделитель между половинами уходит вверх
+    const int keep = inner->count / 2;
+    const int moved = inner->count - keep;
+    upKey.swap(inner->keys[keep - 1]);
+    for (int i = 0; i < moved; ++i) {
+        right->children[i] = inner->children[keep + i];
+        right->sizes[i] = inner->sizes[keep + i];
+    }
+    for (int i = 0; i + 1 < moved; ++i) {
+        right->keys[i].swap(inner->keys[keep + i]);
+        right->prefixes[i] = inner->prefixes[keep + i];
+    }
+    right->count = moved;
+    inner->count = keep;
+}
+
+//  удаление
+
+void BPlusTree::remove(const std::string& value)
+{
+    if (root_ == nullptr) {
+        return;
+    }
+
+    const std::uint64_t prefix = prefixOf(value);
+    PathStep path[kMaxDepth];
+    int depth = 0;
+    Leaf* leaf = descend(prefix, value, path, depth);
+    const int position = lowerSlot(leaf, prefix, value);
+    if (position >= leaf->count
+        || compareKey(prefix, value, leaf->prefixes[position], leaf->keys[position]) != 0) {
+        return;
+    }
+
+    for (int i = position; i + 1 < leaf->count; ++i) {
+        leaf->prefixes[i] = leaf->prefixes[i + 1];
+        leaf->keys[i].swap(leaf->keys[i + 1]);
+    }
+    --leaf->count;
+    std::string().swap(leaf->keys[leaf->count]);   // буфер удалённой строки
+    --size_;
+    for (int level = 0; level < depth; ++level) {
+        --path[level].node->sizes[path[level].index];
+    }
+
+    if (depth == 0) {
+        if (leaf->count == 0) {
+            delete leaf;
+            root_ = nullptr;
+            first_ = nullptr;
+        }
+        return;
+    }
+    if (leaf->count >= kLeafSlots / 2) {
+        return;
+    }
+
+    // недозаполнение поднимается, пока узлы сливаются
+    for (int level = depth - 1; level >= 0; --level) {
+        Inner* parent = path[level].node;
+        if (!fixUnderflow(parent, path[level].index)) {
+            return;
+        }
+        if (level == 0) {
+            if (parent->count == 1) {
+                root_ = parent->children[0];
+                delete parent;
+            }
+            return;
+        }
+        if (parent->count >= kInnerSlots / 2) {
+            return;
+        }
+    }
+}
+
+bool BPlusTree::fixUnderflow(Inner* parent, int index)
+{
+    const int minCount = parent->children[index]->leaf ? kLeafSlots / 2 : kInnerSlots / 2;
+    if (index > 0 && parent->children[index - 1]->count > minCount) {
+        borrowFromLeft(parent, index);
+        return false;
+    }
+    if (index + 1 < parent->count && parent->children[index + 1]->count > minCount) {
+        borrowFromRight(parent, index);
+        return false;
+    }
+    mergeChildren(parent, index > 0 ? index - 1 : index);
+    return true;
+}
+
+void BPlusTree::borrowFromLeft(Inner* parent, int index)
+{
+    if (parent->children[index]->leaf) {
+        Leaf* left = static_cast<Leaf*>(parent->children[index - 1]);
+        Leaf* node = static_cast<Leaf*>(parent->children[index]);
+        // новый разделитель копируется до изменений: исключение оставит
+        // лист недозаполненным, но дерево — корректным
+        std::string separator = left->keys[left->count - 1];
+
+        for (int i = node->count; i > 0; --i) {
+            node->prefixes[i] = node->prefixes[i - 1];
+            node->keys[i].swap(node->keys[i - 1]);
+        }
+        node->prefixes[0] = left->prefixes[left->count - 1];
+        node->keys[0].swap(left->keys[left->count - 1]);
+        --left->count;
+        ++node->count;
+
+        parent->keys[index - 1].swap(separator);
+        parent->prefixes[index - 1] = node->prefixes[0];
+        --parent->sizes[index - 1];
+        ++parent->sizes[index];
+        return;
+    }
+
+    Inner* left = static_cast<Inner*>(parent->children[index - 1]);
+    Inner* node = static_cast<Inner*>(parent->children[index]);
+    for (int i = node->count; i > 0; --i) {
+        node->children[i] = node->children[i - 1];
+        node->sizes[i] = node->sizes[i - 1];
+    }
+    for (int i = node->count - 1; i > 0; --i) {
+        node->keys[i].swap(node->keys[i - 1]);
+        node->prefixes[i] = node->prefixes[i - 1];
+    }
+    node->keys[0].swap(parent->keys[index - 1]);
+    node->prefixes[0] = parent->prefixes[index - 1];
+    node->children[0] = left->children[left->count - 1];
+    node->sizes[0] = left->sizes[left->count - 1];
+
+    parent->keys[index - 1].swap(left->keys[left->count - 2]);
+    parent->prefixes[index - 1] = left->prefixes[left->count - 2];
+    --left->count;
+    ++node->count;
+
+    parent->sizes[index - 1] -= node->sizes[0];
+    parent->sizes[index] += node->sizes[0];
+}
+
+void BPlusTree::borrowFromRight(Inner* parent, int index)
+{
+    if (parent->children[index]->leaf) {
+        Leaf* node = static_cast<Leaf*>(parent->children[index]);
+        Leaf* right = static_cast<Leaf*>(parent->children[index + 1]);
+        std::string separator = right->keys[1];
+
+        node->prefixes[node->count] = right->prefixes[0];
+        node->keys[node->count].swap(right->keys[0]);
+        ++node->count;
+        for (int i = 0; i + 1 < right->count; ++i) {
+            right->prefixes[i] = right->prefixes[i + 1];
+            right->keys[i].swap(right->keys[i + 1]);
+        }
+        --right->count;
+
+        parent->keys[index].swap(separator);
+        parent->prefixes[index] = right->prefixes[0];
+        ++parent->sizes[index];
+        --parent->sizes[index + 1];
+        return;
+    }
+
+    Inner* node = static_cast<Inner*>(parent->children[index]);
+    Inner* right = static_cast<Inner*>(parent->children[index + 1]);
+    node->keys[node->count - 1].swap(parent->keys[index]);
+    node->prefixes[node->count - 1] = parent->prefixes[index];
+    node->children[node->count] = right->children[0];
+    node->sizes[node->count] = right->sizes[0];
+    ++node->count;
+
+    parent->keys[index].swap(right->keys[0]);
+    parent->prefixes[index] = right->prefixes[0];
+    for (int i = 0; i + 1 < right->count; ++i) {
+        right->children[i] = right->children[i + 1];
+        right->sizes[i] = right->sizes[i + 1];
+    }
+    for (int i = 0; i + 2 < right->count; ++i) {
+        right->keys[i].swap(right->keys[i + 1]);
+        right->prefixes[i] = right->prefixes[i + 1];
+    }
+    --right->count;
+
+    const std::size_t moved = node->sizes[node->count - 1];
+    parent->sizes[index] += moved;
+    parent->sizes[index + 1] -= moved;
+}
+
+void BPlusTree::mergeChildren(Inner* parent, int leftIndex) noexcept
+{
+    NodeBase* leftBase = parent->children[leftIndex];
+    NodeBase* rightBase = parent->children[leftIndex + 1];
+
+    if (leftBase->leaf) {
+        Leaf* left = static_cast<Leaf*>(leftBase);
+        Leaf* right = static_cast<Leaf*>(rightBase);
+        for (int i = 0; i < right->count; ++i) {
+            left->prefixes[left->count + i] = right->prefixes[i];
+            left->keys[left->count + i].swap(right->keys[i]);
+        }
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next != nullptr) {
+            right->next->prev = left;
+        }
+        delete right;
+    } else {
+        // разделитель родителя опускается между половинами
+        Inner* left = static_cast<Inner*>(leftBase);
+        Inner* right = static_cast<Inner*>(rightBase);
+        left->keys[left->count - 1].swap(parent->keys[leftIndex]);
+        left->prefixes[left->count - 1] = parent->prefixes[leftIndex];
+        for (int i = 0; i < right->count; ++i) {
+            left->children[left->count + i] = right->children[i];
+            left->sizes[left->count + i] = right->sizes[i];
+        }
+        for (int i = 0; i + 1 < right->count; ++i) {
+            left->keys[left->count + i].swap(right->keys[i]);
+            left->prefixes[left->count + i] = right->prefixes[i];
+        }
+        left->count += right->count;
+        delete right;
+    }
+
+    parent->sizes[leftIndex] += parent->sizes[leftIndex + 1];
+    for (int i = leftIndex + 1; i + 1 < parent->count; ++i) {
+        parent->children[i] = parent->children[i + 1];
+        parent->sizes[i] = parent->sizes[i + 1];
+    }
+    for (int i = leftIndex; i + 2 < parent->count; ++i) {
+        parent->keys[i].swap(parent->keys[i + 1]);
+        parent->prefixes[i] = parent->prefixes[i + 1];
+    }
+    --parent->count;
+    std::string().swap(parent->keys[parent->count - 1]);
+}
+
+//  поиск
+
+bool BPlusTree::contains(const std::string& value) const
+{
+    const std::uint64_t prefix = prefixOf(value);
+    int depth = 0;
+    const Leaf* leaf = descend(prefix, value, nullptr, depth);
+    if (leaf == nullptr) {
+        return false;
+    }
+    const int position = lowerSlot(leaf, prefix, value);
+    return position < leaf->count
+        && compareKey(prefix, value, leaf->prefixes[position], leaf->keys[position]) == 0;
+}
+
+//  порядковые запросы
+
+BPlusTree::ConstIterator BPlusTree::iteratorAt(const Leaf* leaf, int index) const noexcept
+{
+    if (leaf != nullptr && index == leaf->count) {
+        leaf = leaf->next;
+        index = 0;
+    }
+    ConstIterator it;
+    if (leaf != nullptr) {
+        it.leaf = leaf;
+        it.index = index;
+    }
+    return it;
+}
+
+BPlusTree::ConstIterator BPlusTree::begin() const noexcept
+{
+    return iteratorAt(first_, 0);
+}
+
+BPlusTree::ConstIterator BPlusTree::end() const noexcept
+{
+    return ConstIterator{};
+}
+
+BPlusTree::ConstIterator BPlusTree::lowerBound(std::string_view value) const
+{
+    const std::uint64_t prefix = prefixOf(value);
+    int depth = 0;
+    const Leaf* leaf = descend(prefix, value, nullptr, depth);
+    if (leaf == nullptr) {
+        return end();
+    }
+    return iteratorAt(leaf, lowerSlot(leaf, prefix, value));
+}
+
+BPlusTree::ConstIterator BPlusTree::upperBound(std::string_view value) const
+{
+    const std::uint64_t prefix = prefixOf(value);
+    int depth = 0;
+    const Leaf* leaf = descend(prefix, value, nullptr, depth);
+    if (leaf == nullptr) {
+        return end();
+    }
+    return iteratorAt(leaf, upperSlot(leaf, prefix, value));
+}
+
+std::pair<BPlusTree::ConstIterator, BPlusTree::ConstIterator>
+BPlusTree::prefixRange(std::string_view prefix) const
+{
+    // как в AvlTree: конец — lowerBound наименьшей строки, большей
+    // всех строк с этим префиксом
+    std::string next(prefix);
+    while (!next.empty() && static_cast<unsigned char>(next.back()) == 0xFF) {
+        next.pop_back();
+    }
+    if (next.empty()) {
+        return {lowerBound(prefix), end()};
+    }
+    next.back() = static_cast<char>(static_cast<unsigned char>(next.back()) + 1);
+    return {lowerBound(prefix), lowerBound(next)};
+}
+
+std::size_t BPlusTree::rank(std::string_view value) const noexcept
+{
+    if (root_ == nullptr) {
+        return 0;
+    }
+    // поддеревья левее пути целиком меньше value
+    const std::uint64_t prefix = prefixOf(value);
+    std::size_t less = 0;
+    const NodeBase* node = root_;
+    while (!node->leaf) {
+        const Inner* inner = static_cast<const Inner*>(node);
+        const int index = childIndex(inner, prefix, value);
+        for (int i = 0; i < index; ++i) {
+            less += inner->sizes[i];
+        }
+        node = inner->children[index];
+    }
+    return less + static_cast<std::size_t>(lowerSlot(static_cast<const Leaf*>(node), prefix, value));
+}
+
+std::size_t BPlusTree::rangeCount(std::string_view low, std::string_view high) const noexcept
+{
+    if (root_ == nullptr || high < low) {
+        return 0;
+    }
+
+    const std::uint64_t prefix = prefixOf(high);
+    std::size_t notGreater = 0;
+    const NodeBase* node = root_;
+    while (!node->leaf) {
+        const Inner* inner = static_cast<const Inner*>(node);
+        const int index = childIndex(inner, prefix, high);
+        for (int i = 0; i < index; ++i) {
+            notGreater += inner->sizes[i];
+        }
+        node = inner->children[index];
+    }
+    notGreater += static_cast<std::size_t>(upperSlot(static_cast<const Leaf*>(node), prefix, high));
+    return notGreater - rank(low);
+}
+
+std::string_view BPlusTree::nth(std::size_t index) const
+{
+    if (index >= size_) {
+        throw std::out_of_range("BPlusTree::nth: index out of range");
+    }
+
+    const NodeBase* node = root_;
+    while (!node->leaf) {
+        const Inner* inner = static_cast<const Inner*>(node);
+        int child = 0;
+        while (index >= inner->sizes[child]) {
+            index -= inner->sizes[child];
+            ++child;
+        }
+        node = inner->children[child];
+    }
+    return static_cast<const Leaf*>(node)->keys[index];
+}
+
+//  вывод
+
+void BPlusTree::print() const
+{
+    // по уровням: [разделители] внутренних узлов, (ключи) листьев
+    if (root_ == nullptr) {
+        return;
+    }
+
+    std::vector<const NodeBase*> level{root_};
+    while (!level.empty()) {
+        std::vector<const NodeBase*> nextLevel;
+        for (const NodeBase* node : level) {
+            if (node->leaf) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                std::cout << "(";
+                for (int i = 0; i < leaf->count; ++i) {
+                    std::cout << (i > 0 ? " " : "") << leaf->keys[i];
+                }
+                std::cout << ") ";
+            } else {
+                const Inner* inner = static_cast<const Inner*>(node);
+                std::cout << "[";
+                for (int i = 0; i + 1 < inner->count; ++i) {
+                    std::cout << (i > 0 ? " | " : "") << inner->keys[i];
+                }
+                std::cout << "] ";
+                nextLevel.insert(nextLevel.end(), inner->children, inner->children + inner->count);
+            }
+        }
+        std::cout << "\n";
+        level.swap(nextLevel);
+    }
+}
+
+//  размер / память
+
+std::size_t BPlusTree::size() const noexcept
+{
+    return size_;
+}
+
+bool BPlusTree::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+std::size_t BPlusTree::memoryUsage() const noexcept
+{
+    // считаются все слоты: освобождённые слоты могут держать буфер строки
+    return sizeof(BPlusTree) + (root_ != nullptr ? nodeMemory(root_) : 0);
+}
+
+int BPlusTree::height() const noexcept
+{
+    int levels = 0;
+    for (const NodeBase* node = root_; node != nullptr; ++levels) {
+        node = node->leaf ? nullptr : static_cast<const Inner*>(node)->children[0];
+    }
+    return levels;
+}
+
+//  загрузка
+
+void BPlusTree::buildFromSorted(std::string* values, std::size_t count)
+{
+    // листья заполняются поровну (до kLeafSlots), затем уровни внутренних
+    // узлов строятся так же — O(n) без единого сравнения
+    if (count == 0) {
+        return;
+    }
+
+    const std::size_t leafCount = (count + kLeafSlots - 1) / kLeafSlots;
+    std::vector<NodeBase*> allocated;
+    allocated.reserve(2 * leafCount + kMaxDepth);
+
+    try {
+        std::vector<NodeBase*> level;
+        std::vector<std::string> firstKeys;
+        std::vector<std::size_t> sizes;
+        level.reserve(leafCount);
+        firstKeys.reserve(leafCount);
+        sizes.reserve(leafCount);
+
+        std::size_t next = 0;
+        Leaf* previous = nullptr;
+        for (std::size_t i = 0; i < leafCount; ++i) {
+            const std::size_t take = count / leafCount + (i < count % leafCount ? 1 : 0);
+            Leaf* leaf = new Leaf();
+            allocated.push_back(leaf);
+            for (std::size_t j = 0; j < take; ++j) {
+                leaf->prefixes[j] = prefixOf(values[next]);
+                leaf->keys[j] = std::move(values[next]);
+                ++next;
+            }
+            leaf->count = static_cast<int>(take);
+            leaf->prev = previous;
+            if (previous != nullptr) {
+                previous->next = leaf;
+            }
+            previous = leaf;
+
+            level.push_back(leaf);
+            firstKeys.push_back(leaf->keys[0]);
+            sizes.push_back(take);
+        }
+
+        while (level.size() > 1) {
+            const std::size_t children = level.size();
+            const std::size_t parents = (children + kInnerSlots - 1) / kInnerSlots;
+            std::vector<NodeBase*> upper;
+            std::vector<std::string> upperKeys;
+            std::vector<std::size_t> upperSizes;
+            upper.reserve(parents);
+            upperKeys.reserve(parents);
+            upperSizes.reserve(parents);
+
+            std::size_t child = 0;
+            for (std::size_t p = 0; p < parents; ++p) {
+                const std::size_t take = children / parents + (p < children % parents ? 1 : 0);
+                Inner* inner = new Inner();
+                allocated.push_back(inner);
+                std::size_t total = 0;
+                for (std::size_t j = 0; j < take; ++j) {
+                    inner->children[j] = level[child + j];
+                    inner->sizes[j] = sizes[child + j];
+                    total += sizes[child + j];
+                    if (j > 0) {
+                        inner->keys[j - 1] = std::move(firstKeys[child + j]);
+                        inner->prefixes[j - 1] = prefixOf(inner->keys[j - 1]);
+                    }
+                }
+                inner->count = static_cast<int>(take);
+
+                upper.push_back(inner);
+                upperKeys.push_back(std::move(firstKeys[child]));
+                upperSizes.push_back(total);
+                child += take;
+            }
+
+            level.swap(upper);
+            firstKeys.swap(upperKeys);
+            sizes.swap(upperSizes);
+        }
+
+        root_ = level.front();
+        first_ = static_cast<Leaf*>(allocated.front());
+        size_ = count;
+    } catch (...) {
+        for (NodeBase* node : allocated) {
+            deleteNode(node);
+        }
+        throw;
+    }
+}
+
+void BPlusTree::loadValues(std::string* values, std::size_t count)
+{
+    // снапшоты пишутся по возрастанию и собираются снизу вверх;
+    // прочий вход (ручная правка, дубликаты) вставляется по одному
+    const bool sorted = std::adjacent_find(values, values + count,
+        [](const std::string& left, const std::string& right) {
+            return !(left < right);
+        }) == values + count;
+
+    BPlusTree loaded;
+    if (sorted) {
+        loaded.buildFromSorted(values, count);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            loaded.insert(values[i]);
+        }
+    }
+    swap(loaded);
+}
+
+//  текстовая сериализация
+
+std::string BPlusTree::serialize() const
+{
+    std::ostringstream oss;
+    oss << size_ << "\n";
+    for (std::string_view value : *this) {
+        oss << value << "\n";
+    }
+    return oss.str();
+}
+
+void BPlusTree::deserialize(const std::string& data)
+{
+    std::istringstream iss(data);
+    std::size_t count = 0;
+    if (!(iss >> count)) {
+        // пустой текст — пустое дерево
+        BPlusTree().swap(*this);
+        return;
+    }
+    iss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::vector<std::string> values;
+    values.reserve(memory_usage::trustedReserve(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string value;
+        if (!std::getline(iss, value)) {
+            throw std::runtime_error("BPlusTree::deserialize: error");
+        }
+        values.push_back(std::move(value));
+    }
+    loadValues(values.data(), values.size());
+}
+
+//  бинарная сериализация
+
+void BPlusTree::serializeBinary(std::ostream& outputStream) const
+{
+    const std::uint64_t count = size_;
+    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (std::string_view value : *this) {
+        const std::uint64_t len = value.size();
+        outputStream.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        if (len > 0) {
+            outputStream.write(value.data(), static_cast<std::streamsize>(len));
+        }
+    }
+    if (!outputStream) {
+        throw std::runtime_error("BPlusTree::serializeBinary: error");
+    }
+}
+
+void BPlusTree::deserializeBinary(std::istream& inputStream)
+{
+    std::uint64_t count = 0;
+    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!inputStream) {
+        throw std::runtime_error("BPlusTree::deserializeBinary: error");
+    }
+
+    std::vector<std::string> values;
+    values.reserve(memory_usage::trustedReserve(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t len = 0;
+        inputStream.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!inputStream) {
+            throw std::runtime_error("BPlusTree::deserializeBinary: error");
+        }
+        std::string value;
+        value.resize(static_cast<std::size_t>(len));
+        if (len > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(len));
+            if (!inputStream) {
+                throw std::runtime_error("BPlusTree::deserializeBinary: error");
+            }
+        }
+        values.push_back(std::move(value));
+    }
+    loadValues(values.data(), values.size());
+}
+
+//  Rule of Five: копирование / перемещение
+
+BPlusTree::BPlusTree(const BPlusTree& other)
+    : size_(other.size_)
+{
+    if (other.root_ != nullptr) {
+        Leaf* lastLeaf = nullptr;
+        root_ = cloneNode(other.root_, lastLeaf);
+        NodeBase* node = root_;
+        while (!node->leaf) {
+            node = static_cast<Inner*>(node)->children[0];
+        }
+        first_ = static_cast<Leaf*>(node);
+    }
+}
+
+BPlusTree::BPlusTree(BPlusTree&& other) noexcept
+    : root_(other.root_),
+      first_(other.first_),
+      size_(other.size_)
+{
+    other.root_ = nullptr;
+    other.first_ = nullptr;
+    other.size_ = 0;
+}
+
+BPlusTree& BPlusTree::operator=(const BPlusTree& other)
+{
+    if (this != &other) {
+        BPlusTree copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+BPlusTree& BPlusTree::operator=(BPlusTree&& other) noexcept
+{
+    if (this != &other) {
+        BPlusTree moved(std::move(other));
+        swap(moved);
+    }
+    return *this;
+}
+
+void BPlusTree::swap(BPlusTree& other) noexcept
+{
+    std::swap(root_, other.root_);
+    std::swap(first_, other.first_);
+    std::swap(size_, other.size_);
+}
+
+//  ConstIterator
+
+std::string_view BPlusTree::ConstIterator::operator*() const noexcept
+{
+    return leaf->keys[index];
+}
+
+BPlusTree::ConstIterator& BPlusTree::ConstIterator::operator++() noexcept
+{
+    if (++index == leaf->count) {
+        leaf = leaf->next;
+        index = 0;
+    }
+    return *this;
+}
+
+BPlusTree::ConstIterator BPlusTree::ConstIterator::operator++(int) noexcept
+{
+    ConstIterator previous = *this;
+    ++(*this);
+    return previous;
+}
+
+bool BPlusTree::ConstIterator::operator==(const ConstIterator& other) const noexcept
+{
+    return leaf == other.leaf && index == other.index;
+}
+
+bool BPlusTree::ConstIterator::operator!=(const ConstIterator& other) const noexcept
+{
+    return !(*this == other);
+}
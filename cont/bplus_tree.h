@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+//  BPlusTree — упорядоченное множество строк на B+-дереве
+//
+//  Альтернатива AvlTree с тем же интерфейсом. Ключи лежат в листах массивами
+//  по kLeafSlots (короткие строки — внутри std::string, без обращения к куче),
+//  рядом — массив 8-байтовых префиксов: бинарный поиск сравнивает целые числа
+//  и читает саму строку только при совпадении префикса. Листы связаны в
+//  список для обхода диапазонов, внутренние узлы хранят размеры поддеревьев
+//  для rank/nth.
+
+class BPlusTree
+{
+public:
+    BPlusTree() noexcept = default;
+    ~BPlusTree();
+
+    // Rule of Five
+    BPlusTree(const BPlusTree& other);
+    BPlusTree(BPlusTree&& other) noexcept;
+    BPlusTree& operator=(const BPlusTree& other);
+    BPlusTree& operator=(BPlusTree&& other) noexcept;
+
+    // Базовые операции
+    void insert(const std::string& value);
+    void remove(const std::string& value);
+    [[nodiscard]] bool contains(const std::string& value) const;
+
+    // Порядковые запросы (как у AvlTree); изменение дерева делает
+    // итераторы и строки из nth недействительными
+    class ConstIterator;
+
+    [[nodiscard]] ConstIterator begin() const noexcept;
+    [[nodiscard]] ConstIterator end() const noexcept;
+    [[nodiscard]] ConstIterator lowerBound(std::string_view value) const;   // первое >= value
+    [[nodiscard]] ConstIterator upperBound(std::string_view value) const;   // первое > value
+    [[nodiscard]] std::pair<ConstIterator, ConstIterator> prefixRange(std::string_view prefix) const;
+
+    [[nodiscard]] std::size_t rank(std::string_view value) const noexcept;  // сколько значений < value
+    [[nodiscard]] std::size_t rangeCount(std::string_view low, std::string_view high) const noexcept; // в [low, high]
+    [[nodiscard]] std::string_view nth(std::size_t index) const;            // с нуля; std::out_of_range
+
+    // Вспомогательные методы
+    void print() const;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + узлы + строки
+    [[nodiscard]] int height() const noexcept;                // уровней, 0 — пустое дерево
+
+    //  текстовая сериализация: число значений, затем по значению в строке
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& data);
+
+    //  бинарная сериализация: [u64 count] затем count раз [u64 len][bytes]
+    //  по возрастанию; отсортированный вход собирается снизу вверх за O(n)
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+    void swap(BPlusTree& other) noexcept;
+
+private:
+    // 32 ключа: массив префиксов занимает 4 кеш-линии, поиск в нём —
+    // 5 сравнений целых чисел. Узлы заполнены не меньше чем наполовину,
+    // поэтому высота дерева из 2^64 ключей меньше kMaxDepth.
+    static constexpr int kLeafSlots  = 32;   // ключей в листе
+    static constexpr int kInnerSlots = 32;   // детей во внутреннем узле
+    static constexpr int kMaxDepth   = 24;
+
+    struct NodeBase
+    {
+        bool leaf;
+        int count;   // ключей в листе / детей во внутреннем узле
+    };
+
+    // массивы на слот больше: переполнение допускается до разделения узла
+    struct Leaf : NodeBase
+    {
+        std::uint64_t prefixes[kLeafSlots + 1];
+        std::string keys[kLeafSlots + 1];
+        Leaf* prev{nullptr};
+        Leaf* next{nullptr};
+
+        Leaf() noexcept : NodeBase{true, 0}, prefixes{} {}
+    };
+
+    // keys[i] — наименьший ключ поддерева children[i + 1]
+    struct Inner : NodeBase
+    {
+        std::uint64_t prefixes[kInnerSlots];
+        std::string keys[kInnerSlots];
+        NodeBase* children[kInnerSlots + 1];
+        std::size_t sizes[kInnerSlots + 1];   // ключей в поддеревьях
+
+        Inner() noexcept : NodeBase{false, 0}, prefixes{}, children{}, sizes{} {}
+    };
+
+    struct PathStep
+    {
+        Inner* node;
+        int index;   // номер ребёнка, в который ушёл спуск
+    };
+
+    NodeBase* root_{nullptr};
+    Leaf* first_{nullptr};
+    std::size_t size_{0};
+
+    [[nodiscard]] static std::uint64_t prefixOf(std::string_view key) noexcept;
+    [[nodiscard]] static int compareKey(std::uint64_t prefix, std::string_view key,
+                                        std::uint64_t slotPrefix, const std::string& slotKey) noexcept;
+    [[nodiscard]] static int childIndex(const Inner* inner, std::uint64_t prefix, std::string_view key) noexcept;
+    [[nodiscard]] static int lowerSlot(const Leaf* leaf, std::uint64_t prefix, std::string_view key) noexcept;
+    [[nodiscard]] static int upperSlot(const Leaf* leaf, std::uint64_t prefix, std::string_view key) noexcept;
+    [[nodiscard]] static std::size_t totalOf(const NodeBase* node) noexcept;
+
+    // спуск к листу; path заполняется, если передан
+    [[nodiscard]] Leaf* descend(std::uint64_t prefix, std::string_view key,
+                                PathStep* path, int& depth) const noexcept;
+
+    // разделение переполненного листа и его предков; вся память
+    // выделяется до первого изменения дерева
+    void splitUpward(PathStep* path, int depth, Leaf* leaf);
+    static void splitLeaf(Leaf* leaf, Leaf* right) noexcept;
+    static void splitInner(Inner* inner, Inner* right, std::string& upKey) noexcept;
+
+    // parent->children[index] недозаполнен: заём у соседа или слияние;
+    // true — дети слиты и parent потерял ребёнка
+    static bool fixUnderflow(Inner* parent, int index);
+    static void borrowFromLeft(Inner* parent, int index);
+    static void borrowFromRight(Inner* parent, int index);
+    static void mergeChildren(Inner* parent, int leftIndex) noexcept;
+
+    // сборка пустого дерева из строго возрастающих значений (они перемещаются)
+    void buildFromSorted(std::string* values, std::size_t count);
+    void loadValues(std::string* values, std::size_t count);
+
+    static void deleteNode(NodeBase* node) noexcept;   // только сам узел
+    static void freeNode(NodeBase* node) noexcept;     // узел и поддерево
+    static NodeBase* cloneNode(const NodeBase* node, Leaf*& lastLeaf);
+    [[nodiscard]] static std::size_t nodeMemory(const NodeBase* node) noexcept;
+
+    [[nodiscard]] ConstIterator iteratorAt(const Leaf* leaf, int index) const noexcept;
+};
+
+
+//  BPlusTree::ConstIterator — обход по связанному списку листов
+
+class BPlusTree::ConstIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = std::string_view;
+
+    ConstIterator() noexcept = default;
+
+    [[nodiscard]] std::string_view operator*() const noexcept;
+    ConstIterator& operator++() noexcept;
+    ConstIterator operator++(int) noexcept;
+
+    [[nodiscard]] bool operator==(const ConstIterator& other) const noexcept;
+    [[nodiscard]] bool operator!=(const ConstIterator& other) const noexcept;
+
+private:
+    friend class BPlusTree;
+
+    const Leaf* leaf{nullptr};
+    int index{0};
+};
@@ -0,0 +1,412 @@
+#include "compact_string_array.h"
+#include "array.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COMPACT_STRING_ARRAY_MMAP 1
+#endif
+
+namespace
+{
+constexpr std::size_t kWordBytes = sizeof(std::uint64_t);
+// заявленному размеру из потока верим только порциями
+constexpr std::size_t kReadChunkWords = std::size_t{1} << 16;
+
+std::size_t wordsFor(std::size_t bytes) noexcept
+{
+    return (bytes + kWordBytes - 1) / kWordBytes;
+}
+
+// дочитать ещё count слов в words; false — поток кончился раньше
+bool readWords(std::istream& inputStream, std::vector<std::uint64_t>& words, std::uint64_t count)
+{
+    while (count > 0) {
+        const std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(count, kReadChunkWords));
+        const std::size_t oldSize = words.size();
+        words.resize(oldSize + chunk);
+        inputStream.read(reinterpret_cast<char*>(words.data() + oldSize),
+                         static_cast<std::streamsize>(chunk * kWordBytes));
+        if (!inputStream) {
+            return false;
+        }
+        count -= chunk;
+    }
+    return true;
+}
+} // namespace
+
+//  конструкторы, владение буфером
+
+CompactStringArray::~CompactStringArray()
+{
+    reset();
+}
+
+CompactStringArray::CompactStringArray(const CompactStringArray& other)
+{
+    if (other.image_ == nullptr) {
+        return;
+    }
+    std::uint64_t* words = allocateWords(other.imageBytes_ / kWordBytes);
+    std::memcpy(words, other.image_, other.imageBytes_);
+    adoptOwned(words, other.imageBytes_);
+}
+
+CompactStringArray::CompactStringArray(CompactStringArray&& other) noexcept
+{
+    swap(other);
+}
+
+CompactStringArray& CompactStringArray::operator=(const CompactStringArray& other)
+{
+    if (this != &other) {
+        CompactStringArray tmp(other);
+        swap(tmp);
+    }
+    return *this;
+}
+
+CompactStringArray& CompactStringArray::operator=(CompactStringArray&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        swap(other);
+    }
+    return *this;
+}
+
+void CompactStringArray::swap(CompactStringArray& other) noexcept
+{
+    using std::swap;
+    swap(ownedWords_, other.ownedWords_);
+    swap(image_, other.image_);
+    swap(imageBytes_, other.imageBytes_);
+    swap(mapping_, other.mapping_);
+    swap(mappingBytes_, other.mappingBytes_);
+}
+
+std::uint64_t* CompactStringArray::allocateWords(std::size_t words)
+{
+    if (words > std::numeric_limits<std::size_t>::max() / kWordBytes) {
+        throw std::length_error("CompactStringArray: image is too large");
+    }
+    return new std::uint64_t[words];
+}
+
+void CompactStringArray::adoptOwned(std::uint64_t* words, std::size_t bytes) noexcept
+{
+    reset();
+    ownedWords_ = words;
+    image_ = words;
+    imageBytes_ = bytes;
+}
+
+void CompactStringArray::reset() noexcept
+{
+    delete[] ownedWords_;
+#ifdef COMPACT_STRING_ARRAY_MMAP
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mappingBytes_);
+    }
+#endif
+    ownedWords_ = nullptr;
+    image_ = nullptr;
+    imageBytes_ = 0;
+    mapping_ = nullptr;
+    mappingBytes_ = 0;
+}
+
+//  сборка и проверка образа
+
+template <class Get>
+CompactStringArray CompactStringArray::build(std::size_t count, Get&& get)
+{
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        total += std::string_view(get(i)).size();
+    }
+
+    const std::size_t words = kHeaderWords + count + 1 + wordsFor(total);
+    std::uint64_t* buffer = allocateWords(words);
+    buffer[words - 1] = 0;   // хвост последнего слова символов — нули
+    buffer[0] = kMagic;
+    buffer[1] = count;
+
+    std::uint64_t* offsets = buffer + kHeaderWords;
+    char* out = reinterpret_cast<char*>(offsets + count + 1);
+    std::size_t position = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string_view text(get(i));
+        offsets[i] = position;
+        std::memcpy(out + position, text.data(), text.size());
+        position += text.size();
+    }
+    offsets[count] = position;
+
+    CompactStringArray result;
+    result.adoptOwned(buffer, words * kWordBytes);
+    return result;
+}
+
+void CompactStringArray::validateImage(const std::uint64_t* words, std::size_t bytes)
+{
+    const std::size_t totalWords = bytes / kWordBytes;
+    if (bytes % kWordBytes != 0 || totalWords < kHeaderWords + 1 || words[0] != kMagic) {
+        throw std::runtime_error("CompactStringArray: bad image header");
+    }
+
+    const std::uint64_t count = words[1];
+    if (count > totalWords - kHeaderWords - 1) {
+        throw std::runtime_error("CompactStringArray: bad image size");
+    }
+
+    const std::uint64_t* offsets = words + kHeaderWords;
+    if (offsets[0] != 0) {
+        throw std::runtime_error("CompactStringArray: bad image offsets");
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw std::runtime_error("CompactStringArray: bad image offsets");
+        }
+    }
+
+    const std::size_t charWords = totalWords - kHeaderWords - static_cast<std::size_t>(count) - 1;
+    if (offsets[count] > charWords * kWordBytes
+        || wordsFor(static_cast<std::size_t>(offsets[count])) != charWords) {
+        throw std::runtime_error("CompactStringArray: bad image size");
+    }
+}
+
+const std::uint64_t* CompactStringArray::offsets() const noexcept
+{
+    return image_ + kHeaderWords;
+}
+
+const char* CompactStringArray::chars() const noexcept
+{
+    return reinterpret_cast<const char*>(offsets() + size() + 1);
+}
+
+//  перевод из MyArray и обратно
+
+CompactStringArray::CompactStringArray(const MyArray& source)
+{
+    CompactStringArray built = build(source.size(), [&source](std::size_t i) -> const std::string& {
+        return source[i];
+    });
+    swap(built);
+}
+
+MyArray CompactStringArray::toMyArray() const
+{
+    MyArray result(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        result.pushBack(std::string((*this)[i]));
+    }
+    return result;
+}
+
+//  образ в чужой памяти и в файле
+
+CompactStringArray CompactStringArray::viewImage(const char* data, std::size_t bytes)
+{
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint64_t) != 0) {
+        throw std::runtime_error("CompactStringArray::viewImage: unaligned image");
+    }
+    const auto* words = reinterpret_cast<const std::uint64_t*>(data);
+    validateImage(words, bytes);
+
+    CompactStringArray result;
+    result.image_ = words;
+    result.imageBytes_ = bytes;
+    return result;
+}
+
+CompactStringArray CompactStringArray::mapFile(const std::string& path)
+{
+#ifdef COMPACT_STRING_ARRAY_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("CompactStringArray::mapFile: cannot open " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("CompactStringArray::mapFile: bad file " + path);
+    }
+    const std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // отображение остаётся действительным
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("CompactStringArray::mapFile: mmap failed for " + path);
+    }
+
+    // владение отображением — до проверки, чтобы ошибка формата его сняла
+    CompactStringArray result;
+    result.mapping_ = mapping;
+    result.mappingBytes_ = bytes;
+    validateImage(static_cast<const std::uint64_t*>(mapping), bytes);
+    result.image_ = static_cast<const std::uint64_t*>(mapping);
+    result.imageBytes_ = bytes;
+    return result;
+#else
+    // без mmap — обычное чтение в свой буфер
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("CompactStringArray::mapFile: cannot open " + path);
+    }
+    CompactStringArray result;
+    result.deserializeBinary(input);
+    return result;
+#endif
+}
+
+//  доступ
+
+std::string_view CompactStringArray::at(std::size_t index) const
+{
+    if (index >= size()) {
+        throw std::out_of_range("CompactStringArray::at: error");
+    }
+    return (*this)[index];
+}
+
+std::string_view CompactStringArray::operator[](std::size_t index) const noexcept
+{
+    const std::uint64_t* bounds = offsets();
+    return std::string_view(chars() + bounds[index],
+                            static_cast<std::size_t>(bounds[index + 1] - bounds[index]));
+}
+
+std::size_t CompactStringArray::size() const noexcept
+{
+    return image_ == nullptr ? 0 : static_cast<std::size_t>(image_[1]);
+}
+
+bool CompactStringArray::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::size_t CompactStringArray::totalChars() const noexcept
+{
+    return image_ == nullptr ? 0 : static_cast<std::size_t>(offsets()[size()]);
+}
+
+std::size_t CompactStringArray::imageBytes() const noexcept
+{
+    return imageBytes_;
+}
+
+void CompactStringArray::print() const
+{
+    std::cout << "[";
+    for (std::size_t i = 0; i < size(); ++i) {
+        std::cout << (*this)[i];
+        if (i + 1 < size()) {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]\n";
+}
+
+std::size_t CompactStringArray::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(*this);
+    if (ownedWords_ != nullptr) {
+        total += memory_usage::heapBlock(imageBytes_);
+    }
+    return total;
+}
+
+//  текстовая сериализация
+
+std::string CompactStringArray::serialize() const
+{
+    std::ostringstream oss;
+    oss << size() << '\n';
+    for (std::size_t i = 0; i < size(); ++i) {
+        oss << (*this)[i] << '\n';
+    }
+    return oss.str();
+}
+
+void CompactStringArray::deserialize(const std::string& data)
+{
+    std::istringstream iss(data);
+    std::size_t count = 0;
+    if (!(iss >> count)) {
+        throw std::runtime_error("CompactStringArray::deserialize: error");
+    }
+    iss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::vector<std::string> lines;
+    std::string line;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!std::getline(iss, line)) {
+            throw std::runtime_error("CompactStringArray::deserialize: error");
+        }
+        lines.push_back(std::move(line));
+    }
+
+    CompactStringArray built = build(lines.size(), [&lines](std::size_t i) -> const std::string& {
+        return lines[i];
+    });
+    swap(built);
+}
+
+//  бинарная сериализация
+
+void CompactStringArray::serializeBinary(std::ostream& outputStream) const
+{
+    if (image_ == nullptr) {
+        // пустой массив — тоже полноценный образ
+        const std::uint64_t emptyImage[kHeaderWords + 1] = {kMagic, 0, 0};
+        outputStream.write(reinterpret_cast<const char*>(emptyImage), sizeof(emptyImage));
+    } else {
+        outputStream.write(reinterpret_cast<const char*>(image_), static_cast<std::streamsize>(imageBytes_));
+    }
+
+    if (!outputStream) {
+        throw std::runtime_error("CompactStringArray::serializeBinary: error");
+    }
+}
+
+void CompactStringArray::deserializeBinary(std::istream& inputStream)
+{
+    std::vector<std::uint64_t> words;
+    if (!readWords(inputStream, words, kHeaderWords) || words[0] != kMagic) {
+        throw std::runtime_error("CompactStringArray::deserializeBinary: error");
+    }
+    const std::uint64_t count = words[1];
+    if (count > std::numeric_limits<std::size_t>::max() / kWordBytes - kHeaderWords - 1
+        || !readWords(inputStream, words, count + 1)) {
+        throw std::runtime_error("CompactStringArray::deserializeBinary: error");
+    }
+    const std::uint64_t total = words.back();
+    if (total > std::numeric_limits<std::size_t>::max() - kWordBytes
+        || !readWords(inputStream, words, wordsFor(static_cast<std::size_t>(total)))) {
+        throw std::runtime_error("CompactStringArray::deserializeBinary: error");
+    }
+
+    const std::size_t bytes = words.size() * kWordBytes;
+    validateImage(words.data(), bytes);
+
+    std::uint64_t* buffer = allocateWords(words.size());
+    std::memcpy(buffer, words.data(), bytes);
+    adoptOwned(buffer, bytes);
+}
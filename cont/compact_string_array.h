@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+class MyArray;
+
+//  CompactStringArray — неизменяемый массив строк в одном буфере
+//
+//  Все символы лежат подряд в одном буфере, границы строк — в массиве
+//  смещений: ни одной аллокации на элемент, последовательный проход читает
+//  память подряд. Для изменяемых данных — MyArray; массивы, загруженные из
+//  снапшота и дальше только читаемые, переводятся в этот вид и обратно.
+//
+//  Образ в памяти совпадает с бинарным форматом (слова u64, порядок байт
+//  платформы):
+//      [magic][count][offsets: count + 1 слов][символы, дополнены до 8 байт]
+//  Поэтому образ из файла или чужого буфера используется на месте, без
+//  разбора и копирования (mapFile, viewImage).
+
+class CompactStringArray
+{
+public:
+    CompactStringArray() noexcept = default;
+    ~CompactStringArray();
+
+    // Rule of Five: копия всегда владеет своим буфером
+    CompactStringArray(const CompactStringArray& other);
+    CompactStringArray(CompactStringArray&& other) noexcept;
+    CompactStringArray& operator=(const CompactStringArray& other);
+    CompactStringArray& operator=(CompactStringArray&& other) noexcept;
+
+    // Перевод между изменяемым и компактным видом
+    explicit CompactStringArray(const MyArray& source);
+    [[nodiscard]] MyArray toMyArray() const;
+
+    // Образ в чужой памяти: data выровнена по 8 байт и живёт дольше массива.
+    // Формат проверяется, при ошибке — std::runtime_error
+    [[nodiscard]] static CompactStringArray viewImage(const char* data, std::size_t bytes);
+    // Файл с образом (serializeBinary) отображается в память только для чтения
+    [[nodiscard]] static CompactStringArray mapFile(const std::string& path);
+
+    // Доступ: строки действительны, пока жив массив
+    [[nodiscard]] std::string_view at(std::size_t index) const;          // std::out_of_range
+    [[nodiscard]] std::string_view operator[](std::size_t index) const noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t totalChars() const noexcept;   // символов во всех строках
+    [[nodiscard]] std::size_t imageBytes() const noexcept;
+
+    void print() const;
+    // байты: объект + свой буфер (чужой и отображённый образ не считаются)
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;
+
+    //  текстовая сериализация — как у MyArray: число строк, затем по строке
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& data);
+
+    //  бинарная сериализация — образ целиком
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+    void swap(CompactStringArray& other) noexcept;
+
+private:
+    // "CSARRAY1" в little-endian
+    static constexpr std::uint64_t kMagic = 0x3159415252415343ULL;
+    static constexpr std::size_t kHeaderWords = 2;
+
+    std::uint64_t* ownedWords_{nullptr};   // свой буфер образа
+    const std::uint64_t* image_{nullptr};  // образ: свой, чужой или отображённый
+    std::size_t imageBytes_{0};
+    void* mapping_{nullptr};               // отображение файла (munmap в деструкторе)
+    std::size_t mappingBytes_{0};
+
+    [[nodiscard]] const std::uint64_t* offsets() const noexcept;
+    [[nodiscard]] const char* chars() const noexcept;
+
+    // проверка заголовка и смещений образа words длиной bytes
+    static void validateImage(const std::uint64_t* words, std::size_t bytes);
+    static std::uint64_t* allocateWords(std::size_t words);
+    void adoptOwned(std::uint64_t* words, std::size_t bytes) noexcept;
+    void reset() noexcept;
+
+    // образ из count строк: get(i) возвращает i-ю строку
+    template <class Get>
+    static CompactStringArray build(std::size_t count, Get&& get);
+};
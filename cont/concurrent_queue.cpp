@@ -0,0 +1,474 @@
+#include "concurrent_queue.h"
+#include "memory_usage.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+std::size_t roundCapacity(std::size_t capacity)
+{
+    // схеме Вьюкова нужно минимум два слота
+    std::size_t rounded = 2;
+    while (rounded < capacity) {
+        if (rounded > std::numeric_limits<std::size_t>::max() / 2 / sizeof(std::string)) {
+            throw std::length_error("concurrent queue: capacity is too large");
+        }
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+// общие для обеих очередей форматы — те же, что у Queue
+
+template <class ForEach>
+void writeText(std::ostream& outputStream, ForEach&& forEach)
+{
+    forEach([&outputStream](const std::string& value) { outputStream << value << '\n'; });
+}
+
+template <class Append>
+void readText(std::istream& inputStream, Append&& append)
+{
+    std::string line;
+    while (std::getline(inputStream, line)) {
+        if (!line.empty()) {
+            append(std::move(line));
+        }
+    }
+}
+
+template <class ForEach>
+void writeBinary(std::ostream& outputStream, std::size_t count, ForEach&& forEach, const char* error)
+{
+    const std::uint64_t storedCount = static_cast<std::uint64_t>(count);
+    outputStream.write(reinterpret_cast<const char*>(&storedCount), sizeof(storedCount));
+
+    forEach([&outputStream](const std::string& value) {
+        const std::uint64_t length = static_cast<std::uint64_t>(value.size());
+        outputStream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        if (length > 0) {
+            outputStream.write(value.data(), static_cast<std::streamsize>(length));
+        }
+    });
+
+    if (!outputStream) {
+        throw std::runtime_error(error);
+    }
+}
+
+// место не резервируется по count из потока: очередь растёт по мере чтения
+template <class Append>
+void readBinary(std::istream& inputStream, Append&& append, const char* error)
+{
+    std::uint64_t storedCount = 0;
+    inputStream.read(reinterpret_cast<char*>(&storedCount), sizeof(storedCount));
+    if (!inputStream) {
+        throw std::runtime_error(error);
+    }
+
+    for (std::uint64_t i = 0; i < storedCount; ++i) {
+        std::uint64_t length = 0;
+        inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!inputStream) {
+            throw std::runtime_error(error);
+        }
+
+        std::string value;
+        value.resize(static_cast<std::size_t>(length));
+        if (length > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(length));
+            if (!inputStream) {
+                throw std::runtime_error(error);
+            }
+        }
+        append(std::move(value));
+    }
+}
+
+template <class ForEach>
+void printValues(std::size_t count, ForEach&& forEach)
+{
+    std::cout << "[";
+    std::size_t printed = 0;
+    forEach([&printed, count](const std::string& value) {
+        std::cout << value;
+        if (++printed < count) {
+            std::cout << ", ";
+        }
+    });
+    std::cout << "]\n";
+}
+
+} // namespace
+
+
+//  SpscQueue
+
+SpscQueue::SpscQueue(std::size_t capacity)
+{
+    reset(capacity);
+}
+
+void SpscQueue::reset(std::size_t capacity)
+{
+    slots      = std::vector<std::string>(roundCapacity(capacity));
+    mask       = slots.size() - 1;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cachedTail = 0;
+    cachedHead = 0;
+}
+
+template <class Value>
+bool SpscQueue::pushImpl(Value&& value)
+{
+    const std::size_t position = tail.load(std::memory_order_relaxed);
+    if (position - cachedHead == slots.size()) {
+        // кольцо выглядит полным: перечитываем head потребителя
+        cachedHead = head.load(std::memory_order_acquire);
+        if (position - cachedHead == slots.size()) {
+            return false;
+        }
+    }
+
+    // слот вне живого диапазона — пустая строка; при исключении tail не сдвинут
+    slots[position & mask] = std::forward<Value>(value);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool SpscQueue::tryPush(const std::string& value)
+{
+    return pushImpl(value);
+}
+
+bool SpscQueue::tryPush(std::string&& value)
+{
+    return pushImpl(std::move(value));
+}
+
+void SpscQueue::push(const std::string& value)
+{
+    if (!pushImpl(value)) {
+        throw std::overflow_error("SpscQueue::push: queue is full");
+    }
+}
+
+bool SpscQueue::tryPop(std::string& out)
+{
+    const std::size_t position = head.load(std::memory_order_relaxed);
+    if (position == cachedTail) {
+        cachedTail = tail.load(std::memory_order_acquire);
+        if (position == cachedTail) {
+            return false;
+        }
+    }
+
+    // перемещение оставляет в слоте пустую строку без буфера
+    out = std::move(slots[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+std::string SpscQueue::pop()
+{
+    std::string result;
+    if (!tryPop(result)) {
+        throw std::out_of_range("SpscQueue::pop: queue is empty");
+    }
+    return result;
+}
+
+std::size_t SpscQueue::size() const noexcept
+{
+    // head читаем первым: tail не меньше любого прочитанного до него head
+    const std::size_t first = head.load(std::memory_order_acquire);
+    return tail.load(std::memory_order_acquire) - first;
+}
+
+bool SpscQueue::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::size_t SpscQueue::capacity() const noexcept
+{
+    return slots.size();
+}
+
+template <class Visit>
+void SpscQueue::forEach(Visit&& visit) const
+{
+    const std::size_t last = tail.load(std::memory_order_acquire);
+    for (std::size_t position = head.load(std::memory_order_acquire); position != last; ++position) {
+        visit(slots[position & mask]);
+    }
+}
+
+std::size_t SpscQueue::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(SpscQueue) + memory_usage::heapBlock(slots.size() * sizeof(std::string));
+    forEach([&total](const std::string& value) { total += memory_usage::stringHeap(value); });
+    return total;
+}
+
+void SpscQueue::appendLoaded(std::string&& value)
+{
+    if (size() == slots.size()) {
+        // только при загрузке: строки переезжают в кольцо вдвое больше
+        std::vector<std::string> grown(roundCapacity(slots.size() * 2));
+        std::size_t moved = 0;
+        const std::size_t last = tail.load(std::memory_order_relaxed);
+        for (std::size_t position = head.load(std::memory_order_relaxed); position != last; ++position) {
+            grown[moved++] = std::move(slots[position & mask]);
+        }
+        slots.swap(grown);
+        mask = slots.size() - 1;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(moved, std::memory_order_relaxed);
+        cachedHead = 0;
+        cachedTail = 0;
+    }
+    (void)pushImpl(std::move(value));
+}
+
+void SpscQueue::print() const
+{
+    printValues(size(), [this](auto&& visit) { forEach(visit); });
+}
+
+void SpscQueue::serializeText(std::ostream& outputStream) const
+{
+    writeText(outputStream, [this](auto&& visit) { forEach(visit); });
+}
+
+void SpscQueue::deserializeText(std::istream& inputStream)
+{
+    reset(capacity());
+    readText(inputStream, [this](std::string&& value) { appendLoaded(std::move(value)); });
+}
+
+std::string SpscQueue::serialize() const
+{
+    std::ostringstream output;
+    serializeText(output);
+    return output.str();
+}
+
+void SpscQueue::deserialize(const std::string& text)
+{
+    std::istringstream input(text);
+    deserializeText(input);
+}
+
+void SpscQueue::serializeBinary(std::ostream& outputStream) const
+{
+    writeBinary(outputStream, size(), [this](auto&& visit) { forEach(visit); },
+                "SpscQueue::serializeBinary: ERROR");
+}
+
+void SpscQueue::deserializeBinary(std::istream& inputStream)
+{
+    reset(capacity());
+    readBinary(inputStream, [this](std::string&& value) { appendLoaded(std::move(value)); },
+               "SpscQueue::deserializeBinary: ERROR");
+}
+
+
+//  MpmcQueue
+
+MpmcQueue::MpmcQueue(std::size_t capacity)
+{
+    reset(capacity);
+}
+
+void MpmcQueue::reset(std::size_t capacity)
+{
+    slots = std::vector<Slot>(roundCapacity(capacity));
+    mask  = slots.size() - 1;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+bool MpmcQueue::pushMoved(std::string&& value)
+{
+    std::size_t position = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots[position & mask];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+        if (diff == 0) {
+            // слот свободен для этой позиции: пробуем её захватить
+            if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // слот ещё не прочитан с прошлого круга — очередь полна
+            return false;
+        } else {
+            position = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->value = std::move(value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool MpmcQueue::tryPush(const std::string& value)
+{
+    return pushMoved(std::string(value));
+}
+
+bool MpmcQueue::tryPush(std::string&& value)
+{
+    return pushMoved(std::move(value));
+}
+
+void MpmcQueue::push(const std::string& value)
+{
+    if (!pushMoved(std::string(value))) {
+        throw std::overflow_error("MpmcQueue::push: queue is full");
+    }
+}
+
+bool MpmcQueue::tryPop(std::string& out)
+{
+    std::size_t position = dequeuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots[position & mask];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    out = std::move(slot->value);
+    // слот свободен для записи на следующем круге
+    slot->sequence.store(position + mask + 1, std::memory_order_release);
+    return true;
+}
+
+std::string MpmcQueue::pop()
+{
+    std::string result;
+    if (!tryPop(result)) {
+        throw std::out_of_range("MpmcQueue::pop: queue is empty");
+    }
+    return result;
+}
+
+std::size_t MpmcQueue::size() const noexcept
+{
+    // dequeuePos читаем первым: enqueuePos не меньше любого прочитанного до него
+    const std::size_t first = dequeuePos.load(std::memory_order_acquire);
+    return enqueuePos.load(std::memory_order_acquire) - first;
+}
+
+bool MpmcQueue::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::size_t MpmcQueue::capacity() const noexcept
+{
+    return slots.size();
+}
+
+template <class Visit>
+void MpmcQueue::forEach(Visit&& visit) const
+{
+    const std::size_t last = enqueuePos.load(std::memory_order_acquire);
+    for (std::size_t position = dequeuePos.load(std::memory_order_acquire); position != last; ++position) {
+        visit(slots[position & mask].value);
+    }
+}
+
+std::size_t MpmcQueue::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(MpmcQueue) + memory_usage::heapBlock(slots.size() * sizeof(Slot));
+    forEach([&total](const std::string& value) { total += memory_usage::stringHeap(value); });
+    return total;
+}
+
+void MpmcQueue::appendLoaded(std::string&& value)
+{
+    if (size() == slots.size()) {
+        std::vector<Slot> grown(roundCapacity(slots.size() * 2));
+        std::size_t moved = 0;
+        const std::size_t last = enqueuePos.load(std::memory_order_relaxed);
+        for (std::size_t position = dequeuePos.load(std::memory_order_relaxed); position != last; ++position) {
+            grown[moved].value = std::move(slots[position & mask].value);
+            grown[moved].sequence.store(moved + 1, std::memory_order_relaxed);
+            ++moved;
+        }
+        for (std::size_t i = moved; i < grown.size(); ++i) {
+            grown[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        slots.swap(grown);
+        mask = slots.size() - 1;
+        dequeuePos.store(0, std::memory_order_relaxed);
+        enqueuePos.store(moved, std::memory_order_relaxed);
+    }
+    (void)pushMoved(std::move(value));
+}
+
+void MpmcQueue::print() const
+{
+    printValues(size(), [this](auto&& visit) { forEach(visit); });
+}
+
+void MpmcQueue::serializeText(std::ostream& outputStream) const
+{
+    writeText(outputStream, [this](auto&& visit) { forEach(visit); });
+}
+
+void MpmcQueue::deserializeText(std::istream& inputStream)
+{
+    reset(capacity());
+    readText(inputStream, [this](std::string&& value) { appendLoaded(std::move(value)); });
+}
+
+std::string MpmcQueue::serialize() const
+{
+    std::ostringstream output;
+    serializeText(output);
+    return output.str();
+}
+
+void MpmcQueue::deserialize(const std::string& text)
+{
+    std::istringstream input(text);
+    deserializeText(input);
+}
+
+void MpmcQueue::serializeBinary(std::ostream& outputStream) const
+{
+    writeBinary(outputStream, size(), [this](auto&& visit) { forEach(visit); },
+                "MpmcQueue::serializeBinary: ERROR");
+}
+
+void MpmcQueue::deserializeBinary(std::istream& inputStream)
+{
+    reset(capacity());
+    readBinary(inputStream, [this](std::string&& value) { appendLoaded(std::move(value)); },
+               "MpmcQueue::deserializeBinary: ERROR");
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//  Ограниченные очереди без блокировок для обмена между потоками
+//
+//  SpscQueue — один производитель и один потребитель: кольцо строк и два
+//  счётчика, каждый пишет только свой поток. MpmcQueue — любое число
+//  производителей и потребителей: слоты с номером поколения (схема Вьюкова),
+//  позиции захватываются CAS. Вместимость округляется вверх до степени
+//  двойки. tryPush/tryPop/pop/push безопасны из своих потоков; size — оценка.
+//  print, memoryUsage и сериализация — только когда другие потоки не
+//  работают с очередью. Форматы сериализации — как у Queue; загрузка
+//  при нехватке места увеличивает вместимость.
+
+class SpscQueue
+{
+public:
+    static constexpr std::size_t kDefaultCapacity = 1024;
+
+    explicit SpscQueue(std::size_t capacity = kDefaultCapacity);
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    SpscQueue(SpscQueue&&) = delete;
+    SpscQueue& operator=(SpscQueue&&) = delete;
+
+    // поток производителя
+    [[nodiscard]] bool tryPush(const std::string& value);   // false, если полна
+    [[nodiscard]] bool tryPush(std::string&& value);
+    void push(const std::string& value);                    // std::overflow_error, если полна
+
+    // поток потребителя
+    [[nodiscard]] bool tryPop(std::string& out);            // false, если пуста
+    std::string pop();                                      // std::out_of_range, если пуста
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    void print() const;
+
+    // текстовая сериализация
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& text);
+
+    void serializeText(std::ostream& outputStream) const;
+    void deserializeText(std::istream& inputStream);
+
+    // бинарная сериализация
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+private:
+    // позиции растут монотонно, слот — позиция & mask
+    std::vector<std::string> slots;
+    std::size_t mask{0};
+
+    alignas(64) std::atomic<std::size_t> head{0};   // пишет потребитель
+    std::size_t cachedTail{0};                      // копия tail у потребителя
+    alignas(64) std::atomic<std::size_t> tail{0};   // пишет производитель
+    std::size_t cachedHead{0};                      // копия head у производителя
+
+    template <class Value>
+    bool pushImpl(Value&& value);
+    void reset(std::size_t capacity);
+    void appendLoaded(std::string&& value);   // загрузка: растёт при нехватке
+
+    template <class Visit>
+    void forEach(Visit&& visit) const;
+};
+
+
+class MpmcQueue
+{
+public:
+    static constexpr std::size_t kDefaultCapacity = 1024;
+
+    explicit MpmcQueue(std::size_t capacity = kDefaultCapacity);
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    MpmcQueue(MpmcQueue&&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+    [[nodiscard]] bool tryPush(const std::string& value);   // false, если полна
+    [[nodiscard]] bool tryPush(std::string&& value);
+    void push(const std::string& value);                    // std::overflow_error, если полна
+
+    [[nodiscard]] bool tryPop(std::string& out);            // false, если пуста
+    std::string pop();                                      // std::out_of_range, если пуста
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    void print() const;
+
+    // текстовая сериализация
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& text);
+
+    void serializeText(std::ostream& outputStream) const;
+    void deserializeText(std::istream& inputStream);
+
+    // бинарная сериализация
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+private:
+    // sequence == позиция: слот свободен для записи с этой позиции;
+    // sequence == позиция + 1: в слоте значение для чтения с этой позиции
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{0};
+        std::string value;
+    };
+
+    std::vector<Slot> slots;
+    std::size_t mask{0};
+
+    alignas(64) std::atomic<std::size_t> enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> dequeuePos{0};
+
+    bool pushMoved(std::string&& value);   // копия снята до захвата слота
+    void reset(std::size_t capacity);
+    void appendLoaded(std::string&& value);
+
+    template <class Visit>
+    void forEach(Visit&& visit) const;
+};
@@ -1,9 +1,11 @@
 #include "forward_list.h"
+#include "memory_usage.h"
 
 #include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 //  базовые операции 
 
@@ -16,33 +18,125 @@ ForwardList::~ForwardList()
 
 void ForwardList::clear() noexcept
 {
+    valueIndex.clear();
     while (head != nullptr) {
         FNode* node = head;
         head = head->next;
         delete node;
     }
+    tail = nullptr;
+    count = 0;
 }
 
-void ForwardList::pushFront(const std::string& value)
+ForwardList::Chain::~Chain()
 {
-    FNode* node = new FNode(value);
-    node->next = head;
-    head = node;
+    while (head != nullptr) {
+        FNode* node = head;
+        head = head->next;
+        delete node;
+    }
 }
 
-void ForwardList::pushBack(const std::string& value)
+void ForwardList::Chain::append(std::string value)
 {
-    FNode* node = new FNode(value);
-    if (head == nullptr) {
+    FNode* node = new FNode(std::move(value));
+    if (tail == nullptr) {
         head = node;
-        return;
+    } else {
+        tail->next = node;
+    }
+    tail = node;
+    ++count;
+}
+
+void ForwardList::adopt(Chain& chain)
+{
+    // индекс новой цепочки строится до замены: при ошибке список прежний
+    ValueIndex<FNode> index;
+    if (valueIndex.active()) {
+        index.activate();
+        for (FNode* node = chain.head; node != nullptr; node = node->next) {
+            index.add(node);
+        }
+    }
+
+    clear();
+    head = std::exchange(chain.head, nullptr);
+    tail = std::exchange(chain.tail, nullptr);
+    count = std::exchange(chain.count, 0);
+    valueIndex.swap(index);
+}
+
+FNode* ForwardList::makeNode(const std::string& value)
+{
+    FNode* node = new FNode(value);
+    if (valueIndex.active()) {
+        try {
+            valueIndex.add(node);
+        } catch (...) {
+            delete node;
+            throw;
+        }
+    }
+    ++count;
+    return node;
+}
+
+void ForwardList::destroyNode(FNode* node) noexcept
+{
+    if (node == tail) {
+        tail = nullptr;   // новый хвост выставляет вызывающий
+    }
+    if (valueIndex.active()) {
+        valueIndex.remove(node);
+    }
+    delete node;
+    --count;
+}
+
+FNode* ForwardList::firstWithValue(const std::string& value) const noexcept
+{
+    if (valueIndex.active()) {
+        const auto* entry = valueIndex.find(value);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if (entry->unique()) {
+            return entry->first;
+        }
     }
 
     FNode* current = head;
-    while (current->next != nullptr) {
+    while (current != nullptr && current->value != value) {
         current = current->next;
     }
-    current->next = node;
+    return current;
+}
+
+bool ForwardList::mayContain(const std::string& value) const noexcept
+{
+    return !valueIndex.active() || valueIndex.find(value) != nullptr;
+}
+
+void ForwardList::pushFront(const std::string& value)
+{
+    FNode* node = makeNode(value);
+    node->next = head;
+    head = node;
+    if (tail == nullptr) {
+        tail = node;
+    }
+}
+
+void ForwardList::pushBack(const std::string& value)
+{
+    FNode* node = makeNode(value);
+    if (tail == nullptr) {
+        head = node;
+    } else {
+        tail->next = node;
+    }
+    tail = node;
 }
 
 void ForwardList::popFront()
@@ -52,7 +146,7 @@ void ForwardList::popFront()
     }
     FNode* node = head;
     head = head->next;
-    delete node;
+    destroyNode(node);
 }
 
 void ForwardList::popBack()
@@ -60,22 +154,36 @@ void ForwardList::popBack()
     if (head == nullptr) {
         return;
     }
-    if (head->next == nullptr) {
-        delete head;
-        head = nullptr;
+    if (head == tail) {
+        popFront();
         return;
     }
 
     FNode* current = head;
-    while (current->next != nullptr && current->next->next != nullptr) {
+    while (current->next != tail) {
         current = current->next;
     }
-    delete current->next;
+    destroyNode(tail);
     current->next = nullptr;
+    tail = current;
+}
+
+std::size_t ForwardList::size() const noexcept
+{
+    return count;
+}
+
+bool ForwardList::empty() const noexcept
+{
+    return count == 0;
 }
 
 void ForwardList::removeByValue(const std::string& value)
 {
+    if (!mayContain(value)) {
+        return;
+    }
+
     // убираем совпадения в начале
     while (head != nullptr && head->value == value) {
         popFront();
@@ -86,7 +194,10 @@ void ForwardList::removeByValue(const std::string& value)
         if (current->next->value == value) {
             FNode* node = current->next;
             current->next = node->next;
-            delete node;
+            destroyNode(node);
+            if (tail == nullptr) {
+                tail = current;
+            }
         } else {
             current = current->next;
         }
@@ -95,33 +206,27 @@ void ForwardList::removeByValue(const std::string& value)
 
 FNode* ForwardList::findNode(const std::string& value) const
 {
-    FNode* current = head;
-    while (current != nullptr) {
-        if (current->value == value) {
-            return current;
-        }
-        current = current->next;
-    }
-    return nullptr;
+    return firstWithValue(value);
 }
 
 void ForwardList::insertAfter(const std::string& afterValue, const std::string& newValue)
 {
-    FNode* current = head;
-    while (current != nullptr) {
-        if (current->value == afterValue) {
-            FNode* node = new FNode(newValue);
-            node->next = current->next;
-            current->next = node;
-            return;
-        }
-        current = current->next;
+    FNode* current = firstWithValue(afterValue);
+    if (current == nullptr) {
+        return;
+    }
+
+    FNode* node = makeNode(newValue);
+    node->next = current->next;
+    current->next = node;
+    if (current == tail) {
+        tail = node;
     }
 }
 
 void ForwardList::insertBefore(const std::string& beforeValue, const std::string& newValue)
 {
-    if (head == nullptr) {
+    if (head == nullptr || !mayContain(beforeValue)) {
         return;
     }
     if (head->value == beforeValue) {
@@ -133,7 +238,7 @@ void ForwardList::insertBefore(const std::string& beforeValue, const std::string
     FNode* current = head->next;
     while (current != nullptr) {
         if (current->value == beforeValue) {
-            FNode* node = new FNode(newValue);
+            FNode* node = makeNode(newValue);
             previous->next = node;
             node->next = current;
             return;
@@ -145,21 +250,22 @@ void ForwardList::insertBefore(const std::string& beforeValue, const std::string
 
 void ForwardList::removeAfter(const std::string& afterValue)
 {
-    FNode* current = head;
-    while (current != nullptr && current->next != nullptr) {
-        if (current->value == afterValue) {
-            FNode* node = current->next;
-            current->next = node->next;
-            delete node;
-            return;
-        }
-        current = current->next;
+    FNode* current = firstWithValue(afterValue);
+    if (current == nullptr || current->next == nullptr) {
+        return;
+    }
+
+    FNode* node = current->next;
+    current->next = node->next;
+    destroyNode(node);
+    if (tail == nullptr) {
+        tail = current;
     }
 }
 
 void ForwardList::removeBefore(const std::string& beforeValue)
 {
-    if (head == nullptr || head->next == nullptr) {
+    if (head == nullptr || head->next == nullptr || !mayContain(beforeValue)) {
         return;
     }
     if (head->next->value == beforeValue) {
@@ -172,9 +278,8 @@ void ForwardList::removeBefore(const std::string& beforeValue)
     FNode* current = prev->next;
     while (current != nullptr) {
         if (current->value == beforeValue) {
-            FNode* node = prev;
             prevPrev->next = current;
-            delete node;
+            destroyNode(prev);
             return;
         }
         prevPrev = prev;
@@ -183,6 +288,128 @@ void ForwardList::removeBefore(const std::string& beforeValue)
     }
 }
 
+//  перенос узлов 
+
+void ForwardList::indexIncoming(FNode* first)
+{
+    if (!valueIndex.active()) {
+        return;
+    }
+    // при ошибке добавленные убираются: списки остаются прежними
+    FNode* node = first;
+    try {
+        for (; node != nullptr; node = node->next) {
+            valueIndex.add(node);
+        }
+    } catch (...) {
+        for (FNode* added = first; added != node; added = added->next) {
+            valueIndex.remove(added);
+        }
+        throw;
+    }
+}
+
+void ForwardList::linkAfter(FNode* position, FNode* first, FNode* last, std::size_t moved) noexcept
+{
+    if (position == nullptr) {
+        last->next = head;
+        head = first;
+    } else {
+        last->next = position->next;
+        position->next = first;
+    }
+    if (last->next == nullptr) {
+        tail = last;
+    }
+    count += moved;
+}
+
+void ForwardList::spliceAfter(FNode* position, ForwardList& other)
+{
+    if (&other == this || other.head == nullptr) {
+        return;
+    }
+
+    indexIncoming(other.head);
+    other.valueIndex.clear();   // ушли все узлы other
+    FNode* first = std::exchange(other.head, nullptr);
+    FNode* last = std::exchange(other.tail, nullptr);
+    linkAfter(position, first, last, std::exchange(other.count, 0));
+}
+
+void ForwardList::concat(ForwardList& other)
+{
+    spliceAfter(tail, other);
+}
+
+void ForwardList::splitAt(std::size_t index, ForwardList& rest)
+{
+    if (&rest == this || index >= count) {
+        return;
+    }
+
+    FNode* previous = nullptr;
+    FNode* first = head;
+    for (std::size_t i = 0; i < index; ++i) {
+        previous = first;
+        first = first->next;
+    }
+
+    rest.indexIncoming(first);
+    if (valueIndex.active()) {
+        for (FNode* node = first; node != nullptr; node = node->next) {
+            valueIndex.remove(node);
+        }
+    }
+
+    FNode* last = tail;
+    if (previous != nullptr) {
+        previous->next = nullptr;
+    } else {
+        head = nullptr;
+    }
+    tail = previous;
+    const std::size_t moved = count - index;
+    count = index;
+    rest.linkAfter(rest.tail, first, last, moved);
+}
+
+void ForwardList::enableValueIndex()
+{
+    if (valueIndex.active()) {
+        return;
+    }
+    valueIndex.activate();
+    try {
+        for (FNode* current = head; current != nullptr; current = current->next) {
+            valueIndex.add(current);
+        }
+    } catch (...) {
+        valueIndex.disable();
+        throw;
+    }
+}
+
+void ForwardList::disableValueIndex() noexcept
+{
+    valueIndex.disable();
+}
+
+bool ForwardList::hasValueIndex() const noexcept
+{
+    return valueIndex.active();
+}
+
+std::size_t ForwardList::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(ForwardList) + valueIndex.memoryUsage();
+    for (FNode* current = head; current != nullptr; current = current->next) {
+        total += memory_usage::heapBlock(sizeof(FNode));
+        total += memory_usage::stringHeap(current->value);
+    }
+    return total;
+}
+
 void ForwardList::print() const
 {
     FNode* current = head;
@@ -210,14 +437,15 @@ void ForwardList::serializeText(std::ostream& outputStream) const
 
 void ForwardList::deserializeText(std::istream& inputStream)
 {
-    clear();
-
+    // узлы собираются в отдельную цепочку с хвостом: загрузка за O(n)
+    Chain chain;
     std::string line;
     while (std::getline(inputStream, line)) {
         if (!line.empty()) {
-            pushBack(line);
+            chain.append(std::move(line));
         }
     }
+    adopt(chain);
 }
 
 std::string ForwardList::serialize() const
@@ -237,17 +465,10 @@ void ForwardList::deserialize(const std::string& text)
 
 void ForwardList::serializeBinary(std::ostream& outputStream) const
 {
-    // сначала считаем количество элементов
-    std::uint64_t count = 0;
-    FNode* current = head;
-    while (current != nullptr) {
-        ++count;
-        current = current->next;
-    }
-
-    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    const std::uint64_t total = static_cast<std::uint64_t>(count);
+    outputStream.write(reinterpret_cast<const char*>(&total), sizeof(total));
 
-    current = head;
+    FNode* current = head;
     while (current != nullptr) {
         std::uint64_t length =
             static_cast<std::uint64_t>(current->value.size());
@@ -265,16 +486,16 @@ void ForwardList::serializeBinary(std::ostream& outputStream) const
 
 void ForwardList::deserializeBinary(std::istream& inputStream)
 {
-    clear();
-
-    std::uint64_t count = 0;
-    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::uint64_t total = 0;
+    inputStream.read(reinterpret_cast<char*>(&total), sizeof(total));
     if (!inputStream) {
         throw std::runtime_error(
             "ForwardList::deserializeBinary: error");
     }
 
-    for (std::uint64_t i = 0; i < count; ++i) {
+    // как в deserializeText: цепочка с хвостом, при ошибке список не меняется
+    Chain chain;
+    for (std::uint64_t i = 0; i < total; ++i) {
         std::uint64_t length = 0;
         inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
         if (!inputStream) {
@@ -292,6 +513,7 @@ void ForwardList::deserializeBinary(std::istream& inputStream)
                     "ForwardList::deserializeBinary: error");
             }
         }
-        pushBack(value);
+        chain.append(std::move(value));
     }
+    adopt(chain);
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "value_index.h"
+
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <utility>
@@ -43,18 +46,43 @@ public:
     ForwardList& operator=(ForwardList&&) = delete;
 
     void pushFront(const std::string& value);
-    void pushBack(const std::string& value);
+    void pushBack(const std::string& value);   // O(1): список помнит хвост
     void popFront();
-    void popBack();
+    void popBack();                            // O(n): предшественник хвоста ищется проходом
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    // замена содержимого значениями [first, last) за один проход; при
+    // исключении список остаётся прежним
+    template <class InputIt>
+    void assign(InputIt first, InputIt last);
     void removeByValue(const std::string& value);
     [[nodiscard]] FNode* findNode(const std::string& value) const;
     void print() const;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
 
     void insertAfter(const std::string& afterValue, const std::string& newValue);
     void insertBefore(const std::string& beforeValue, const std::string& newValue);
     void removeAfter(const std::string& afterValue);
     void removeBefore(const std::string& beforeValue);
 
+    // перенос узлов между списками, как у List: строки не копируются,
+    // other остаётся пустым; без индекса значений — O(1), индекс
+    // принимающего списка дополняется за O(k).
+    // position — узел этого списка (findNode) или nullptr — начало
+    void spliceAfter(FNode* position, ForwardList& other);   // весь other после position
+    void concat(ForwardList& other);                         // весь other в конец
+    // элементы с номера index и дальше — в конец rest, O(index)
+    void splitAt(std::size_t index, ForwardList& rest);
+
+    // хеш-индекс значений: findNode, insertAfter и removeAfter — O(1) в
+    // среднем (повторы значения ищутся проходом). Операциям «перед» и
+    // removeByValue нужен предшественник, поэтому они остаются проходом,
+    // но отсутствующее значение отсекают сразу
+    void enableValueIndex();
+    void disableValueIndex() noexcept;
+    [[nodiscard]] bool hasValueIndex() const noexcept;
+
     //текстовая сериализация
     [[nodiscard]] std::string serialize() const;
     void deserialize(const std::string& text);
@@ -68,6 +96,43 @@ public:
 
 private:
     FNode* head = nullptr;   
+    FNode* tail = nullptr;
+    std::size_t count = 0;
+    ValueIndex<FNode> valueIndex;   // неактивен, пока не вызван enableValueIndex()
+
+    // цепочка узлов, собираемая отдельно от списка: при исключении
+    // деструктор освобождает уже созданные узлы
+    struct Chain
+    {
+        FNode* head = nullptr;
+        FNode* tail = nullptr;
+        std::size_t count = 0;
+
+        Chain() noexcept = default;
+        Chain(const Chain&) = delete;
+        Chain& operator=(const Chain&) = delete;
+        ~Chain();
+
+        void append(std::string value);
+    };
 
     void clear() noexcept;
+    void adopt(Chain& chain);   // цепочка вместо текущих узлов
+
+    FNode* makeNode(const std::string& value);   // новый узел, уже в индексе
+    void destroyNode(FNode* node) noexcept;      // узел уже вынут из списка
+    void indexIncoming(FNode* first);            // узлы от first до конца цепочки — в индекс
+    void linkAfter(FNode* position, FNode* first, FNode* last, std::size_t moved) noexcept;
+    [[nodiscard]] FNode* firstWithValue(const std::string& value) const noexcept;
+    [[nodiscard]] bool mayContain(const std::string& value) const noexcept;
 };
+
+template <class InputIt>
+void ForwardList::assign(InputIt first, InputIt last)
+{
+    Chain chain;
+    for (; first != last; ++first) {
+        chain.append(*first);
+    }
+    adopt(chain);
+}
@@ -1,10 +1,13 @@
 #include "hashtable.h"
+#include "memory_usage.h"
+#include "parallel.h"
 
 #include <cstdint>
 #include <iostream>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 using namespace std;
 // Вспомогательный хеш для строки
@@ -21,6 +24,69 @@ size_t rawHash(const string& keyValue) noexcept
     }
     return hash;
 }
+
+// для открытой адресации: перемешиваем биты, чтобы и остаток от деления
+// (номер ячейки), и старшие биты (тег) распределялись равномерно
+size_t mixedHash(const string& keyValue) noexcept
+{
+    uint64_t hash = static_cast<uint64_t>(rawHash(keyValue));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return static_cast<size_t>(hash);
+}
+
+// параллельная загрузка включается от этого числа записей на поток
+constexpr size_t kBulkMinPerWorker = size_t{1} << 14;
+// предвыделение по непроверенному count из файла ограничено сверху
+constexpr uint64_t kMaxTrustedPresize = uint64_t{1} << 24;
+
+using EntryList = vector<pair<string, string>>;
+
+string readSizedString(istream& inStream, const string& where, const char* what)
+{
+    uint64_t sizeValue = 0;
+    inStream.read(reinterpret_cast<char*>(&sizeValue), sizeof(sizeValue));
+    if (!inStream) {
+        throw runtime_error(where + ": cannot read " + what + " size");
+    }
+
+    string text;
+    text.resize(static_cast<size_t>(sizeValue));
+    if (sizeValue > 0) {
+        inStream.read(text.data(), static_cast<streamsize>(sizeValue));
+        if (!inStream) {
+            throw runtime_error(where + ": cannot read " + what + " data");
+        }
+    }
+    return text;
+}
+
+// формат снапшота: [u64 count] затем count раз [u64 len][key][u64 len][value]
+uint64_t readEntryCount(istream& inStream, const string& where)
+{
+    uint64_t count64 = 0;
+    inStream.read(reinterpret_cast<char*>(&count64), sizeof(count64));
+    if (!inStream) {
+        throw runtime_error(where + ": cannot read count");
+    }
+    return count64;
+}
+
+EntryList readBinaryEntries(istream& inStream, uint64_t count64, const string& where)
+{
+    EntryList entries;
+    // count из файла не проверен — резервируем с ограничением
+    entries.reserve(memory_usage::trustedReserve(count64));
+    for (uint64_t i = 0; i < count64; ++i) {
+        string keyValue = readSizedString(inStream, where, "key");
+        string valueValue = readSizedString(inStream, where, "value");
+        entries.emplace_back(std::move(keyValue), std::move(valueValue));
+    }
+    return entries;
+}
 } 
 
 
@@ -74,6 +140,49 @@ void HashTable::freeBuckets() noexcept // освобождение памяти
 void HashTable::clear() noexcept
 {
     freeBuckets();
+    bloomFilter.clearBits();
+}
+
+//  фильтр Блума
+
+void HashTable::enableBloomFilter()
+{
+    rebuildBloomFilter();
+}
+
+void HashTable::disableBloomFilter() noexcept
+{
+    bloomFilter.disable();
+}
+
+bool HashTable::hasBloomFilter() const noexcept
+{
+    return bloomFilter.active();
+}
+
+void HashTable::rebuildBloomFilter()
+{
+    // запас вдвое: следующая перестройка — после size() новых вставок
+    bloomFilter.reset(elementCount * 2);
+    for (size_t i = 0; i < bucketCountValue; ++i) {
+        for (Node* current = bucketArray[i]; current != nullptr; current = current->getNext()) {
+            bloomFilter.add(current->getKey());
+        }
+    }
+}
+
+void HashTable::noteInsertedKey(const string& keyValue)
+{
+    if (!bloomFilter.active()) {
+        return;
+    }
+    // удалённые ключи остаются в битах; насыщение по числу вставок
+    // заодно ограничивает и их долю
+    if (bloomFilter.saturated()) {
+        rebuildBloomFilter();
+    } else {
+        bloomFilter.add(keyValue);
+    }
 }
 
 size_t HashTable::hashString(const string& keyValue) const noexcept
@@ -142,6 +251,7 @@ HashTable::HashTable(const HashTable& other)
             current = current->getNext();
         }
     }
+    bloomFilter = other.bloomFilter;
 }
 
 HashTable::HashTable(HashTable&& other) noexcept
@@ -152,6 +262,7 @@ HashTable::HashTable(HashTable&& other) noexcept
     other.bucketArray = nullptr;
     other.bucketCountValue = 0;
     other.elementCount = 0;
+    bloomFilter.swap(other.bloomFilter);
 }
 
 HashTable& HashTable::operator=(const HashTable& other)
@@ -162,6 +273,7 @@ HashTable& HashTable::operator=(const HashTable& other)
 
     clear();
     delete[] bucketArray;
+    bloomFilter.disable();
 
     bucketCountValue = other.bucketCountValue;
     elementCount = 0;
@@ -178,6 +290,7 @@ HashTable& HashTable::operator=(const HashTable& other)
             current = current->getNext();
         }
     }
+    bloomFilter = other.bloomFilter;
 
     return *this;
 }
@@ -199,6 +312,9 @@ HashTable& HashTable::operator=(HashTable&& other) noexcept
     other.bucketCountValue = 0;
     other.elementCount = 0;
 
+    bloomFilter.disable();
+    bloomFilter.swap(other.bloomFilter);
+
     return *this;
 }
 
@@ -211,7 +327,8 @@ void HashTable::insert(const string& keyValue, const string& valueValue)
     }
 
     const size_t index = hashString(keyValue);
-    Node* current = bucketArray[index];
+    // фильтр говорит «нет» — ключ новый, цепочку можно не просматривать
+    Node* current = bloomFilter.mayContain(keyValue) ? bucketArray[index] : nullptr;
 
     while (current != nullptr) {
         if (current->getKey() == keyValue) {
@@ -224,6 +341,7 @@ void HashTable::insert(const string& keyValue, const string& valueValue)
     Node* newNode = new Node(keyValue, valueValue, bucketArray[index]);
     bucketArray[index] = newNode;
     ++elementCount;
+    noteInsertedKey(keyValue);
 
     // если load factor > 0.75 — увеличиваем
     if (elementCount * 4 > bucketCountValue * 3) {
@@ -233,7 +351,8 @@ void HashTable::insert(const string& keyValue, const string& valueValue)
 
 void HashTable::erase(const string& keyValue)
 {
-    if (bucketArray == nullptr || bucketCountValue == 0 || elementCount == 0) {
+    if (bucketArray == nullptr || bucketCountValue == 0 || elementCount == 0
+        || !bloomFilter.mayContain(keyValue)) {
         return;
     }
 
@@ -259,7 +378,7 @@ void HashTable::erase(const string& keyValue)
 
 string* HashTable::find(const string& keyValue)
 {
-    if (bucketArray == nullptr || bucketCountValue == 0) {
+    if (bucketArray == nullptr || bucketCountValue == 0 || !bloomFilter.mayContain(keyValue)) {
         return nullptr;
     }
 
@@ -277,7 +396,7 @@ string* HashTable::find(const string& keyValue)
 
 const string* HashTable::find(const string& keyValue) const
 {
-    if (bucketArray == nullptr || bucketCountValue == 0) {
+    if (bucketArray == nullptr || bucketCountValue == 0 || !bloomFilter.mayContain(keyValue)) {
         return nullptr;
     }
 
@@ -321,6 +440,24 @@ size_t HashTable::bucketCount() const noexcept
     return bucketCountValue;
 }
 
+size_t HashTable::memoryUsage() const noexcept
+{
+    size_t total = sizeof(HashTable);
+    if (bucketArray == nullptr) {
+        return total;
+    }
+
+    total += memory_usage::heapBlock(bucketCountValue * sizeof(Node*));
+    for (size_t i = 0; i < bucketCountValue; ++i) {
+        for (Node* current = bucketArray[i]; current != nullptr; current = current->getNext()) {
+            total += memory_usage::heapBlock(sizeof(Node));
+            total += memory_usage::stringHeap(current->getKey());
+            total += memory_usage::stringHeap(current->getValue());
+        }
+    }
+    return total + bloomFilter.memoryUsage();
+}
+
 void HashTable::print() const
 {
     cout << "HashTable(size=" << elementCount
@@ -398,6 +535,10 @@ void HashTable::deserializeText(istream& inStream)
         }
         ++elementCount;
     }
+
+    if (bloomFilter.active()) {
+        rebuildBloomFilter();
+    }
 }
 
 void HashTable::deserialize(const string& textData)
@@ -436,6 +577,10 @@ void HashTable::serializeBinary(ostream& outStream) const
         }
     }
 
+    if (bloomFilter.active()) {
+        bloomFilter.serializeBinary(outStream);
+    }
+
     if (!outStream) {
         throw runtime_error("HashTable::serializeBinary: write error");
     }
@@ -443,48 +588,119 @@ void HashTable::serializeBinary(ostream& outStream) const
 
 void HashTable::deserializeBinary(istream& inStream)
 {
+    const bool wantFilter = bloomFilter.active();
     clear();
+    bloomFilter.disable();   // до загрузки записей поиск не должен его видеть
+
+    const string where = "HashTable::deserializeBinary";
+    const uint64_t count64 = readEntryCount(inStream, where);
+    const unsigned parts = parallel::workerCount(static_cast<size_t>(count64), kBulkMinPerWorker);
+
+    if (parts == 1) {
+        // в один поток выгоднее вставлять сразу при чтении, пока запись в кеше
+        presize(static_cast<size_t>(min(count64, kMaxTrustedPresize)));
+        for (uint64_t i = 0; i < count64; ++i) {
+            string keyValue = readSizedString(inStream, where, "key");
+            string valueValue = readSizedString(inStream, where, "value");
+            insertMoved(std::move(keyValue), std::move(valueValue));
+        }
+    } else {
+        EntryList entries = readBinaryEntries(inStream, count64, where);
+        presize(entries.size());
+        bulkBuild(entries, parts);
+    }
 
-    uint64_t count64 = 0;
-    inStream.read(reinterpret_cast<char*>(&count64), sizeof(count64)); // чтение количества элементов
-    if (!inStream) {
-        throw runtime_error("HashTable::deserializeBinary: cannot read count");
+    // сохранённый фильтр берётся как есть; старый снапшот без хвоста
+    // получает фильтр перестройкой, если он был включён до загрузки
+    if (!bloomFilter.deserializeBinary(inStream) && wantFilter) {
+        rebuildBloomFilter();
     }
+}
 
-    for (uint64_t i = 0; i < count64; ++i) { // перебор элементов
-        uint64_t keySize = 0;
-        inStream.read(reinterpret_cast<char*>(&keySize), sizeof(keySize)); // чтение размера ключа
-        if (!inStream) {
-            throw runtime_error("HashTable::deserializeBinary: cannot read key size");
+void HashTable::presize(size_t expectedCount)
+{
+    // только для пустой таблицы: итоговое число бакетов (load factor <= 0.75)
+    size_t needed = bucketCountValue == 0 ? 8 : bucketCountValue;
+    while (expectedCount * 4 > needed * 3) {
+        needed *= 2;
+    }
+    if (needed != bucketCountValue || bucketArray == nullptr) {
+        Node** newBuckets = new Node*[needed];
+        for (size_t i = 0; i < needed; ++i) {
+            newBuckets[i] = nullptr;
         }
+        delete[] bucketArray;
+        bucketArray = newBuckets;
+        bucketCountValue = needed;
+    }
+}
 
-        string keyValue;
-        keyValue.resize(static_cast<size_t>(keySize)); // выделение места под ключ
-        if (keySize > 0) { // чтение данных ключа
-            inStream.read(keyValue.data(),
-                          static_cast<streamsize>(keySize));
-            if (!inStream) {
-                throw runtime_error("HashTable::deserializeBinary: cannot read key data");
-            }
+void HashTable::insertMoved(string&& keyValue, string&& valueValue)
+{
+    const size_t index = hashString(keyValue);
+    for (Node* current = bucketArray[index]; current != nullptr; current = current->getNext()) {
+        if (current->getKey() == keyValue) {
+            current->getValueRef() = std::move(valueValue);
+            return;
         }
+    }
 
-        uint64_t valSize = 0;
-        inStream.read(reinterpret_cast<char*>(&valSize), sizeof(valSize));
-        if (!inStream) {
-            throw runtime_error("HashTable::deserializeBinary: cannot read value size");
-        }
+    bucketArray[index] = new Node(std::move(keyValue), std::move(valueValue), bucketArray[index]);
+    ++elementCount;
 
-        string valueValue;
-        valueValue.resize(static_cast<size_t>(valSize));
-        if (valSize > 0) {
-            inStream.read(valueValue.data(),
-                          static_cast<streamsize>(valSize));
-            if (!inStream) {
-                throw runtime_error("HashTable::deserializeBinary: cannot read value data");
-            }
+    if (elementCount * 4 > bucketCountValue * 3) {
+        rehash(bucketCountValue * 2);
+    }
+}
+
+void HashTable::bulkBuild(vector<pair<string, string>>& entries, unsigned parts)
+{
+    const size_t total = entries.size();
+
+    // 1) номера бакетов — параллельно по кускам входа
+    vector<size_t> indexes(total);
+    parallel::runParts(parts, [&](unsigned part) {
+        const size_t last = parallel::partBegin(total, parts, part + 1);
+        for (size_t i = parallel::partBegin(total, parts, part); i < last; ++i) {
+            indexes[i] = hashString(entries[i].first);
         }
+    });
+
+    // 2) вставка: каждый поток владеет своим диапазоном бакетов, блокировки не нужны;
+    //    записи обходятся в порядке файла, поэтому повторный ключ перезаписывает значение
+    vector<size_t> added(parts, 0);
+    try {
+        parallel::runParts(parts, [&](unsigned part) {
+            const size_t low = parallel::partBegin(bucketCountValue, parts, part);
+            const size_t high = parallel::partBegin(bucketCountValue, parts, part + 1);
+            for (size_t i = 0; i < total; ++i) {
+                const size_t index = indexes[i];
+                if (index < low || index >= high) {
+                    continue;
+                }
+
+                Node* current = bucketArray[index];
+                while (current != nullptr && current->getKey() != entries[i].first) {
+                    current = current->getNext();
+                }
+                if (current != nullptr) {
+                    current->getValueRef() = std::move(entries[i].second);
+                    continue;
+                }
+
+                bucketArray[index] = new Node(std::move(entries[i].first),
+                                              std::move(entries[i].second),
+                                              bucketArray[index]);
+                ++added[part];
+            }
+        });
+    } catch (...) {
+        freeBuckets();
+        throw;
+    }
 
-        insert(keyValue, valueValue);
+    for (size_t count : added) {
+        elementCount += count;
     }
 }
 
@@ -493,51 +709,92 @@ void HashTable::deserializeBinary(istream& inStream)
 
 
 HashTableOpen::HashTableOpen()
-    : capacityValue(8)
 {
-    tableArray = new Cell[capacityValue];
+    allocateArrays(8);
 }
 
 HashTableOpen::HashTableOpen(size_t initialCapacity)
-    : capacityValue(initialCapacity == 0 ? 1 : initialCapacity)
 {
-    tableArray = new Cell[capacityValue];
+    allocateArrays(initialCapacity == 0 ? 1 : initialCapacity);
 }
 
 HashTableOpen::~HashTableOpen()
 {
-    delete[] tableArray;
-    tableArray    = nullptr;
-    capacityValue = 0;
-    elementCount  = 0;
+    releaseArrays();
+    elementCount = 0;
+    deletedCount = 0;
 }
 
-size_t HashTableOpen::hashString(const string& keyValue) const noexcept
+void HashTableOpen::allocateArrays(size_t newCapacity)
 {
-    if (capacityValue == 0) {
-        return 0;
+    uint8_t* newControl = new uint8_t[newCapacity];
+    string* newKeys = nullptr;
+    string* newValues = nullptr;
+    try {
+        newKeys = new string[newCapacity];
+        newValues = new string[newCapacity];
+    } catch (...) {
+        delete[] newKeys;
+        delete[] newControl;
+        throw;
     }
-    return rawHash(keyValue) % capacityValue;
+    for (size_t i = 0; i < newCapacity; ++i) {
+        newControl[i] = kEmpty;
+    }
+
+    controlArray  = newControl;
+    keyArray      = newKeys;
+    valueArray    = newValues;
+    capacityValue = newCapacity;
+}
+
+void HashTableOpen::releaseArrays() noexcept
+{
+    delete[] controlArray;
+    delete[] keyArray;
+    delete[] valueArray;
+    controlArray  = nullptr;
+    keyArray      = nullptr;
+    valueArray    = nullptr;
+    capacityValue = 0;
+}
+
+uint8_t HashTableOpen::tagOf(size_t hashValue) noexcept
+{
+    // старшие биты хеша не участвуют в выборе ячейки (index = hash % capacity)
+    return static_cast<uint8_t>(kFullBit | ((hashValue >> (sizeof(size_t) * 8 - 7)) & 0x7F));
 }
 
 HashTableOpen::HashTableOpen(const HashTableOpen& other)
-    : capacityValue(other.capacityValue),
-      elementCount(other.elementCount)
+    : elementCount(other.elementCount),
+      deletedCount(other.deletedCount),
+      bloomFilter(other.bloomFilter)
 {
-    tableArray = new Cell[capacityValue];
-    for (size_t i = 0; i < capacityValue; ++i) {
-        tableArray[i] = other.tableArray[i];
+    allocateArrays(other.capacityValue == 0 ? 1 : other.capacityValue);
+    for (size_t i = 0; i < other.capacityValue; ++i) {
+        controlArray[i] = other.controlArray[i];
+        if ((other.controlArray[i] & kFullBit) != 0) {
+            keyArray[i]   = other.keyArray[i];
+            valueArray[i] = other.valueArray[i];
+        }
     }
 }
 
 HashTableOpen::HashTableOpen(HashTableOpen&& other) noexcept
-    : tableArray(other.tableArray),
+    : controlArray(other.controlArray),
+      keyArray(other.keyArray),
+      valueArray(other.valueArray),
       capacityValue(other.capacityValue),
-      elementCount(other.elementCount)
+      elementCount(other.elementCount),
+      deletedCount(other.deletedCount)
 {
-    other.tableArray    = nullptr;
+    other.controlArray  = nullptr;
+    other.keyArray      = nullptr;
+    other.valueArray    = nullptr;
     other.capacityValue = 0;
     other.elementCount  = 0;
+    other.deletedCount  = 0;
+    bloomFilter.swap(other.bloomFilter);
 }
 
 HashTableOpen& HashTableOpen::operator=(const HashTableOpen& other)
@@ -546,16 +803,8 @@ HashTableOpen& HashTableOpen::operator=(const HashTableOpen& other)
         return *this;
     }
 
-    delete[] tableArray;
-
-    capacityValue = other.capacityValue;
-    elementCount  = other.elementCount;
-
-    tableArray = new Cell[capacityValue];
-    for (size_t i = 0; i < capacityValue; ++i) {
-        tableArray[i] = other.tableArray[i];
-    }
-
+    HashTableOpen tmp(other);
+    *this = std::move(tmp);
     return *this;
 }
 
@@ -565,46 +814,74 @@ HashTableOpen& HashTableOpen::operator=(HashTableOpen&& other) noexcept
         return *this;
     }
 
-    delete[] tableArray;
+    releaseArrays();
 
-    tableArray    = other.tableArray;
+    controlArray  = other.controlArray;
+    keyArray      = other.keyArray;
+    valueArray    = other.valueArray;
     capacityValue = other.capacityValue;
     elementCount  = other.elementCount;
+    deletedCount  = other.deletedCount;
 
-    other.tableArray    = nullptr;
+    other.controlArray  = nullptr;
+    other.keyArray      = nullptr;
+    other.valueArray    = nullptr;
     other.capacityValue = 0;
     other.elementCount  = 0;
+    other.deletedCount  = 0;
+
+    bloomFilter.disable();
+    bloomFilter.swap(other.bloomFilter);
 
     return *this;
 }
 
-size_t HashTableOpen::findSlotForInsert(const string& keyValue) const noexcept
+size_t HashTableOpen::findSlotForInsert(const string& keyValue, size_t hashValue) const noexcept
 {
-    size_t index = hashString(keyValue);
-    size_t start = index;
-
-    while (tableArray[index].isOccupied && !tableArray[index].isDeleted
-           && tableArray[index].key != keyValue) {
-        index = (index + 1) % capacityValue;
-        if (index == start) {
-            break;
+    // ячейка с этим ключом, иначе первая удалённая, иначе первая пустая
+    const uint8_t tag = tagOf(hashValue);
+    size_t index = hashValue % capacityValue;
+    size_t firstDeleted = static_cast<size_t>(-1);
+
+    for (size_t step = 0; step < capacityValue; ++step) {
+        const uint8_t control = controlArray[index];
+        if (control == kEmpty) {
+            return firstDeleted != static_cast<size_t>(-1) ? firstDeleted : index;
+        }
+        if (control == kDeleted) {
+            if (firstDeleted == static_cast<size_t>(-1)) {
+                firstDeleted = index;
+            }
+        } else if (control == tag && keyArray[index] == keyValue) {
+            return index;
+        }
+        if (++index == capacityValue) {
+            index = 0;
         }
     }
-    return index;
+    return firstDeleted;
 }
 
 size_t HashTableOpen::findSlotForKey(const string& keyValue) const noexcept
 {
-    size_t index = hashString(keyValue);
-    size_t start = index;
+    if (capacityValue == 0 || !bloomFilter.mayContain(keyValue)) {
+        return static_cast<size_t>(-1);
+    }
 
-    while (tableArray[index].isOccupied) {
-        if (!tableArray[index].isDeleted && tableArray[index].key == keyValue) {
+    const size_t hashValue = mixedHash(keyValue);
+    const uint8_t tag = tagOf(hashValue);
+    size_t index = hashValue % capacityValue;
+
+    for (size_t step = 0; step < capacityValue; ++step) {
+        const uint8_t control = controlArray[index];
+        if (control == kEmpty) {
+            break;
+        }
+        if (control == tag && keyArray[index] == keyValue) {
             return index;
         }
-        index = (index + 1) % capacityValue;
-        if (index == start) {
-            break;
+        if (++index == capacityValue) {
+            index = 0;
         }
     }
     return static_cast<size_t>(-1);
@@ -616,20 +893,45 @@ void HashTableOpen::rehash(size_t newCapacity)
         newCapacity = 1;
     }
 
-    Cell* oldTable      = tableArray;
-    size_t oldCap  = capacityValue;
-
-    tableArray    = new Cell[newCapacity];
-    capacityValue = newCapacity;
-    elementCount  = 0;
+    uint8_t* oldControl = controlArray;
+    string*  oldKeys    = keyArray;
+    string*  oldValues  = valueArray;
+    size_t   oldCap     = capacityValue;
+
+    controlArray = nullptr;
+    keyArray     = nullptr;
+    valueArray   = nullptr;
+    try {
+        allocateArrays(newCapacity);
+    } catch (...) {
+        controlArray  = oldControl;
+        keyArray      = oldKeys;
+        valueArray    = oldValues;
+        capacityValue = oldCap;
+        throw;
+    }
+    deletedCount = 0;
 
+    // ключи уникальны — ищем только пустую ячейку и переносим строки без копирования
     for (size_t i = 0; i < oldCap; ++i) {
-        if (oldTable[i].isOccupied && !oldTable[i].isDeleted) {
-            insert(oldTable[i].key, oldTable[i].value);
+        if ((oldControl[i] & kFullBit) == 0) {
+            continue;
         }
+        const size_t hashValue = mixedHash(oldKeys[i]);
+        size_t index = hashValue % capacityValue;
+        while (controlArray[index] != kEmpty) {
+            if (++index == capacityValue) {
+                index = 0;
+            }
+        }
+        controlArray[index] = tagOf(hashValue);
+        keyArray[index]     = std::move(oldKeys[i]);
+        valueArray[index]   = std::move(oldValues[i]);
     }
 
-    delete[] oldTable;
+    delete[] oldControl;
+    delete[] oldKeys;
+    delete[] oldValues;
 }
 
 void HashTableOpen::insert(const string& keyValue, const string& valueValue)
@@ -640,21 +942,26 @@ void HashTableOpen::insert(const string& keyValue, const string& valueValue)
 
     if (elementCount * 2 >= capacityValue) {
         rehash(capacityValue * 2);
+    } else if ((elementCount + deletedCount) * 2 >= capacityValue) {
+        rehash(capacityValue);   // вычищаем удалённые ячейки
     }
 
-    const size_t index = findSlotForInsert(keyValue);
-    Cell& cell              = tableArray[index];
+    const size_t hashValue = mixedHash(keyValue);
+    const size_t index = findSlotForInsert(keyValue, hashValue);
 
-    if (cell.isOccupied && !cell.isDeleted) {
-        cell.value = valueValue;
+    if ((controlArray[index] & kFullBit) != 0) {
+        valueArray[index] = valueValue;
         return;
     }
 
-    cell.key        = keyValue;
-    cell.value      = valueValue;
-    cell.isOccupied = true;
-    cell.isDeleted  = false;
+    if (controlArray[index] == kDeleted) {
+        --deletedCount;
+    }
+    controlArray[index] = tagOf(hashValue);
+    keyArray[index]     = keyValue;
+    valueArray[index]   = valueValue;
     ++elementCount;
+    noteInsertedKey(keyValue);
 }
 
 void HashTableOpen::erase(const string& keyValue)
@@ -663,9 +970,11 @@ void HashTableOpen::erase(const string& keyValue)
     if (index == static_cast<size_t>(-1)) {
         return;
     }
-    Cell& cell    = tableArray[index];
-    cell.isDeleted = true;
+    controlArray[index] = kDeleted;
+    string().swap(keyArray[index]);     // освобождаем буферы строк сразу
+    string().swap(valueArray[index]);
     --elementCount;
+    ++deletedCount;
 }
 
 string* HashTableOpen::find(const string& keyValue)
@@ -674,7 +983,7 @@ string* HashTableOpen::find(const string& keyValue)
     if (index == static_cast<size_t>(-1)) {
         return nullptr;
     }
-    return &tableArray[index].value;
+    return &valueArray[index];
 }
 
 const string* HashTableOpen::find(const string& keyValue) const
@@ -683,7 +992,7 @@ const string* HashTableOpen::find(const string& keyValue) const
     if (index == static_cast<size_t>(-1)) {
         return nullptr;
     }
-    return &tableArray[index].value;
+    return &valueArray[index];
 }
 
 string& HashTableOpen::operator[](const string& keyValue)
@@ -712,15 +1021,74 @@ size_t HashTableOpen::capacity() const noexcept
     return capacityValue;
 }
 
+size_t HashTableOpen::memoryUsage() const noexcept
+{
+    size_t total = sizeof(HashTableOpen);
+    if (controlArray == nullptr) {
+        return total;
+    }
+
+    // пустые и удалённые ячейки тоже занимают место в трёх массивах
+    total += memory_usage::heapBlock(capacityValue * sizeof(uint8_t));
+    total += 2 * memory_usage::heapBlock(capacityValue * sizeof(string) + memory_usage::kArrayCookie);
+    for (size_t i = 0; i < capacityValue; ++i) {
+        total += memory_usage::stringHeap(keyArray[i]);
+        total += memory_usage::stringHeap(valueArray[i]);
+    }
+    return total + bloomFilter.memoryUsage();
+}
+
 void HashTableOpen::clear() noexcept
 {
     for (size_t i = 0; i < capacityValue; ++i) {
-        tableArray[i].key.clear();
-        tableArray[i].value.clear();
-        tableArray[i].isOccupied = false;
-        tableArray[i].isDeleted  = false;
+        if ((controlArray[i] & kFullBit) != 0) {
+            keyArray[i].clear();
+            valueArray[i].clear();
+        }
+        controlArray[i] = kEmpty;
     }
     elementCount = 0;
+    deletedCount = 0;
+    bloomFilter.clearBits();
+}
+
+//  фильтр Блума
+
+void HashTableOpen::enableBloomFilter()
+{
+    rebuildBloomFilter();
+}
+
+void HashTableOpen::disableBloomFilter() noexcept
+{
+    bloomFilter.disable();
+}
+
+bool HashTableOpen::hasBloomFilter() const noexcept
+{
+    return bloomFilter.active();
+}
+
+void HashTableOpen::rebuildBloomFilter()
+{
+    bloomFilter.reset(elementCount * 2);
+    for (size_t i = 0; i < capacityValue; ++i) {
+        if ((controlArray[i] & kFullBit) != 0) {
+            bloomFilter.add(keyArray[i]);
+        }
+    }
+}
+
+void HashTableOpen::noteInsertedKey(const string& keyValue)
+{
+    if (!bloomFilter.active()) {
+        return;
+    }
+    if (bloomFilter.saturated()) {
+        rebuildBloomFilter();
+    } else {
+        bloomFilter.add(keyValue);
+    }
 }
 
 void HashTableOpen::print() const
@@ -728,14 +1096,13 @@ void HashTableOpen::print() const
     cout << "HashTableOpen(size=" << elementCount
               << ", capacity=" << capacityValue << ")\n";
     for (size_t i = 0; i < capacityValue; ++i) {
-        const Cell& cell = tableArray[i];
         cout << "  [" << i << "]: ";
-        if (!cell.isOccupied) {
+        if (controlArray[i] == kEmpty) {
             cout << "EMPTY";
-        } else if (cell.isDeleted) {
+        } else if (controlArray[i] == kDeleted) {
             cout << "DELETED";
         } else {
-            cout << "(" << cell.key << " -> " << cell.value << ")";
+            cout << "(" << keyArray[i] << " -> " << valueArray[i] << ")";
         }
         cout << "\n";
     }
@@ -747,9 +1114,8 @@ void HashTableOpen::serializeText(ostream& outStream) const
 {
     outStream << elementCount << '\n';
     for (size_t i = 0; i < capacityValue; ++i) {
-        const Cell& cell = tableArray[i];
-        if (cell.isOccupied && !cell.isDeleted) {
-            outStream << cell.key << '\t' << cell.value << '\n';
+        if ((controlArray[i] & kFullBit) != 0) {
+            outStream << keyArray[i] << '\t' << valueArray[i] << '\n';
         }
     }
 }
@@ -800,27 +1166,32 @@ void HashTableOpen::serializeBinary(ostream& outStream) const
     outStream.write(reinterpret_cast<const char*>(&count64), sizeof(count64));
 
     for (size_t i = 0; i < capacityValue; ++i) {
-        const Cell& cell = tableArray[i];
-        if (cell.isOccupied && !cell.isDeleted) {
+        if ((controlArray[i] & kFullBit) != 0) {
+            const string& keyValue = keyArray[i];
+            const string& valueValue = valueArray[i];
             const uint64_t keySize =
-                static_cast<uint64_t>(cell.key.size());
+                static_cast<uint64_t>(keyValue.size());
             const uint64_t valSize =
-                static_cast<uint64_t>(cell.value.size());
+                static_cast<uint64_t>(valueValue.size());
 
             outStream.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
             if (keySize > 0) {
-                outStream.write(cell.key.data(),
+                outStream.write(keyValue.data(),
                                 static_cast<streamsize>(keySize));
             }
 
             outStream.write(reinterpret_cast<const char*>(&valSize), sizeof(valSize));
             if (valSize > 0) {
-                outStream.write(cell.value.data(),
+                outStream.write(valueValue.data(),
                                 static_cast<streamsize>(valSize));
             }
         }
     }
 
+    if (bloomFilter.active()) {
+        bloomFilter.serializeBinary(outStream);
+    }
+
     if (!outStream) {
         throw runtime_error("HashTableOpen::serializeBinary: write error");
     }
@@ -828,47 +1199,140 @@ void HashTableOpen::serializeBinary(ostream& outStream) const
 
 void HashTableOpen::deserializeBinary(istream& inStream)
 {
+    const bool wantFilter = bloomFilter.active();
     clear();
+    bloomFilter.disable();
+
+    const string where = "HashTableOpen::deserializeBinary";
+    const uint64_t count64 = readEntryCount(inStream, where);
+    const unsigned parts = parallel::workerCount(static_cast<size_t>(count64), kBulkMinPerWorker);
+
+    if (parts == 1) {
+        // в один поток выгоднее вставлять сразу при чтении, пока запись в кеше
+        presize(static_cast<size_t>(min(count64, kMaxTrustedPresize)));
+        for (uint64_t i = 0; i < count64; ++i) {
+            string keyValue = readSizedString(inStream, where, "key");
+            string valueValue = readSizedString(inStream, where, "value");
+            insertMoved(std::move(keyValue), std::move(valueValue));
+        }
+    } else {
+        EntryList entries = readBinaryEntries(inStream, count64, where);
+        presize(entries.size());
+        bulkBuild(entries, parts);
+    }
 
-    uint64_t count64 = 0;
-    inStream.read(reinterpret_cast<char*>(&count64), sizeof(count64));
-    if (!inStream) {
-        throw runtime_error("HashTableOpen::deserializeBinary: cannot read count");
+    // см. HashTable::deserializeBinary
+    if (!bloomFilter.deserializeBinary(inStream) && wantFilter) {
+        rebuildBloomFilter();
     }
+}
 
-    for (uint64_t i = 0; i < count64; ++i) {
-        uint64_t keySize = 0;
-        inStream.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
-        if (!inStream) {
-            throw runtime_error("HashTableOpen::deserializeBinary: cannot read key size");
-        }
+void HashTableOpen::presize(size_t expectedCount)
+{
+    // только для пустой таблицы: итоговая ёмкость (заполнение < 50%)
+    size_t needed = capacityValue == 0 ? 8 : capacityValue;
+    while (expectedCount * 2 >= needed) {
+        needed *= 2;
+    }
+    if (needed != capacityValue) {
+        releaseArrays();
+        allocateArrays(needed);
+    }
+    elementCount = 0;
+    deletedCount = 0;
+}
 
-        string keyValue;
-        keyValue.resize(static_cast<size_t>(keySize));
-        if (keySize > 0) {
-            inStream.read(keyValue.data(),
-                          static_cast<streamsize>(keySize));
-            if (!inStream) {
-                throw runtime_error("HashTableOpen::deserializeBinary: cannot read key data");
-            }
-        }
+void HashTableOpen::insertMoved(string&& keyValue, string&& valueValue)
+{
+    if (elementCount * 2 >= capacityValue) {
+        rehash(capacityValue * 2);
+    }
 
-        uint64_t valSize = 0;
-        inStream.read(reinterpret_cast<char*>(&valSize), sizeof(valSize));
-        if (!inStream) {
-            throw runtime_error("HashTableOpen::deserializeBinary: cannot read value size");
+    const size_t hashValue = mixedHash(keyValue);
+    const size_t index = findSlotForInsert(keyValue, hashValue);
+    if ((controlArray[index] & kFullBit) != 0) {
+        valueArray[index] = std::move(valueValue);
+        return;
+    }
+
+    controlArray[index] = tagOf(hashValue);
+    keyArray[index]     = std::move(keyValue);
+    valueArray[index]   = std::move(valueValue);
+    ++elementCount;
+}
+
+void HashTableOpen::bulkBuild(vector<pair<string, string>>& entries, unsigned parts)
+{
+    const size_t total = entries.size();
+
+    // 1) хеши — параллельно по кускам входа
+    vector<size_t> hashes(total);
+    parallel::runParts(parts, [&](unsigned part) {
+        const size_t last = parallel::partBegin(total, parts, part + 1);
+        for (size_t i = parallel::partBegin(total, parts, part); i < last; ++i) {
+            hashes[i] = mixedHash(entries[i].first);
         }
+    });
+
+    // 2) каждый поток владеет диапазоном ячеек [low, high). Запись, чья цепочка
+    //    пробирования выходит за high, откладывается: такие записи вставляются
+    //    последовательно после join. Повтор ключа идёт тем же путём, что и
+    //    первое вхождение, поэтому порядок файла сохраняется.
+    vector<size_t> added(parts, 0);
+    vector<vector<size_t>> overflow(parts);
+    try {
+        parallel::runParts(parts, [&](unsigned part) {
+            const size_t low = parallel::partBegin(capacityValue, parts, part);
+            const size_t high = parallel::partBegin(capacityValue, parts, part + 1);
+            for (size_t i = 0; i < total; ++i) {
+                size_t index = hashes[i] % capacityValue;
+                if (index < low || index >= high) {
+                    continue;
+                }
+
+                const uint8_t tag = tagOf(hashes[i]);
+                for (;;) {
+                    if (index == high) {
+                        overflow[part].push_back(i);
+                        break;
+                    }
+                    const uint8_t control = controlArray[index];
+                    if (control == kEmpty) {
+                        controlArray[index] = tag;
+                        keyArray[index]     = std::move(entries[i].first);
+                        valueArray[index]   = std::move(entries[i].second);
+                        ++added[part];
+                        break;
+                    }
+                    if (control == tag && keyArray[index] == entries[i].first) {
+                        valueArray[index] = std::move(entries[i].second);
+                        break;
+                    }
+                    ++index;
+                }
+            }
+        });
+    } catch (...) {
+        clear();
+        throw;
+    }
 
-        string valueValue;
-        valueValue.resize(static_cast<size_t>(valSize));
-        if (valSize > 0) {
-            inStream.read(valueValue.data(),
-                          static_cast<streamsize>(valSize));
-            if (!inStream) {
-                throw runtime_error("HashTableOpen::deserializeBinary: cannot read value data");
+    for (size_t count : added) {
+        elementCount += count;
+    }
+
+    // 3) отложенные записи — обычным пробированием по всей таблице
+    for (const auto& partOverflow : overflow) {
+        for (size_t i : partOverflow) {
+            const size_t index = findSlotForInsert(entries[i].first, hashes[i]);
+            if ((controlArray[index] & kFullBit) != 0) {
+                valueArray[index] = std::move(entries[i].second);
+                continue;
             }
+            controlArray[index] = tagOf(hashes[i]);
+            keyArray[index]     = std::move(entries[i].first);
+            valueArray[index]   = std::move(entries[i].second);
+            ++elementCount;
         }
-
-        insert(keyValue, valueValue);
     }
-}
\ No newline at end of file
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "bloom_filter.h"
+
 #include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <string>
 #include <utility>
+#include <vector>
 
 
 //  HashTable — цепная хеш-таблица
@@ -59,9 +62,17 @@ private:
     Node** bucketArray{nullptr};
     std::size_t bucketCountValue{0U};
     std::size_t elementCount{0U};
+    BloomFilter bloomFilter;   // неактивен, пока не вызван enableBloomFilter()
 
     void freeBuckets() noexcept;
+    void rebuildBloomFilter();
+    void noteInsertedKey(const std::string& keyValue);
     void rehash(std::size_t newBucketCount);
+    // загрузка снапшота в пустую таблицу: итоговое число бакетов выделяется
+    // сразу, вставка идёт параллельно по непересекающимся диапазонам бакетов
+    void presize(std::size_t expectedCount);
+    void insertMoved(std::string&& keyValue, std::string&& valueValue);
+    void bulkBuild(std::vector<std::pair<std::string, std::string>>& entries, unsigned parts);
     [[nodiscard]] std::size_t hashString(const std::string& keyValue) const noexcept;
 
 public:
@@ -84,6 +95,12 @@ public:
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t bucketCount() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // фильтр Блума перед поиском: промах отсекается без обхода цепочки
+    void enableBloomFilter();
+    void disableBloomFilter() noexcept;
+    [[nodiscard]] bool hasBloomFilter() const noexcept;
 
     void clear() noexcept;
     void print() const;
@@ -95,6 +112,7 @@ public:
     void deserialize(const std::string& textData);
 
     //  бинарная сериализация 
+    //  включённый фильтр пишется хвостом после записей (см. BloomFilter)
     void serializeBinary(std::ostream& outStream) const;
     void deserializeBinary(std::istream& inStream);
 };
@@ -107,22 +125,34 @@ public:
 class HashTableOpen
 {
 private:
-    struct Cell
-    {
-        std::string key;
-        std::string value;
-        bool isOccupied{false};
-        bool isDeleted{false};
-    };
-
-    Cell* tableArray{nullptr};
+    // Раскладка «структура массивов»: пробирование читает только байты
+    // controlArray (64 ячейки на кеш-линию), ключ сравнивается лишь при
+    // совпадении 7-битного тега, значения лежат в отдельном массиве.
+    static constexpr std::uint8_t kEmpty   = 0x00;
+    static constexpr std::uint8_t kDeleted = 0x01;
+    static constexpr std::uint8_t kFullBit = 0x80;   // занято: 0x80 | тег
+
+    std::uint8_t* controlArray{nullptr};
+    std::string*  keyArray{nullptr};
+    std::string*  valueArray{nullptr};
     std::size_t capacityValue{0U};
     std::size_t elementCount{0U};
+    std::size_t deletedCount{0U};
+    BloomFilter bloomFilter;
 
-    [[nodiscard]] std::size_t hashString(const std::string& keyValue) const noexcept;
-    [[nodiscard]] std::size_t findSlotForInsert(const std::string& keyValue) const noexcept;
+    [[nodiscard]] static std::uint8_t tagOf(std::size_t hashValue) noexcept;
+    [[nodiscard]] std::size_t findSlotForInsert(const std::string& keyValue,
+                                                std::size_t hashValue) const noexcept;
     [[nodiscard]] std::size_t findSlotForKey(const std::string& keyValue) const noexcept;
+    void allocateArrays(std::size_t newCapacity);
+    void releaseArrays() noexcept;
     void rehash(std::size_t newCapacity);
+    void rebuildBloomFilter();
+    void noteInsertedKey(const std::string& keyValue);
+    // загрузка снапшота в пустую таблицу (см. HashTable::bulkBuild)
+    void presize(std::size_t expectedCount);
+    void insertMoved(std::string&& keyValue, std::string&& valueValue);
+    void bulkBuild(std::vector<std::pair<std::string, std::string>>& entries, unsigned parts);
 
 public:
     HashTableOpen();
@@ -144,6 +174,12 @@ public:
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // фильтр Блума перед пробированием (см. HashTable)
+    void enableBloomFilter();
+    void disableBloomFilter() noexcept;
+    [[nodiscard]] bool hasBloomFilter() const noexcept;
 
     void clear() noexcept;
     void print() const;
@@ -1,9 +1,11 @@
 #include "list.h"
+#include "memory_usage.h"
 
 #include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 // базовые операции
 
@@ -16,6 +18,7 @@ List::~List()
 
 void List::clear() noexcept
 {
+    valueIndex.clear();
     LNode* current = headNode;
     while (current != nullptr) {
         LNode* nodeToDelete = current;
@@ -24,11 +27,67 @@ void List::clear() noexcept
     }
     headNode = nullptr;
     tailNode = nullptr;
+    count    = 0;
 }
 
-void List::pushFront(const std::string& value)
+LNode* List::makeNode(const std::string& value)
 {
     LNode* node = new LNode(value);
+    if (valueIndex.active()) {
+        try {
+            valueIndex.add(node);
+        } catch (...) {
+            delete node;
+            throw;
+        }
+    }
+    ++count;
+    return node;
+}
+
+void List::unlink(LNode* node) noexcept
+{
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        headNode = node->next;
+    }
+
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        tailNode = node->prev;
+    }
+
+    if (valueIndex.active()) {
+        valueIndex.remove(node);
+    }
+    delete node;
+    --count;
+}
+
+LNode* List::firstWithValue(const std::string& value) const noexcept
+{
+    if (valueIndex.active()) {
+        const auto* entry = valueIndex.find(value);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if (entry->unique()) {
+            return entry->first;
+        }
+    }
+
+    LNode* current = headNode;
+    while (current != nullptr && current->value != value) {
+        current = current->next;
+    }
+    return current;
+}
+
+void List::pushFront(const std::string& value)
+{
+    LNode* node = makeNode(value);
     node->next  = headNode;
     node->prev  = nullptr;
 
@@ -44,7 +103,7 @@ void List::pushFront(const std::string& value)
 
 void List::pushBack(const std::string& value)
 {
-    LNode* node = new LNode(value);
+    LNode* node = makeNode(value);
     node->prev  = tailNode;
     node->next  = nullptr;
 
@@ -60,169 +119,253 @@ void List::pushBack(const std::string& value)
 
 void List::popFront()
 {
-    if (headNode == nullptr) {
-        return;
-    }
-
-    LNode* node = headNode;
-    headNode    = headNode->next;
-
     if (headNode != nullptr) {
-        headNode->prev = nullptr;
-    } else {
-        tailNode = nullptr;
+        unlink(headNode);
     }
-
-    delete node;
 }
 
 void List::popBack()
 {
-    if (tailNode == nullptr) {
-        return;
-    }
-
-    LNode* node = tailNode;
-    tailNode    = tailNode->prev;
-
     if (tailNode != nullptr) {
-        tailNode->next = nullptr;
-    } else {
-        headNode = nullptr;
+        unlink(tailNode);
     }
+}
 
-    delete node;
+std::size_t List::size() const noexcept
+{
+    return count;
+}
+
+bool List::empty() const noexcept
+{
+    return count == 0;
 }
 
 void List::removeByValue(const std::string& value)
 {
+    if (valueIndex.active()) {
+        // все узлы значения известны индексу: удаление без прохода
+        while (const auto* entry = valueIndex.find(value)) {
+            unlink(entry->first);
+        }
+        return;
+    }
+
     LNode* current = headNode;
     while (current != nullptr) {
+        LNode* next = current->next;
         if (current->value == value) {
-            LNode* nodeToDelete = current;
-
-            if (current->prev != nullptr) {
-                current->prev->next = current->next;
-            } else {
-                headNode = current->next;
-            }
-
-            if (current->next != nullptr) {
-                current->next->prev = current->prev;
-            } else {
-                tailNode = current->prev;
-            }
-
-            current = current->next;
-            delete nodeToDelete;
-        } else {
-            current = current->next;
+            unlink(current);
         }
+        current = next;
     }
 }
 
 LNode* List::findNode(const std::string& value)
 {
-    LNode* current = headNode;
-    while (current != nullptr) {
-        if (current->value == value) {
-            return current;
-        }
-        current = current->next;
-    }
-    return nullptr;
+    return firstWithValue(value);
 }
 
 void List::insertAfter(const std::string& afterValue, const std::string& newValue)
 {
-    LNode* current = headNode;
-    while (current != nullptr) {
-        if (current->value == afterValue) {
-            LNode* node = new LNode(newValue);
-            node->prev  = current;
-            node->next  = current->next;
+    LNode* current = firstWithValue(afterValue);
+    if (current == nullptr) {
+        return;
+    }
 
-            if (current->next != nullptr) {
-                current->next->prev = node;
-            }
-            current->next = node;
+    LNode* node = makeNode(newValue);
+    node->prev  = current;
+    node->next  = current->next;
 
-            if (current == tailNode) {
-                tailNode = node;
-            }
-            return;
-        }
-        current = current->next;
+    if (current->next != nullptr) {
+        current->next->prev = node;
+    }
+    current->next = node;
+
+    if (current == tailNode) {
+        tailNode = node;
     }
 }
 
 void List::insertBefore(const std::string& beforeValue, const std::string& newValue)
 {
-    LNode* current = headNode;
-    while (current != nullptr) {
-        if (current->value == beforeValue) {
-            LNode* node = new LNode(newValue);
-            node->next  = current;
-            node->prev  = current->prev;
+    LNode* current = firstWithValue(beforeValue);
+    if (current == nullptr) {
+        return;
+    }
 
-            if (current->prev != nullptr) {
-                current->prev->next = node;
-            }
-            current->prev = node;
+    LNode* node = makeNode(newValue);
+    node->next  = current;
+    node->prev  = current->prev;
 
-            if (current == headNode) {
-                headNode = node;
-            }
-            return;
-        }
-        current = current->next;
+    if (current->prev != nullptr) {
+        current->prev->next = node;
+    }
+    current->prev = node;
+
+    if (current == headNode) {
+        headNode = node;
     }
 }
 
 void List::removeAfter(const std::string& afterValue)
 {
-    LNode* current = headNode;
-    while (current != nullptr && current->next != nullptr) {
-        if (current->value == afterValue) {
-            LNode* nodeToDelete = current->next;
-            current->next       = nodeToDelete->next;
-
-            if (nodeToDelete->next != nullptr) {
-                nodeToDelete->next->prev = current;
-            }
-            if (nodeToDelete == tailNode) {
-                tailNode = current;
-            }
+    LNode* current = firstWithValue(afterValue);
+    if (current != nullptr && current->next != nullptr) {
+        unlink(current->next);
+    }
+}
 
-            delete nodeToDelete;
+void List::removeBefore(const std::string& beforeValue)
+{
+    // первое вхождение, у которого есть предшественник: если первое —
+    // голова, подходит следующее вхождение
+    LNode* current = firstWithValue(beforeValue);
+    if (current == headNode && current != nullptr) {
+        if (valueIndex.active() && valueIndex.find(beforeValue)->unique()) {
             return;
         }
         current = current->next;
+        while (current != nullptr && current->value != beforeValue) {
+            current = current->next;
+        }
+    }
+    if (current != nullptr) {
+        unlink(current->prev);
     }
 }
 
-void List::removeBefore(const std::string& beforeValue)
+// перенос узлов
+
+void List::indexIncoming(LNode* first)
 {
-    LNode* current = headNode;
-    while (current != nullptr) {
-        if (current->value == beforeValue && current->prev != nullptr) {
-            LNode* nodeToDelete = current->prev;
-            current->prev       = nodeToDelete->prev;
+    if (!valueIndex.active()) {
+        return;
+    }
+    // при ошибке добавленные убираются: списки остаются прежними
+    LNode* node = first;
+    try {
+        for (; node != nullptr; node = node->next) {
+            valueIndex.add(node);
+        }
+    } catch (...) {
+        for (LNode* added = first; added != node; added = added->next) {
+            valueIndex.remove(added);
+        }
+        throw;
+    }
+}
 
-            if (nodeToDelete->prev != nullptr) {
-                nodeToDelete->prev->next = current;
-            }
-            if (nodeToDelete == headNode) {
-                headNode = current;
-            }
+void List::link(LNode* position, LNode* first, LNode* last, std::size_t moved) noexcept
+{
+    LNode* before = position != nullptr ? position->prev : tailNode;
+    first->prev = before;
+    last->next  = position;
+    if (before != nullptr) {
+        before->next = first;
+    } else {
+        headNode = first;
+    }
+    if (position != nullptr) {
+        position->prev = last;
+    } else {
+        tailNode = last;
+    }
+    count += moved;
+}
 
-            delete nodeToDelete;
-            return;
+void List::splice(LNode* position, List& other)
+{
+    if (&other == this || other.headNode == nullptr) {
+        return;
+    }
+
+    indexIncoming(other.headNode);
+    other.valueIndex.clear();   // ушли все узлы other
+    LNode* first = std::exchange(other.headNode, nullptr);
+    LNode* last  = std::exchange(other.tailNode, nullptr);
+    link(position, first, last, std::exchange(other.count, 0));
+}
+
+void List::concat(List& other)
+{
+    splice(nullptr, other);
+}
+
+void List::splitAt(std::size_t index, List& rest)
+{
+    if (&rest == this || index >= count) {
+        return;
+    }
+
+    LNode* first = nullptr;
+    if (index <= count / 2) {
+        first = headNode;
+        for (std::size_t i = 0; i < index; ++i) {
+            first = first->next;
         }
-        current = current->next;
+    } else {
+        first = tailNode;
+        for (std::size_t i = count - 1; i > index; --i) {
+            first = first->prev;
+        }
+    }
+
+    rest.indexIncoming(first);
+    if (valueIndex.active()) {
+        for (LNode* node = first; node != nullptr; node = node->next) {
+            valueIndex.remove(node);
+        }
+    }
+
+    LNode* last = tailNode;
+    tailNode    = first->prev;
+    if (tailNode != nullptr) {
+        tailNode->next = nullptr;
+    } else {
+        headNode = nullptr;
+    }
+    const std::size_t moved = count - index;
+    count = index;
+    rest.link(nullptr, first, last, moved);
+}
+
+void List::enableValueIndex()
+{
+    if (valueIndex.active()) {
+        return;
+    }
+    valueIndex.activate();
+    try {
+        for (LNode* current = headNode; current != nullptr; current = current->next) {
+            valueIndex.add(current);
+        }
+    } catch (...) {
+        valueIndex.disable();
+        throw;
     }
 }
 
+void List::disableValueIndex() noexcept
+{
+    valueIndex.disable();
+}
+
+bool List::hasValueIndex() const noexcept
+{
+    return valueIndex.active();
+}
+
+std::size_t List::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(List) + valueIndex.memoryUsage();
+    for (LNode* current = headNode; current != nullptr; current = current->next) {
+        total += memory_usage::heapBlock(sizeof(LNode));
+        total += memory_usage::stringHeap(current->value);
+    }
+    return total;
+}
+
 void List::print() const
 {
     LNode* current = headNode;
@@ -277,16 +420,10 @@ void List::deserialize(const std::string& text)
 
 void List::serializeBinary(std::ostream& outputStream) const
 {
-    std::uint64_t count = 0;
-    LNode* current      = headNode;
-    while (current != nullptr) {
-        ++count;
-        current = current->next;
-    }
+    const std::uint64_t total = static_cast<std::uint64_t>(count);
+    outputStream.write(reinterpret_cast<const char*>(&total), sizeof(total));
 
-    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
-
-    current = headNode;
+    LNode* current = headNode;
     while (current != nullptr) {
         std::uint64_t length =
             static_cast<std::uint64_t>(current->value.size());
@@ -308,14 +445,14 @@ void List::deserializeBinary(std::istream& inputStream)
 {
     clear();
 
-    std::uint64_t count = 0;
-    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::uint64_t total = 0;
+    inputStream.read(reinterpret_cast<char*>(&total), sizeof(total));
     if (!inputStream) {
         throw std::runtime_error(
             "List::deserializeBinary: ERROR");
     }
 
-    for (std::uint64_t i = 0; i < count; ++i) {
+    for (std::uint64_t i = 0; i < total; ++i) {
         std::uint64_t length = 0;
         inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
         if (!inputStream) {
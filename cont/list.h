@@ -1,5 +1,8 @@
 #pragma once
 
+#include "value_index.h"
+
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <utility>
@@ -52,6 +55,8 @@ public:
     void pushBack(const std::string& value);
     void popFront();
     void popBack();
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
     void removeByValue(const std::string& value);
     [[nodiscard]] LNode* findNode(const std::string& value);
     void insertAfter(const std::string& afterValue, const std::string& newValue);
@@ -59,6 +64,23 @@ public:
     void removeAfter(const std::string& afterValue);
     void removeBefore(const std::string& beforeValue);
     void print() const;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // перенос узлов между списками: строки не копируются, узлы не
+    // пересоздаются, other остаётся пустым. Без индекса значений —
+    // O(1); индекс принимающего списка дополняется за O(k).
+    // position — узел этого списка (findNode) или nullptr — конец
+    void splice(LNode* position, List& other);   // весь other перед position
+    void concat(List& other);                    // весь other в конец
+    // элементы с номера index и дальше — в конец rest; узел ищется с
+    // ближнего конца, O(min(index, size - index))
+    void splitAt(std::size_t index, List& rest);
+
+    // хеш-индекс значений: findNode и операции по значению — O(1) в среднем
+    // (для повторяющегося значения первое вхождение ищется проходом)
+    void enableValueIndex();
+    void disableValueIndex() noexcept;
+    [[nodiscard]] bool hasValueIndex() const noexcept;
 
     // текстовая сериализация
     [[nodiscard]] std::string serialize() const;
@@ -74,6 +96,14 @@ public:
 private:
     LNode* headNode{nullptr};
     LNode* tailNode{nullptr};
+    std::size_t count{0};
+    ValueIndex<LNode> valueIndex;   // неактивен, пока не вызван enableValueIndex()
 
     void clear() noexcept;
+
+    LNode* makeNode(const std::string& value);       // новый узел, уже в индексе
+    void unlink(LNode* node) noexcept;               // вынуть из списка и удалить
+    void indexIncoming(LNode* first);                // узлы от first до конца цепочки — в индекс
+    void link(LNode* position, LNode* first, LNode* last, std::size_t moved) noexcept;
+    [[nodiscard]] LNode* firstWithValue(const std::string& value) const noexcept;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//  Оценка занимаемой памяти
+//
+//  Модель блока кучи повторяет glibc malloc на 64-битной платформе:
+//  8 байт служебного заголовка, выравнивание по 16 байт, минимум 32 байта.
+//  Эти функции используют memoryUsage() всех контейнеров.
+
+namespace memory_usage
+{
+
+// заявленному в снапшоте числу элементов верим при резерве только в этих
+// пределах: испорченный счётчик не должен вести к огромной аллокации
+constexpr std::uint64_t kMaxTrustedReserve = std::uint64_t{1} << 20;
+
+// резерв под declared элементов из файла; сверх него контейнер растёт сам
+constexpr std::size_t trustedReserve(std::uint64_t declared) noexcept
+{
+    return static_cast<std::size_t>(declared < kMaxTrustedReserve ? declared : kMaxTrustedReserve);
+}
+
+// служебное слово перед массивом из new T[n] с нетривиальным деструктором
+constexpr std::size_t kArrayCookie = sizeof(std::size_t);
+
+// сколько байт кучи реально занимает запрос на requested байт
+constexpr std::size_t heapBlock(std::size_t requested) noexcept
+{
+    const std::size_t block = (requested + 8U + 15U) & ~static_cast<std::size_t>(15U);
+    return block < 32U ? 32U : block;
+}
+
+// динамический буфер строки (0, если строка помещается в SSO-буфер)
+inline std::size_t stringHeap(const std::string& text) noexcept
+{
+    const char* objectBegin = reinterpret_cast<const char*>(&text);
+    const char* objectEnd   = objectBegin + sizeof(std::string);
+    if (text.data() >= objectBegin && text.data() < objectEnd) {
+        return 0U;
+    }
+    return heapBlock(text.capacity() + 1U);
+}
+
+} // namespace memory_usage
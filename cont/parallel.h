@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+//  Простое распараллеливание по частям
+//
+//  runParts(parts, fn) вызывает fn(part) для part = 0..parts-1: последнюю
+//  часть выполняет вызывающий поток, остальные — отдельные std::thread.
+//  Первое исключение из любой части пробрасывается после join.
+
+namespace parallel
+{
+
+// 0 — по числу аппаратных потоков; иное значение — жёсткий предел
+// (нужно тестам и для ограничения нагрузки при загрузке снапшотов)
+inline std::atomic<unsigned>& workerLimit() noexcept
+{
+    static std::atomic<unsigned> limit{0};
+    return limit;
+}
+
+inline void setWorkerLimit(unsigned limit) noexcept
+{
+    workerLimit().store(limit, std::memory_order_relaxed);
+}
+
+// сколько частей имеет смысл запускать для work единиц работы
+inline unsigned workerCount(std::size_t work, std::size_t minWorkPerPart) noexcept
+{
+    unsigned limit = workerLimit().load(std::memory_order_relaxed);
+    if (limit == 0) {
+        limit = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const std::size_t byWork = minWorkPerPart == 0 ? work : work / minWorkPerPart;
+    return static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(limit, byWork)));
+}
+
+template <class Function>
+void runParts(unsigned parts, Function&& fn)
+{
+    if (parts <= 1) {
+        fn(0U);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(parts);
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+
+    auto guarded = [&fn, &errors](unsigned part) {
+        try {
+            fn(part);
+        } catch (...) {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    try {
+        for (unsigned part = 0; part + 1 < parts; ++part) {
+            workers.emplace_back(guarded, part);
+        }
+    } catch (...) {
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    guarded(parts - 1);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// границы части part из parts для диапазона [0, total)
+inline std::size_t partBegin(std::size_t total, unsigned parts, unsigned part) noexcept
+{
+    return total / parts * part + std::min<std::size_t>(part, total % parts);
+}
+
+} // namespace parallel
@@ -0,0 +1,537 @@
+#include "persistent_avltree.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+//  узлы и ссылки
+
+PersistentAvlTree::Node::Node(InternedString v, const Node* l, const Node* r) noexcept
+    : value(std::move(v)),
+      left(l),
+      right(r),
+      count(1 + countOf(l) + countOf(r)),
+      height(1 + std::max(heightOf(l), heightOf(r)))
+{
+}
+
+PersistentAvlTree::NodeRef& PersistentAvlTree::NodeRef::operator=(NodeRef&& other) noexcept
+{
+    if (this != &other) {
+        releaseNode(node_);
+        node_ = std::exchange(other.node_, nullptr);
+    }
+    return *this;
+}
+
+PersistentAvlTree::NodeRef::~NodeRef()
+{
+    releaseNode(node_);
+}
+
+PersistentAvlTree::NodeRef PersistentAvlTree::share(const Node* node) noexcept
+{
+    if (node != nullptr) {
+        node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return NodeRef(node);
+}
+
+void PersistentAvlTree::releaseNode(const Node* node) noexcept
+{
+    // последняя ссылка удаляет узел и отпускает детей; в стеке не больше
+    // высоты + 1 узлов, как при префиксном обходе
+    const Node* stack[kMaxHeight + 1];
+    int top = 0;
+    if (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        stack[top++] = node;
+    }
+
+    while (top > 0) {
+        const Node* dead = stack[--top];
+        for (const Node* child : {dead->left, dead->right}) {
+            if (child != nullptr && child->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                stack[top++] = child;
+            }
+        }
+        delete dead;
+    }
+}
+
+int PersistentAvlTree::heightOf(const Node* node) noexcept
+{
+    return node != nullptr ? node->height : 0;
+}
+
+std::size_t PersistentAvlTree::countOf(const Node* node) noexcept
+{
+    return node != nullptr ? node->count : 0U;
+}
+
+PersistentAvlTree::NodeRef PersistentAvlTree::makeNode(InternedString value, NodeRef left, NodeRef right)
+{
+    const Node* node = new Node(std::move(value), left.get(), right.get());
+    left.release();
+    right.release();
+    return NodeRef(node);
+}
+
+PersistentAvlTree::NodeRef PersistentAvlTree::balanced(InternedString value, NodeRef left, NodeRef right)
+{
+    // после одной вставки или удаления высоты расходятся не больше чем на 2;
+    // повороты собирают новые узлы, старые остаются в прежних версиях
+    const int leftHeight = heightOf(left.get());
+    const int rightHeight = heightOf(right.get());
+
+    if (leftHeight > rightHeight + 1) {
+        const Node* l = left.get();
+        if (heightOf(l->left) >= heightOf(l->right)) {
+            // LL
+            NodeRef newRight = makeNode(std::move(value), share(l->right), std::move(right));
+            return makeNode(l->value, share(l->left), std::move(newRight));
+        }
+        // LR
+        const Node* lr = l->right;
+        NodeRef newRight = makeNode(std::move(value), share(lr->right), std::move(right));
+        NodeRef newLeft = makeNode(l->value, share(l->left), share(lr->left));
+        return makeNode(lr->value, std::move(newLeft), std::move(newRight));
+    }
+
+    if (rightHeight > leftHeight + 1) {
+        const Node* r = right.get();
+        if (heightOf(r->right) >= heightOf(r->left)) {
+            // RR
+            NodeRef newLeft = makeNode(std::move(value), std::move(left), share(r->left));
+            return makeNode(r->value, std::move(newLeft), share(r->right));
+        }
+        // RL
+        const Node* rl = r->left;
+        NodeRef newLeft = makeNode(std::move(value), std::move(left), share(rl->left));
+        NodeRef newRight = makeNode(r->value, share(rl->right), share(r->right));
+        return makeNode(rl->value, std::move(newLeft), std::move(newRight));
+    }
+
+    return makeNode(std::move(value), std::move(left), std::move(right));
+}
+
+//  вставка / удаление с копированием пути
+
+PersistentAvlTree::NodeRef PersistentAvlTree::insertInto(const Node* node, std::string_view value)
+{
+    // рекурсия не глубже высоты дерева
+    if (node == nullptr) {
+        return makeNode(InternedString(value), NodeRef(), NodeRef());
+    }
+
+    const int order = value.compare(node->value.view());
+    if (order == 0) {
+        return NodeRef();
+    }
+    if (order < 0) {
+        NodeRef child = insertInto(node->left, value);
+        if (child.get() == nullptr) {
+            return NodeRef();
+        }
+        return balanced(node->value, std::move(child), share(node->right));
+    }
+    NodeRef child = insertInto(node->right, value);
+    if (child.get() == nullptr) {
+        return NodeRef();
+    }
+    return balanced(node->value, share(node->left), std::move(child));
+}
+
+PersistentAvlTree::NodeRef PersistentAvlTree::removeMin(const Node* node, InternedString& minValue)
+{
+    if (node->left == nullptr) {
+        minValue = node->value;
+        return share(node->right);
+    }
+    NodeRef child = removeMin(node->left, minValue);
+    return balanced(node->value, std::move(child), share(node->right));
+}
+
+PersistentAvlTree::NodeRef PersistentAvlTree::removeFrom(const Node* node, std::string_view value)
+{
+    // вызывается, только если value есть в дереве
+    const int order = value.compare(node->value.view());
+    if (order < 0) {
+        NodeRef child = removeFrom(node->left, value);
+        return balanced(node->value, std::move(child), share(node->right));
+    }
+    if (order > 0) {
+        NodeRef child = removeFrom(node->right, value);
+        return balanced(node->value, share(node->left), std::move(child));
+    }
+
+    if (node->left == nullptr) {
+        return share(node->right);
+    }
+    if (node->right == nullptr) {
+        return share(node->left);
+    }
+    // два ребёнка — на место узла встаёт inorder-преемник
+    InternedString successor;
+    NodeRef rest = removeMin(node->right, successor);
+    return balanced(std::move(successor), share(node->left), std::move(rest));
+}
+
+PersistentAvlTree PersistentAvlTree::inserted(const std::string& value) const
+{
+    NodeRef root = insertInto(root_, value);
+    if (root.get() == nullptr) {
+        return *this;
+    }
+    return PersistentAvlTree(std::move(root));
+}
+
+PersistentAvlTree PersistentAvlTree::removed(const std::string& value) const
+{
+    if (!contains(value)) {
+        return *this;
+    }
+    return PersistentAvlTree(removeFrom(root_, value));
+}
+
+void PersistentAvlTree::insert(const std::string& value)
+{
+    inserted(value).swap(*this);
+}
+
+void PersistentAvlTree::remove(const std::string& value)
+{
+    removed(value).swap(*this);
+}
+
+bool PersistentAvlTree::contains(const std::string& value) const noexcept
+{
+    const std::string_view key(value);
+    for (const Node* node = root_; node != nullptr;) {
+        const int order = key.compare(node->value.view());
+        if (order == 0) {
+            return true;
+        }
+        node = order < 0 ? node->left : node->right;
+    }
+    return false;
+}
+
+//  порядковые запросы
+
+PersistentAvlTree::ConstIterator PersistentAvlTree::begin() const noexcept
+{
+    ConstIterator it;
+    it.pushLeftPath(root_);
+    return it;
+}
+
+PersistentAvlTree::ConstIterator PersistentAvlTree::end() const noexcept
+{
+    return ConstIterator{};
+}
+
+PersistentAvlTree::ConstIterator PersistentAvlTree::lowerBound(std::string_view value) const noexcept
+{
+    // в пути остаются узлы, от которых ушли влево: все они >= value
+    ConstIterator it;
+    for (const Node* node = root_; node != nullptr;) {
+        if (value.compare(node->value.view()) <= 0) {
+            it.path[it.depth++] = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    return it;
+}
+
+PersistentAvlTree::ConstIterator PersistentAvlTree::upperBound(std::string_view value) const noexcept
+{
+    ConstIterator it;
+    for (const Node* node = root_; node != nullptr;) {
+        if (value.compare(node->value.view()) < 0) {
+            it.path[it.depth++] = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    return it;
+}
+
+std::size_t PersistentAvlTree::rank(std::string_view value) const noexcept
+{
+    std::size_t less = 0;
+    for (const Node* node = root_; node != nullptr;) {
+        if (value.compare(node->value.view()) <= 0) {
+            node = node->left;
+        } else {
+            less += countOf(node->left) + 1;
+            node = node->right;
+        }
+    }
+    return less;
+}
+
+std::string_view PersistentAvlTree::nth(std::size_t index) const
+{
+    if (index >= size()) {
+        throw std::out_of_range("PersistentAvlTree::nth: index out of range");
+    }
+
+    const Node* node = root_;
+    for (;;) {
+        const std::size_t leftCount = countOf(node->left);
+        if (index < leftCount) {
+            node = node->left;
+        } else if (index == leftCount) {
+            return node->value.view();
+        } else {
+            index -= leftCount + 1;
+            node = node->right;
+        }
+    }
+}
+
+//  ConstIterator
+
+void PersistentAvlTree::ConstIterator::pushLeftPath(const Node* node) noexcept
+{
+    for (; node != nullptr; node = node->left) {
+        path[depth++] = node;
+    }
+}
+
+std::string_view PersistentAvlTree::ConstIterator::operator*() const noexcept
+{
+    return path[depth - 1]->value.view();
+}
+
+PersistentAvlTree::ConstIterator& PersistentAvlTree::ConstIterator::operator++() noexcept
+{
+    const Node* current = path[--depth];
+    pushLeftPath(current->right);
+    return *this;
+}
+
+PersistentAvlTree::ConstIterator PersistentAvlTree::ConstIterator::operator++(int) noexcept
+{
+    ConstIterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+bool PersistentAvlTree::ConstIterator::operator==(const ConstIterator& other) const noexcept
+{
+    const Node* current = depth > 0 ? path[depth - 1] : nullptr;
+    const Node* otherCurrent = other.depth > 0 ? other.path[other.depth - 1] : nullptr;
+    return current == otherCurrent;
+}
+
+bool PersistentAvlTree::ConstIterator::operator!=(const ConstIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+//  печать / размер
+
+void PersistentAvlTree::printRec(const Node* node, int depth)
+{
+    if (node == nullptr) {
+        return;
+    }
+
+    printRec(node->right, depth + 1);
+    for (int i = 0; i < depth; ++i) {
+        std::cout << "  ";
+    }
+    std::cout << node->value << "\n";
+    printRec(node->left, depth + 1);
+}
+
+void PersistentAvlTree::print() const
+{
+    printRec(root_, 0);
+}
+
+std::size_t PersistentAvlTree::size() const noexcept
+{
+    return countOf(root_);
+}
+
+bool PersistentAvlTree::empty() const noexcept
+{
+    return root_ == nullptr;
+}
+
+std::size_t PersistentAvlTree::memoryUsage() const noexcept
+{
+    return sizeof(PersistentAvlTree) + size() * memory_usage::heapBlock(sizeof(Node));
+}
+
+//  сборка из отсортированных значений
+
+PersistentAvlTree::NodeRef PersistentAvlTree::buildBalanced(InternedString* values, std::size_t count)
+{
+    // середина — корень, глубина рекурсии — log2(count)
+    if (count == 0) {
+        return NodeRef();
+    }
+    const std::size_t middle = count / 2;
+    NodeRef left = buildBalanced(values, middle);
+    NodeRef right = buildBalanced(values + middle + 1, count - middle - 1);
+    return makeNode(std::move(values[middle]), std::move(left), std::move(right));
+}
+
+void PersistentAvlTree::loadValues(std::string* values, std::size_t count)
+{
+    // строго возрастающие значения собираются за O(n), иначе вставляются
+    // по одному; прежняя версия заменяется только после успешной сборки
+    const bool sorted = std::adjacent_find(values, values + count,
+                                           [](const std::string& a, const std::string& b) {
+                                               return !(a < b);
+                                           }) == values + count;
+    PersistentAvlTree loaded;
+    if (sorted) {
+        std::vector<InternedString> interned;
+        interned.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            interned.emplace_back(values[i]);
+        }
+        loaded = PersistentAvlTree(buildBalanced(interned.data(), interned.size()));
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            loaded.insert(values[i]);
+        }
+    }
+    swap(loaded);
+}
+
+//  текстовая сериализация
+
+std::string PersistentAvlTree::serialize() const
+{
+    std::ostringstream oss;
+    oss << size() << "\n";
+    for (std::string_view value : *this) {
+        oss << value << "\n";
+    }
+    return oss.str();
+}
+
+void PersistentAvlTree::deserialize(const std::string& data)
+{
+    std::istringstream iss(data);
+    std::size_t count = 0;
+    if (!(iss >> count)) {
+        // пустой текст — пустое дерево
+        PersistentAvlTree().swap(*this);
+        return;
+    }
+    iss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::vector<std::string> values;
+    values.reserve(memory_usage::trustedReserve(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string value;
+        if (!std::getline(iss, value)) {
+            throw std::runtime_error("PersistentAvlTree::deserialize: error");
+        }
+        values.push_back(std::move(value));
+    }
+    loadValues(values.data(), values.size());
+}
+
+//  бинарная сериализация
+
+void PersistentAvlTree::serializeBinary(std::ostream& outputStream) const
+{
+    const std::uint64_t count = size();
+    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (std::string_view value : *this) {
+        const std::uint64_t len = value.size();
+        outputStream.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        if (len > 0) {
+            outputStream.write(value.data(), static_cast<std::streamsize>(len));
+        }
+    }
+    if (!outputStream) {
+        throw std::runtime_error("PersistentAvlTree::serializeBinary: error");
+    }
+}
+
+void PersistentAvlTree::deserializeBinary(std::istream& inputStream)
+{
+    std::uint64_t count = 0;
+    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!inputStream) {
+        throw std::runtime_error("PersistentAvlTree::deserializeBinary: error");
+    }
+
+    std::vector<std::string> values;
+    values.reserve(memory_usage::trustedReserve(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t len = 0;
+        inputStream.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!inputStream) {
+            throw std::runtime_error("PersistentAvlTree::deserializeBinary: error");
+        }
+        std::string value;
+        value.resize(static_cast<std::size_t>(len));
+        if (len > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(len));
+            if (!inputStream) {
+                throw std::runtime_error("PersistentAvlTree::deserializeBinary: error");
+            }
+        }
+        values.push_back(std::move(value));
+    }
+    loadValues(values.data(), values.size());
+}
+
+//  Rule of Five: копирование / перемещение
+
+PersistentAvlTree::PersistentAvlTree(NodeRef root) noexcept
+    : root_(root.release())
+{
+}
+
+PersistentAvlTree::~PersistentAvlTree()
+{
+    releaseNode(root_);
+}
+
+PersistentAvlTree::PersistentAvlTree(const PersistentAvlTree& other) noexcept
+    : root_(share(other.root_).release())
+{
+}
+
+PersistentAvlTree::PersistentAvlTree(PersistentAvlTree&& other) noexcept
+    : root_(std::exchange(other.root_, nullptr))
+{
+}
+
+PersistentAvlTree& PersistentAvlTree::operator=(const PersistentAvlTree& other) noexcept
+{
+    PersistentAvlTree copy(other);
+    swap(copy);
+    return *this;
+}
+
+PersistentAvlTree& PersistentAvlTree::operator=(PersistentAvlTree&& other) noexcept
+{
+    if (this != &other) {
+        PersistentAvlTree moved(std::move(other));
+        swap(moved);
+    }
+    return *this;
+}
+
+void PersistentAvlTree::swap(PersistentAvlTree& other) noexcept
+{
+    std::swap(root_, other.root_);
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "string_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+//  PersistentAvlTree — неизменяемое AVL-дерево с общими версиями
+//
+//  Узлы после создания не меняются. insert/remove копируют только путь от
+//  корня до изменённого места (O(log n) узлов), остальное новая версия
+//  делит со старой; узлы освобождаются по атомарному счётчику ссылок, когда
+//  их не держит ни одна версия. Поэтому копия дерева — O(1) снапшот:
+//  читатель работает со своей копией в другом потоке, не блокируя писателя
+//  и не видя его изменений. Один объект из нескольких потоков без
+//  синхронизации не используется — поток берёт себе копию.
+
+class PersistentAvlTree
+{
+public:
+    PersistentAvlTree() noexcept = default;
+    ~PersistentAvlTree();
+
+    // Rule of Five: копия — новая ссылка на тот же корень
+    PersistentAvlTree(const PersistentAvlTree& other) noexcept;
+    PersistentAvlTree(PersistentAvlTree&& other) noexcept;
+    PersistentAvlTree& operator=(const PersistentAvlTree& other) noexcept;
+    PersistentAvlTree& operator=(PersistentAvlTree&& other) noexcept;
+
+    // Базовые операции: заменяют версию этого объекта, копии не меняются
+    void insert(const std::string& value);
+    void remove(const std::string& value);
+    [[nodiscard]] bool contains(const std::string& value) const noexcept;
+
+    // новая версия; эта остаётся прежней
+    [[nodiscard]] PersistentAvlTree inserted(const std::string& value) const;
+    [[nodiscard]] PersistentAvlTree removed(const std::string& value) const;
+
+    // Порядковые запросы (как у AvlTree); итераторы и строки из nth
+    // действительны, пока жива любая версия, содержащая эти узлы
+    class ConstIterator;
+
+    [[nodiscard]] ConstIterator begin() const noexcept;
+    [[nodiscard]] ConstIterator end() const noexcept;
+    [[nodiscard]] ConstIterator lowerBound(std::string_view value) const noexcept;  // первое >= value
+    [[nodiscard]] ConstIterator upperBound(std::string_view value) const noexcept;  // первое > value
+
+    [[nodiscard]] std::size_t rank(std::string_view value) const noexcept;  // сколько значений < value
+    [[nodiscard]] std::string_view nth(std::size_t index) const;            // с нуля; std::out_of_range
+
+    // Вспомогательные методы
+    void print() const;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    // байты: объект + узлы версии, включая общие с другими версиями
+    // (текст значений учитывается в StringPool)
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;
+
+    //  текстовая сериализация: число значений, затем по значению в строке
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& data);
+
+    //  бинарная сериализация: [u64 count] затем count раз [u64 len][bytes]
+    //  по возрастанию; отсортированный вход собирается за O(n)
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+    void swap(PersistentAvlTree& other) noexcept;
+
+private:
+    static constexpr int kMaxHeight = 96;   // как у AvlTree
+
+    struct Node
+    {
+        InternedString value;
+        const Node* left;
+        const Node* right;
+        std::size_t count;   // узлов в поддереве
+        mutable std::atomic<std::uint32_t> refs{1};
+        int height;
+
+        Node(InternedString v, const Node* l, const Node* r) noexcept;
+    };
+
+    // владеющая ссылка на узел: освобождает её в деструкторе, поэтому
+    // исключение посреди копирования пути не оставляет утечек
+    class NodeRef
+    {
+    public:
+        NodeRef() noexcept = default;
+        explicit NodeRef(const Node* node) noexcept : node_(node) {}
+        NodeRef(NodeRef&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+        NodeRef& operator=(NodeRef&& other) noexcept;
+        NodeRef(const NodeRef&) = delete;
+        NodeRef& operator=(const NodeRef&) = delete;
+        ~NodeRef();
+
+        [[nodiscard]] const Node* get() const noexcept { return node_; }
+        const Node* release() noexcept { return std::exchange(node_, nullptr); }
+
+    private:
+        const Node* node_{nullptr};
+    };
+
+    const Node* root_{nullptr};
+
+    explicit PersistentAvlTree(NodeRef root) noexcept;
+
+    static NodeRef share(const Node* node) noexcept;       // +1 ссылка
+    static void releaseNode(const Node* node) noexcept;    // -1 ссылка, удаление поддерева
+
+    [[nodiscard]] static int heightOf(const Node* node) noexcept;
+    [[nodiscard]] static std::size_t countOf(const Node* node) noexcept;
+
+    // новый узел забирает ссылки left и right
+    static NodeRef makeNode(InternedString value, NodeRef left, NodeRef right);
+    // то же с поворотом, если высоты детей разошлись на 2
+    static NodeRef balanced(InternedString value, NodeRef left, NodeRef right);
+
+    // пустая ссылка — значение уже есть; removeFrom — только для
+    // значения, которое есть в дереве
+    static NodeRef insertInto(const Node* node, std::string_view value);
+    static NodeRef removeFrom(const Node* node, std::string_view value);
+    static NodeRef removeMin(const Node* node, InternedString& minValue);
+
+    // values строго возрастают; значения перемещаются в узлы
+    static NodeRef buildBalanced(InternedString* values, std::size_t count);
+    void loadValues(std::string* values, std::size_t count);
+
+    static void printRec(const Node* node, int depth);
+};
+
+
+//  PersistentAvlTree::ConstIterator — симметричный обход по пути от корня
+
+class PersistentAvlTree::ConstIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = std::string_view;
+
+    ConstIterator() noexcept = default;
+
+    [[nodiscard]] std::string_view operator*() const noexcept;
+    ConstIterator& operator++() noexcept;
+    ConstIterator operator++(int) noexcept;
+
+    [[nodiscard]] bool operator==(const ConstIterator& other) const noexcept;
+    [[nodiscard]] bool operator!=(const ConstIterator& other) const noexcept;
+
+private:
+    friend class PersistentAvlTree;
+
+    void pushLeftPath(const Node* node) noexcept;
+
+    const Node* path[kMaxHeight]{};
+    int depth{0};
+};
@@ -0,0 +1,265 @@
+#include "priority_queue.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+// просеивание
+
+void PriorityQueue::siftUp(std::size_t index) noexcept
+{
+    Entry moving = std::move(heap[index]);
+    while (index > 0) {
+        const std::size_t parent = (index - 1) / kArity;
+        if (!moving.before(heap[parent])) {
+            break;
+        }
+        heap[index] = std::move(heap[parent]);
+        index = parent;
+    }
+    heap[index] = std::move(moving);
+}
+
+void PriorityQueue::siftDown(std::size_t index) noexcept
+{
+    const std::size_t count = heap.size();
+    Entry moving = std::move(heap[index]);
+    for (;;) {
+        const std::size_t first = index * kArity + 1;
+        if (first >= count) {
+            break;
+        }
+        // лучший из сыновей: они лежат подряд
+        std::size_t best = first;
+        const std::size_t last = std::min(first + kArity, count);
+        for (std::size_t child = first + 1; child < last; ++child) {
+            if (heap[child].before(heap[best])) {
+                best = child;
+            }
+        }
+        if (!heap[best].before(moving)) {
+            break;
+        }
+        heap[index] = std::move(heap[best]);
+        index = best;
+    }
+    heap[index] = std::move(moving);
+}
+
+void PriorityQueue::heapify() noexcept
+{
+    // Флойд: снизу вверх от последнего внутреннего узла, O(n)
+    if (heap.size() < 2) {
+        return;
+    }
+    for (std::size_t index = (heap.size() - 2) / kArity + 1; index > 0; --index) {
+        siftDown(index - 1);
+    }
+}
+
+// базовые операции
+
+void PriorityQueue::push(std::int64_t priority, std::string value)
+{
+    heap.push_back(Entry{priority, nextOrder, std::move(value)});
+    ++nextOrder;
+    siftUp(heap.size() - 1);
+}
+
+std::string PriorityQueue::pop()
+{
+    if (heap.empty()) {
+        throw std::out_of_range("PriorityQueue::pop: queue is empty");
+    }
+
+    std::string result = std::move(heap.front().value);
+    if (heap.size() > 1) {
+        heap.front() = std::move(heap.back());
+        heap.pop_back();
+        siftDown(0);
+    } else {
+        heap.pop_back();
+    }
+    return result;
+}
+
+const std::string& PriorityQueue::top() const
+{
+    if (heap.empty()) {
+        throw std::out_of_range("PriorityQueue::top: queue is empty");
+    }
+    return heap.front().value;
+}
+
+std::int64_t PriorityQueue::topPriority() const
+{
+    if (heap.empty()) {
+        throw std::out_of_range("PriorityQueue::topPriority: queue is empty");
+    }
+    return heap.front().priority;
+}
+
+std::size_t PriorityQueue::size() const noexcept
+{
+    return heap.size();
+}
+
+bool PriorityQueue::empty() const noexcept
+{
+    return heap.empty();
+}
+
+void PriorityQueue::reserve(std::size_t capacity)
+{
+    heap.reserve(capacity);
+}
+
+std::size_t PriorityQueue::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(PriorityQueue);
+    if (heap.capacity() > 0) {
+        total += memory_usage::heapBlock(heap.capacity() * sizeof(Entry));
+    }
+    for (const Entry& entry : heap) {
+        total += memory_usage::stringHeap(entry.value);
+    }
+    return total;
+}
+
+std::vector<const PriorityQueue::Entry*> PriorityQueue::inPopOrder() const
+{
+    std::vector<const Entry*> ordered;
+    ordered.reserve(heap.size());
+    for (const Entry& entry : heap) {
+        ordered.push_back(&entry);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const Entry* left, const Entry* right) { return left->before(*right); });
+    return ordered;
+}
+
+void PriorityQueue::adopt(std::vector<Entry>&& entries) noexcept
+{
+    // номера добавления — заново по порядку файла: равные приоритеты
+    // выходят в том же порядке, что до сохранения
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].order = i;
+    }
+    heap.swap(entries);
+    nextOrder = heap.size();
+    heapify();   // файл могли править руками; для отсортированного — один проход
+}
+
+void PriorityQueue::print() const
+{
+    std::cout << '[';
+    const std::vector<const Entry*> ordered = inPopOrder();
+    for (std::size_t i = 0; i < ordered.size(); ++i) {
+        std::cout << (i > 0 ? ", " : "") << ordered[i]->priority << ':' << ordered[i]->value;
+    }
+    std::cout << "]\n";
+}
+
+// текстовая сериализация
+
+void PriorityQueue::serializeText(std::ostream& outputStream) const
+{
+    for (const Entry* entry : inPopOrder()) {
+        outputStream << entry->priority << ' ' << entry->value << '\n';
+    }
+}
+
+void PriorityQueue::deserializeText(std::istream& inputStream)
+{
+    std::vector<Entry> entries;
+    std::string line;
+    while (std::getline(inputStream, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        // «приоритет значение»: значение — остаток строки, может быть пустым
+        const std::size_t space = line.find(' ');
+        std::int64_t priority = 0;
+        try {
+            std::size_t parsed = 0;
+            priority = std::stoll(line.substr(0, space), &parsed);
+            if (parsed != std::min(space, line.size())) {
+                throw std::invalid_argument(line);
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("PriorityQueue::deserializeText: bad priority");
+        }
+        entries.push_back(Entry{priority, 0, space == std::string::npos ? std::string() : line.substr(space + 1)});
+    }
+    adopt(std::move(entries));
+}
+
+std::string PriorityQueue::serialize() const
+{
+    std::ostringstream output;
+    serializeText(output);
+    return output.str();
+}
+
+void PriorityQueue::deserialize(const std::string& text)
+{
+    std::istringstream input(text);
+    deserializeText(input);
+}
+
+// бинарная сериализация
+
+void PriorityQueue::serializeBinary(std::ostream& outputStream) const
+{
+    const std::uint64_t count = static_cast<std::uint64_t>(heap.size());
+    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    for (const Entry* entry : inPopOrder()) {
+        const std::uint64_t length = static_cast<std::uint64_t>(entry->value.size());
+        outputStream.write(reinterpret_cast<const char*>(&entry->priority), sizeof(entry->priority));
+        outputStream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        if (length > 0) {
+            outputStream.write(entry->value.data(), static_cast<std::streamsize>(length));
+        }
+    }
+
+    if (!outputStream) {
+        throw std::runtime_error("PriorityQueue::serializeBinary: ERROR");
+    }
+}
+
+void PriorityQueue::deserializeBinary(std::istream& inputStream)
+{
+    std::uint64_t count = 0;
+    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!inputStream) {
+        throw std::runtime_error("PriorityQueue::deserializeBinary: ERROR");
+    }
+
+    // при ошибке чтения очередь не меняется
+    std::vector<Entry> entries;
+    entries.reserve(memory_usage::trustedReserve(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::int64_t priority = 0;
+        std::uint64_t length = 0;
+        inputStream.read(reinterpret_cast<char*>(&priority), sizeof(priority));
+        inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!inputStream) {
+            throw std::runtime_error("PriorityQueue::deserializeBinary: ERROR");
+        }
+
+        std::string value;
+        value.resize(static_cast<std::size_t>(length));
+        if (length > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(length));
+            if (!inputStream) {
+                throw std::runtime_error("PriorityQueue::deserializeBinary: ERROR");
+            }
+        }
+        entries.push_back(Entry{priority, 0, std::move(value)});
+    }
+    adopt(std::move(entries));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//  PriorityQueue — очередь с приоритетами на 4-арной куче
+//
+//  Строки с числовым приоритетом; раньше выходит меньший приоритет, при
+//  равных — добавленная раньше. Куча лежит одним массивом: у узла четыре
+//  соседних сына, поэтому дерево вдвое ниже двоичного, а просеивание вниз
+//  читает сыновей подряд. Просеивание двигает «дырку» и перемещает строки,
+//  не копируя их. Сериализация пишет элементы в порядке выдачи:
+//  отсортированный массив — уже куча, загрузка линейна.
+
+class PriorityQueue
+{
+public:
+    static constexpr std::size_t kArity = 4;
+
+    PriorityQueue() noexcept = default;
+
+    void push(std::int64_t priority, std::string value);
+    std::string pop();                                        // std::out_of_range, если пуста
+    [[nodiscard]] const std::string& top() const;             // std::out_of_range, если пуста
+    [[nodiscard]] std::int64_t topPriority() const;           // std::out_of_range, если пуста
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    void reserve(std::size_t capacity);
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    void print() const;   // [приоритет:значение, ...] в порядке выдачи
+
+    // текстовая сериализация: строки «приоритет значение»
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& text);
+
+    void serializeText(std::ostream& outputStream) const;
+    void deserializeText(std::istream& inputStream);
+
+    // бинарная сериализация: [u64 count] и count раз [i64 priority][u64 len][bytes]
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+private:
+    struct Entry
+    {
+        std::int64_t  priority;
+        std::uint64_t order;   // номер добавления: равные приоритеты — FIFO
+        std::string   value;
+
+        [[nodiscard]] bool before(const Entry& other) const noexcept
+        {
+            return priority != other.priority ? priority < other.priority : order < other.order;
+        }
+    };
+
+    std::vector<Entry> heap;
+    std::uint64_t      nextOrder{0};
+
+    void siftUp(std::size_t index) noexcept;
+    void siftDown(std::size_t index) noexcept;
+    void heapify() noexcept;
+    [[nodiscard]] std::vector<const Entry*> inPopOrder() const;
+    void adopt(std::vector<Entry>&& entries) noexcept;   // entries — в порядке выдачи
+};
@@ -1,11 +1,85 @@
 #include "queue.h"
+#include "memory_usage.h"
 
 #include <cstdint>
 #include <iostream>
+#include <new>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
 
+// блоки
+
+std::string* Queue::Chunk::items() noexcept
+{
+    return std::launder(reinterpret_cast<std::string*>(storage));
+}
+
+const std::string* Queue::Chunk::items() const noexcept
+{
+    return std::launder(reinterpret_cast<const std::string*>(storage));
+}
+
+Queue::Chunk* Queue::takeChunk()
+{
+    if (spareChunk != nullptr) {
+        return std::exchange(spareChunk, nullptr);
+    }
+    return new Chunk;
+}
+
+void Queue::recycleChunk(Chunk* chunk) noexcept
+{
+    // один пустой блок держим про запас: очередь на границе блока не
+    // выделяет и не освобождает память на каждой паре push/pop
+    chunk->next  = nullptr;
+    chunk->begin = 0;
+    chunk->end   = 0;
+    if (spareChunk == nullptr) {
+        spareChunk = chunk;
+    } else {
+        delete chunk;
+    }
+}
+
+template <class Visit>
+void Queue::forEach(Visit&& visit) const
+{
+    for (const Chunk* chunk = frontChunk; chunk != nullptr; chunk = chunk->next) {
+        const std::string* items = chunk->items();
+        for (std::uint32_t i = chunk->begin; i < chunk->end; ++i) {
+            visit(items[i]);
+        }
+    }
+}
+
+template <class Value>
+void Queue::append(Value&& value)
+{
+    if (backChunk != nullptr && backChunk->end < kChunkCapacity) {
+        ::new (static_cast<void*>(backChunk->items() + backChunk->end)) std::string(std::forward<Value>(value));
+        ++backChunk->end;
+        ++sizeValue;
+        return;
+    }
+
+    Chunk* chunk = takeChunk();
+    try {
+        ::new (static_cast<void*>(chunk->items())) std::string(std::forward<Value>(value));
+    } catch (...) {
+        recycleChunk(chunk);
+        throw;
+    }
+    chunk->end = 1;
+    if (backChunk != nullptr) {
+        backChunk->next = chunk;
+    } else {
+        frontChunk = chunk;
+    }
+    backChunk = chunk;
+    ++sizeValue;
+}
+
 // конструкторы / деструктор
 
 Queue::Queue() noexcept = default;
@@ -17,39 +91,48 @@ Queue::~Queue()
 
 void Queue::clear() noexcept
 {
-    Node* current = frontNode;
+    Chunk* current = frontChunk;
     while (current != nullptr) {
-        Node* nodeToDelete = current;
-        current            = current->next;
-        delete nodeToDelete;
+        Chunk* chunkToDelete = current;
+        current              = current->next;
+        std::string* items   = chunkToDelete->items();
+        for (std::uint32_t i = chunkToDelete->begin; i < chunkToDelete->end; ++i) {
+            items[i].~basic_string();
+        }
+        delete chunkToDelete;
     }
-    frontNode = nullptr;
-    backNode  = nullptr;
-    sizeValue = 0;
+    // запасной блок тоже освобождаем: очищенная очередь не держит памяти
+    delete spareChunk;
+    frontChunk = nullptr;
+    backChunk  = nullptr;
+    spareChunk = nullptr;
+    sizeValue  = 0;
 }
 
 // Rule of Five
 
 Queue::Queue(const Queue& other)
-    : frontNode(nullptr), //NOLINT
-      backNode(nullptr), //NOLINT
-      sizeValue(0) //NOLINT
+    : limit(other.limit)
 {
-    Node* current = other.frontNode;
-    while (current != nullptr) {
-        push(current->value);
-        current = current->next;
+    try {
+        other.forEach([this](const std::string& value) { append(value); });
+    } catch (...) {
+        clear();
+        throw;
     }
 }
 
 Queue::Queue(Queue&& other) noexcept
-    : frontNode(other.frontNode),
-      backNode(other.backNode),
-      sizeValue(other.sizeValue)
+    : frontChunk(other.frontChunk),
+      backChunk(other.backChunk),
+      spareChunk(other.spareChunk),
+      sizeValue(other.sizeValue),
+      limit(other.limit)
 {
-    other.frontNode = nullptr;
-    other.backNode  = nullptr;
-    other.sizeValue = 0;
+    other.frontChunk = nullptr;
+    other.backChunk  = nullptr;
+    other.spareChunk = nullptr;
+    other.sizeValue  = 0;
 }
 
 Queue& Queue::operator=(const Queue& other)
@@ -70,13 +153,16 @@ Queue& Queue::operator=(Queue&& other) noexcept
     }
 
     clear();
-    frontNode = other.frontNode;
-    backNode  = other.backNode;
-    sizeValue = other.sizeValue;
+    frontChunk = other.frontChunk;
+    backChunk  = other.backChunk;
+    spareChunk = other.spareChunk;
+    sizeValue  = other.sizeValue;
+    limit      = other.limit;
 
-    other.frontNode = nullptr;
-    other.backNode  = nullptr;
-    other.sizeValue = 0;
+    other.frontChunk = nullptr;
+    other.backChunk  = nullptr;
+    other.spareChunk = nullptr;
+    other.sizeValue  = 0;
 
     return *this;
 }
@@ -84,56 +170,109 @@ Queue& Queue::operator=(Queue&& other) noexcept
 void Queue::swap(Queue& other) noexcept
 {
     using std::swap;
-    swap(frontNode, other.frontNode);
-    swap(backNode, other.backNode);
+    swap(frontChunk, other.frontChunk);
+    swap(backChunk, other.backChunk);
+    swap(spareChunk, other.spareChunk);
     swap(sizeValue, other.sizeValue);
+    swap(limit, other.limit);
 }
 
 // базовые операции
 
 void Queue::push(const std::string& value)
 {
-    Node* node = new Node(value);
-    if (backNode != nullptr) {
-        backNode->next = node;
-    } else {
-        frontNode = node;
+    if (full()) {
+        throw std::overflow_error("Queue::push: queue is full");
     }
-    backNode = node;
-    ++sizeValue;
+    append(value);
+}
+
+void Queue::push(std::string&& value)
+{
+    if (full()) {
+        throw std::overflow_error("Queue::push: queue is full");
+    }
+    append(std::move(value));
+}
+
+bool Queue::tryPush(const std::string& value)
+{
+    if (full()) {
+        return false;
+    }
+    append(value);
+    return true;
 }
 
 std::string Queue::pop()
 {
-    if (frontNode == nullptr) {
+    if (frontChunk == nullptr) {
         throw std::out_of_range("Queue::pop: queue is empty");
     }
 
-    std::string result = frontNode->value;
-    Node* nodeToDelete = frontNode;
-    frontNode          = frontNode->next;
-    if (frontNode == nullptr) {
-        backNode = nullptr;
-    }
-    delete nodeToDelete;
+    // элемент уходит из очереди: строка перемещается, а не копируется
+    std::string& slot  = frontChunk->items()[frontChunk->begin];
+    std::string result = std::move(slot);
+    slot.~basic_string();
+    ++frontChunk->begin;
     --sizeValue;
+
+    if (frontChunk->begin == frontChunk->end) {
+        Chunk* emptied = frontChunk;
+        frontChunk     = frontChunk->next;
+        if (frontChunk == nullptr) {
+            backChunk = nullptr;
+        }
+        recycleChunk(emptied);
+    }
     return result;
 }
 
+std::size_t Queue::popBatch(std::size_t maxCount, std::vector<std::string>& out)
+{
+    const std::size_t taken = maxCount < sizeValue ? maxCount : sizeValue;
+    out.reserve(out.size() + taken);
+
+    // блок за блоком: строки уходят перемещением, опустевшие блоки — в запас
+    std::size_t left = taken;
+    while (left > 0) {
+        std::string* items = frontChunk->items();
+        const std::uint32_t available = frontChunk->end - frontChunk->begin;
+        const std::uint32_t step = left < available ? static_cast<std::uint32_t>(left) : available;
+        for (std::uint32_t i = frontChunk->begin; i < frontChunk->begin + step; ++i) {
+            out.push_back(std::move(items[i]));
+            items[i].~basic_string();
+        }
+        frontChunk->begin += step;
+        left -= step;
+
+        if (frontChunk->begin == frontChunk->end) {
+            Chunk* emptied = frontChunk;
+            frontChunk     = frontChunk->next;
+            if (frontChunk == nullptr) {
+                backChunk = nullptr;
+            }
+            recycleChunk(emptied);
+        }
+    }
+    sizeValue -= taken;
+    return taken;
+}
+
 const std::string& Queue::front() const
 {
-    if (frontNode == nullptr) {
+    if (frontChunk == nullptr) {
         throw std::out_of_range("Queue::front: queue is empty");
     }
-    return frontNode->value;
+    return frontChunk->items()[frontChunk->begin];
 }
 
 const std::string& Queue::back() const
 {
-    if (backNode == nullptr) {
+    if (backChunk == nullptr) {
         throw std::out_of_range("Queue::back: queue is empty");
     }
-    return backNode->value;
+    return backChunk->items()[backChunk->end - 1];
 }
 
 std::size_t Queue::size() const noexcept
@@ -146,17 +285,44 @@ bool Queue::empty() const noexcept
     return sizeValue == 0;
 }
 
+void Queue::setCapacityLimit(std::size_t newLimit) noexcept
+{
+    limit = newLimit;
+}
+
+std::size_t Queue::capacityLimit() const noexcept
+{
+    return limit;
+}
+
+bool Queue::full() const noexcept
+{
+    return limit != 0 && sizeValue >= limit;
+}
+
+std::size_t Queue::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(Queue);
+    for (const Chunk* chunk = frontChunk; chunk != nullptr; chunk = chunk->next) {
+        total += memory_usage::heapBlock(sizeof(Chunk));
+    }
+    if (spareChunk != nullptr) {
+        total += memory_usage::heapBlock(sizeof(Chunk));
+    }
+    forEach([&total](const std::string& value) { total += memory_usage::stringHeap(value); });
+    return total;
+}
+
 void Queue::print() const
 {
     std::cout << "[";
-    Node* current = frontNode;
-    while (current != nullptr) {
-        std::cout << current->value;
-        if (current->next != nullptr) {
+    std::size_t printed = 0;
+    forEach([&printed, this](const std::string& value) {
+        std::cout << value;
+        if (++printed < sizeValue) {
             std::cout << ", ";
         }
-        current = current->next;
-    }
+    });
     std::cout << "]\n";
 }
 
@@ -164,11 +330,7 @@ void Queue::print() const
 
 void Queue::serializeText(std::ostream& outputStream) const
 {
-    Node* current = frontNode;
-    while (current != nullptr) {
-        outputStream << current->value << '\n';
-        current = current->next;
-    }
+    forEach([&outputStream](const std::string& value) { outputStream << value << '\n'; });
 }
 
 void Queue::deserializeText(std::istream& inputStream)
@@ -177,7 +339,7 @@ void Queue::deserializeText(std::istream& inputStream)
     std::string line;
     while (std::getline(inputStream, line)) {
         if (!line.empty()) {
-            push(line);
+            append(std::move(line));
         }
     }
 }
@@ -202,18 +364,15 @@ void Queue::serializeBinary(std::ostream& outputStream) const
     std::uint64_t count = static_cast<std::uint64_t>(sizeValue);
     outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
 
-    Node* current = frontNode;
-    while (current != nullptr) {
-        std::uint64_t length =
-            static_cast<std::uint64_t>(current->value.size());
+    forEach([&outputStream](const std::string& value) {
+        std::uint64_t length = static_cast<std::uint64_t>(value.size());
         outputStream.write(reinterpret_cast<const char*>(&length),
                            sizeof(length));
         if (length > 0) {
-            outputStream.write(current->value.data(),
+            outputStream.write(value.data(),
                                static_cast<std::streamsize>(length));
         }
-        current = current->next;
-    }
+    });
 
     if (!outputStream) {
         throw std::runtime_error("Queue::serializeBinary: ERROR");
@@ -249,6 +408,6 @@ void Queue::deserializeBinary(std::istream& inputStream)
                     "Queue::deserializeBinary: ERROR");
             }
         }
-        push(value);
+        append(std::move(value));
     }
 }
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 #include <utility>
+#include <vector>
 
 class Queue
 {
@@ -18,14 +20,29 @@ public:
     Queue& operator=(Queue&& other) noexcept;
 
     // Базовые операции
-    void push(const std::string& value);        // в конец
+    void push(const std::string& value);        // в конец, std::overflow_error если полна
+    void push(std::string&& value);
+    [[nodiscard]] bool tryPush(const std::string& value);   // false, если полна
     std::string pop();                          // из начала, std::out_of_range если пусто
 
+    // пакетные операции: pushBatch кладёт по порядку, пока очередь не
+    // заполнится, popBatch перемещает до maxCount строк в конец out;
+    // обе возвращают число обработанных элементов
+    template <class InputIt>
+    std::size_t pushBatch(InputIt first, InputIt last);
+    std::size_t popBatch(std::size_t maxCount, std::vector<std::string>& out);
+
     [[nodiscard]] const std::string& front() const;  
     [[nodiscard]] const std::string& back() const;
 
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // предел размера для push/tryPush, 0 — без предела; загрузка его не проверяет
+    void setCapacityLimit(std::size_t limit) noexcept;
+    [[nodiscard]] std::size_t capacityLimit() const noexcept;
+    [[nodiscard]] bool full() const noexcept;
 
     void print() const;
 
@@ -43,24 +60,46 @@ public:
     void swap(Queue& other) noexcept;
 
 private:
-    class Node
-    {
-    public:
-        explicit Node(std::string valueIn) noexcept
-            : value(std::move(valueIn))
-        {
-        }
+    //  элементы лежат блоками по kChunkCapacity строк: одна аллокация на
+    //  блок вместо узла на элемент, проход читает строки подряд
+    static constexpr std::uint32_t kChunkCapacity = 32;
 
-    private:
-        std::string value;
-        Node* next{nullptr};   
+    struct Chunk
+    {
+        Chunk*        next{nullptr};
+        std::uint32_t begin{0};   // первый живой слот
+        std::uint32_t end{0};     // за последним живым слотом
+        alignas(std::string) unsigned char storage[kChunkCapacity * sizeof(std::string)];
 
-        friend class Queue;
+        [[nodiscard]] std::string* items() noexcept;
+        [[nodiscard]] const std::string* items() const noexcept;
     };
 
-    Node*       frontNode{nullptr};
-    Node*       backNode{nullptr};
+    Chunk*      frontChunk{nullptr};
+    Chunk*      backChunk{nullptr};
+    // опустевший блок для следующего push: очередь, опустевшая через pop,
+    // держит его (около 1 КБ) до загрузки или разрушения
+    Chunk*      spareChunk{nullptr};
     std::size_t sizeValue{0};
+    std::size_t limit{0};
 
     void clear() noexcept;
+    template <class Value>
+    void append(Value&& value);   // без проверки предела
+    Chunk* takeChunk();
+    void recycleChunk(Chunk* chunk) noexcept;
+
+    template <class Visit>
+    void forEach(Visit&& visit) const;
 };
+
+template <class InputIt>
+std::size_t Queue::pushBatch(InputIt first, InputIt last)
+{
+    std::size_t pushed = 0;
+    for (; first != last && !full(); ++first) {
+        push(*first);
+        ++pushed;
+    }
+    return pushed;
+}
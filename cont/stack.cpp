@@ -1,10 +1,14 @@
 #include "stack.h"
+#include "memory_usage.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <new>
 #include <sstream>
 #include <stdexcept>
-#include <vector>
+#include <utility>
 
 //  базовые операции / управление памятью 
 
@@ -17,84 +21,161 @@ Stack::~Stack()
 
 void Stack::clear() noexcept
 {
-    StackNode* current = topNode;
-    while (current != nullptr) {
-        StackNode* nodeToDelete = current;
-        current                 = current->next;
-        delete nodeToDelete;
+    for (std::size_t i = 0; i < count; ++i) {
+        items[i].~basic_string();
     }
-    topNode = nullptr;
+    ::operator delete(items);
+    items    = nullptr;
+    count    = 0;
+    capacity = 0;
+}
+
+void Stack::grow(std::size_t newCapacity)
+{
+    if (newCapacity > std::numeric_limits<std::size_t>::max() / sizeof(std::string)) {
+        throw std::length_error("Stack: capacity is too large");
+    }
+
+    // при ошибке выделения стек не меняется; перенос строк не бросает
+    auto* newItems = static_cast<std::string*>(::operator new(newCapacity * sizeof(std::string)));
+    for (std::size_t i = 0; i < count; ++i) {
+        ::new (static_cast<void*>(newItems + i)) std::string(std::move(items[i]));
+        items[i].~basic_string();
+    }
+    ::operator delete(items);
+    items    = newItems;
+    capacity = newCapacity;
+}
+
+void Stack::reserve(std::size_t minCapacity)
+{
+    if (minCapacity > capacity) {
+        grow(minCapacity);
+    }
+}
+
+template <class Value>
+void Stack::pushUnchecked(Value&& value)
+{
+    if (count < capacity) {
+        ::new (static_cast<void*>(items + count)) std::string(std::forward<Value>(value));
+    } else {
+        // копия до роста: value может быть строкой этого же стека
+        std::string item(std::forward<Value>(value));
+        grow(capacity == 0 ? 1 : capacity * 2);
+        ::new (static_cast<void*>(items + count)) std::string(std::move(item));
+    }
+    ++count;
 }
 
 void Stack::push(const std::string& value)
 {
-    StackNode* newNode = new StackNode(value);
-    newNode->next = topNode;  // новый → старый топ
-    topNode = newNode;            
+    if (full()) {
+        throw std::overflow_error("Stack::push: stack is full");
+    }
+    pushUnchecked(value);
+}
+
+void Stack::push(std::string&& value)
+{
+    if (full()) {
+        throw std::overflow_error("Stack::push: stack is full");
+    }
+    pushUnchecked(std::move(value));
+}
+
+bool Stack::tryPush(const std::string& value)
+{
+    if (full()) {
+        return false;
+    }
+    pushUnchecked(value);
+    return true;
 }
 
 std::string Stack::pop()
 {
-    if (topNode == nullptr) {
+    if (count == 0) {
         throw std::out_of_range("Stack::pop: empty stack");
     }
 
-    std::string resultValue = topNode->value;
-    StackNode* nodeToDelete = topNode;
-    topNode                 = topNode->next;
-    delete nodeToDelete;
-
+    // элемент уходит из стека: строка перемещается, а не копируется
+    std::string resultValue = std::move(items[count - 1]);
+    items[count - 1].~basic_string();
+    --count;
     return resultValue;
 }
 
 void Stack::print() const
 {
-    StackNode* current = topNode;
     std::cout << '[';
-    while (current != nullptr) {
-        std::cout << current->value;
-        if (current->next != nullptr) {
+    for (std::size_t i = count; i > 0; --i) {
+        std::cout << items[i - 1];
+        if (i > 1) {
             std::cout << ", ";
         }
-        current = current->next;
     }
     std::cout << "]\n";
 }
 
 bool Stack::empty() const noexcept
 {
-    return topNode == nullptr;
+    return count == 0;
+}
+
+std::size_t Stack::size() const noexcept
+{
+    return count;
+}
+
+void Stack::setCapacityLimit(std::size_t newLimit) noexcept
+{
+    limit = newLimit;
+}
+
+std::size_t Stack::capacityLimit() const noexcept
+{
+    return limit;
+}
+
+bool Stack::full() const noexcept
+{
+    return limit != 0 && count >= limit;
+}
+
+std::size_t Stack::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(Stack);
+    if (capacity > 0) {
+        total += memory_usage::heapBlock(capacity * sizeof(std::string));
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        total += memory_usage::stringHeap(items[i]);
+    }
+    return total;
 }
 
 //  текстовая сериализация 
 
 void Stack::serializeText(std::ostream& os) const {
-    for (StackNode* n = topNode; n != nullptr; n = n->next)
-        os << n->value << '\n';
+    for (std::size_t i = count; i > 0; --i)
+        os << items[i - 1] << '\n';
 }
 
 void Stack::deserializeText(std::istream& input)
 {
     clear();
 
-    std::vector<std::string> lines;
+    // строки идут от верхушки: кладём подряд и разворачиваем на месте
     std::string line;
-
     while (std::getline(input, line)) {
         if (!line.empty()) {
-            lines.push_back(line);
+            pushUnchecked(std::move(line));
         }
     }
-
-
-    for (int i = (int)lines.size() - 1; i >= 0; --i)
-        push(lines[i]);
+    std::reverse(items, items + count);
 }
 
-
-
-
-
 std::string Stack::serialize() const
 {
     std::ostringstream output;
@@ -112,27 +193,18 @@ void Stack::deserialize(const std::string& text)
 
 void Stack::serializeBinary(std::ostream& outputStream) const
 {
-    // сначала посчитаем количество
-    std::uint64_t count = 0;
-    StackNode* current  = topNode;
-    while (current != nullptr) {
-        ++count;
-        current = current->next;
-    }
-
-    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    std::uint64_t storedCount = static_cast<std::uint64_t>(count);
+    outputStream.write(reinterpret_cast<const char*>(&storedCount), sizeof(storedCount));
 
-    current = topNode;
-    while (current != nullptr) {
-        std::uint64_t length =
-            static_cast<std::uint64_t>(current->value.size());
+    for (std::size_t i = count; i > 0; --i) {
+        const std::string& value = items[i - 1];
+        std::uint64_t length = static_cast<std::uint64_t>(value.size());
         outputStream.write(reinterpret_cast<const char*>(&length),
                            sizeof(length));
         if (length > 0) {
-            outputStream.write(current->value.data(),
+            outputStream.write(value.data(),
                                static_cast<std::streamsize>(length));
         }
-        current = current->next;
     }
 
     if (!outputStream) {
@@ -142,19 +214,18 @@ void Stack::serializeBinary(std::ostream& outputStream) const
 
 void Stack::deserializeBinary(std::istream& inputStream)
 {
-    clear();
-
-    std::uint64_t count = 0;
-    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::uint64_t storedCount = 0;
+    inputStream.read(reinterpret_cast<char*>(&storedCount), sizeof(storedCount));
     if (!inputStream) {
         throw std::runtime_error(
             "Stack::deserializeBinary: ERROR");
     }
 
-    std::vector<std::string> lines;
-    lines.reserve(static_cast<std::size_t>(count));
+    // собираем в отдельном стеке: при ошибке чтения этот не меняется
+    Stack loaded;
+    loaded.reserve(memory_usage::trustedReserve(storedCount));
 
-    for (std::uint64_t index = 0; index < count; ++index) {
+    for (std::uint64_t index = 0; index < storedCount; ++index) {
         std::uint64_t length = 0;
         inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
         if (!inputStream) {
@@ -172,11 +243,12 @@ void Stack::deserializeBinary(std::istream& inputStream)
                     "Stack::deserializeBinary: ERROR");
             }
         }
-        lines.push_back(std::move(value));
+        loaded.pushUnchecked(std::move(value));
     }
 
-    // восстановим порядок: последний прочитанный элемент должен оказаться внизу стека
-    for (std::size_t index = lines.size(); index > 0; --index) {
-        push(lines[index - 1]);
-    }
+    // поток пишется от верхушки: последний прочитанный элемент — дно
+    std::reverse(loaded.items, loaded.items + loaded.count);
+    std::swap(items, loaded.items);
+    std::swap(count, loaded.count);
+    std::swap(capacity, loaded.capacity);
 }
@@ -1,25 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
-#include <utility>
 
-class Stack;  
-
-class StackNode
-{
-public:
-    explicit StackNode(std::string valueIn) noexcept
-        : value(std::move(valueIn))
-    {
-    }
-
-private:
-    std::string value;
-    StackNode*  next{nullptr};
-
-    friend class Stack;
-};
+//  Stack — строки лежат подряд в сырой памяти, дно в слоте 0
+//
+//  push и pop не выделяют память, пока хватает вместимости; рост вдвое
+//  перемещает строки. pop забирает строку перемещением. Необязательный
+//  предел размера: tryPush сообщает о заполнении, push бросает.
 
 class Stack
 {
@@ -32,12 +21,22 @@ public:
     Stack(Stack&&) = delete;
     Stack& operator=(Stack&&) = delete;
 
-    void push(const std::string& value);  // наверх стека
+    void push(const std::string& value);  // наверх стека; std::overflow_error, если полон
+    void push(std::string&& value);
+    [[nodiscard]] bool tryPush(const std::string& value);   // false, если полон
     std::string pop();                    // std::out_of_range, если пуст
 
     void print() const;
 
     [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // предел размера для push/tryPush, 0 — без предела; загрузка его не проверяет
+    void setCapacityLimit(std::size_t limit) noexcept;
+    [[nodiscard]] std::size_t capacityLimit() const noexcept;
+    [[nodiscard]] bool full() const noexcept;
+    void reserve(std::size_t minCapacity);
 
     // текстовая сериализация
     [[nodiscard]] std::string serialize() const;
@@ -51,7 +50,14 @@ public:
     void deserializeBinary(std::istream& inputStream);
 
 private:
-    StackNode* topNode{nullptr};
+    // живые слоты — [0, count), верхушка — items[count - 1]
+    std::string* items{nullptr};
+    std::size_t  count{0};
+    std::size_t  capacity{0};
+    std::size_t  limit{0};
 
     void clear() noexcept;
+    void grow(std::size_t newCapacity);
+    template <class Value>
+    void pushUnchecked(Value&& value);   // без проверки предела
 };
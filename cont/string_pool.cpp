@@ -0,0 +1,229 @@
+#include "string_pool.h"
+#include "memory_usage.h"
+
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+//  InternedString
+
+InternedString::InternedString(std::string_view text)
+    : InternedString(StringPool::global().intern(text))
+{
+}
+
+InternedString::InternedString(const InternedString& other) noexcept
+    : entry(other.entry)
+{
+    if (entry != nullptr) {
+        entry->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+InternedString::InternedString(InternedString&& other) noexcept
+    : entry(other.entry)
+{
+    other.entry = nullptr;
+}
+
+InternedString& InternedString::operator=(const InternedString& other) noexcept
+{
+    if (entry == other.entry) {
+        return *this;
+    }
+
+    InternedString tmp(other);
+    swap(tmp);
+    return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    release();
+    entry = other.entry;
+    other.entry = nullptr;
+    return *this;
+}
+
+InternedString::~InternedString()
+{
+    release();
+}
+
+void InternedString::release() noexcept
+{
+    if (entry == nullptr) {
+        return;
+    }
+
+    // пока ссылок больше одной — уменьшаем без блокировки
+    std::uint32_t refs = entry->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (entry->refs.compare_exchange_weak(refs, refs - 1,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+            entry = nullptr;
+            return;
+        }
+    }
+
+    // последняя ссылка — решение об удалении принимается под мьютексом пула
+    entry->pool->release(entry);
+    entry = nullptr;
+}
+
+void InternedString::swap(InternedString& other) noexcept
+{
+    std::swap(entry, other.entry);
+}
+
+std::string_view InternedString::view() const noexcept
+{
+    if (entry == nullptr) {
+        return {};
+    }
+    return {entry->chars(), entry->length};
+}
+
+std::string InternedString::str() const
+{
+    return std::string(view());
+}
+
+const char* InternedString::data() const noexcept
+{
+    return entry != nullptr ? entry->chars() : "";
+}
+
+std::size_t InternedString::size() const noexcept
+{
+    return entry != nullptr ? entry->length : 0U;
+}
+
+bool InternedString::empty() const noexcept
+{
+    return size() == 0U;
+}
+
+std::ostream& operator<<(std::ostream& outStream, const InternedString& text)
+{
+    return outStream << text.view();
+}
+
+//  StringPool
+
+StringPool::~StringPool()
+{
+    // дескрипторы не должны переживать свой пул
+    for (auto& item : index) {
+        Entry* entry = item.second;
+        entry->~Entry();
+        ::operator delete(entry);
+    }
+    index.clear();
+    bytesValue = 0;
+}
+
+StringPool& StringPool::global()
+{
+    // намеренно не разрушается: дескрипторы в статических объектах
+    // могут освобождаться после выхода из main
+    static StringPool* pool = new StringPool();
+    return *pool;
+}
+
+InternedString StringPool::intern(std::string_view text)
+{
+    if (text.empty()) {
+        return InternedString{};
+    }
+    if (text.size() > UINT32_MAX) {
+        throw std::length_error("StringPool::intern: string is too long");
+    }
+
+    std::lock_guard<std::mutex> lock(guard);
+
+    auto found = index.find(text);
+    if (found != index.end()) {
+        found->second->refs.fetch_add(1, std::memory_order_relaxed);
+        return InternedString(found->second);
+    }
+
+    // заголовок и символы — одним блоком
+    void* memory = ::operator new(sizeof(Entry) + text.size() + 1);
+    Entry* entry = new (memory) Entry();
+    entry->length = static_cast<std::uint32_t>(text.size());
+    entry->pool   = this;
+    std::memcpy(entry->chars(), text.data(), text.size());
+    entry->chars()[text.size()] = '\0';
+
+    try {
+        index.emplace(std::string_view(entry->chars(), entry->length), entry);
+    } catch (...) {
+        entry->~Entry();
+        ::operator delete(memory);
+        throw;
+    }
+    bytesValue += text.size();
+    return InternedString(entry);
+}
+
+bool StringPool::contains(std::string_view text) const
+{
+    if (text.empty()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(guard);
+    return index.find(text) != index.end();
+}
+
+std::size_t StringPool::size() const
+{
+    std::lock_guard<std::mutex> lock(guard);
+    return index.size();
+}
+
+std::size_t StringPool::textBytes() const
+{
+    std::lock_guard<std::mutex> lock(guard);
+    return bytesValue;
+}
+
+std::size_t StringPool::memoryUsage() const
+{
+    // узел unordered_map: указатель next, пара ключ/значение и кешированный хеш
+    constexpr std::size_t indexNode =
+        sizeof(void*) + sizeof(std::pair<const std::string_view, Entry*>) + sizeof(std::size_t);
+
+    std::lock_guard<std::mutex> lock(guard);
+    std::size_t total = sizeof(StringPool);
+    if (index.bucket_count() > 1) {
+        total += memory_usage::heapBlock(index.bucket_count() * sizeof(void*));
+    }
+    for (const auto& item : index) {
+        total += memory_usage::heapBlock(sizeof(Entry) + item.second->length + 1U);
+        total += memory_usage::heapBlock(indexNode);
+    }
+    return total;
+}
+
+void StringPool::release(Entry* entry) noexcept
+{
+    std::lock_guard<std::mutex> lock(guard);
+
+    // за время ожидания мьютекса строку могли снова интернировать
+    if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    index.erase(std::string_view(entry->chars(), entry->length));
+    bytesValue -= entry->length;
+    entry->~Entry();
+    ::operator delete(entry);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class StringPool;
+
+//  InternedString — дескриптор строки из пула
+//
+//  Одинаковые строки одного пула имеют один и тот же дескриптор, поэтому
+//  сравнение на равенство — это сравнение указателей. Текст неизменяем,
+//  запись пула живёт, пока на неё есть хотя бы один дескриптор.
+
+class InternedString
+{
+public:
+    InternedString() noexcept = default;                // пустая строка
+    explicit InternedString(std::string_view text);     // интернирует в StringPool::global()
+
+    InternedString(const InternedString& other) noexcept;
+    InternedString(InternedString&& other) noexcept;
+    InternedString& operator=(const InternedString& other) noexcept;
+    InternedString& operator=(InternedString&& other) noexcept;
+    ~InternedString();
+
+    [[nodiscard]] std::string_view view() const noexcept;
+    [[nodiscard]] std::string str() const;
+    [[nodiscard]] const char* data() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    // равенство — по указателю (строки одного пула)
+    friend bool operator==(const InternedString& lhs, const InternedString& rhs) noexcept
+    {
+        return lhs.entry == rhs.entry;
+    }
+    friend bool operator!=(const InternedString& lhs, const InternedString& rhs) noexcept
+    {
+        return lhs.entry != rhs.entry;
+    }
+    // порядок — лексикографический
+    friend bool operator<(const InternedString& lhs, const InternedString& rhs) noexcept
+    {
+        return lhs.entry != rhs.entry && lhs.view() < rhs.view();
+    }
+
+    void swap(InternedString& other) noexcept;
+
+private:
+    struct Entry
+    {
+        std::atomic<std::uint32_t> refs{1};
+        std::uint32_t              length{0};
+        StringPool*                pool{nullptr};
+
+        [[nodiscard]] const char* chars() const noexcept
+        {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+        char* chars() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    explicit InternedString(Entry* entryIn) noexcept
+        : entry(entryIn)
+    {
+    }
+
+    void release() noexcept;
+
+    Entry* entry{nullptr};
+
+    friend class StringPool;
+};
+
+std::ostream& operator<<(std::ostream& outStream, const InternedString& text);
+
+
+//  StringPool — пул уникальных строк
+//
+//  Каждая уникальная строка хранится один раз: заголовок со счётчиком
+//  ссылок и символы лежат в одном блоке памяти. Пул потокобезопасен.
+
+class StringPool
+{
+public:
+    StringPool() = default;
+    ~StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = delete;
+    StringPool& operator=(StringPool&&) = delete;
+
+    // общий пул процесса (не разрушается до завершения программы)
+    static StringPool& global();
+
+    [[nodiscard]] InternedString intern(std::string_view text);
+    [[nodiscard]] bool contains(std::string_view text) const;
+
+    [[nodiscard]] std::size_t size() const;        // число уникальных строк
+    [[nodiscard]] std::size_t textBytes() const;   // суммарная длина уникальных строк
+    [[nodiscard]] std::size_t memoryUsage() const; // байты: объект + записи + индекс
+
+private:
+    using Entry = InternedString::Entry;
+
+    void release(Entry* entry) noexcept;
+
+    mutable std::mutex                            guard;
+    std::unordered_map<std::string_view, Entry*>  index;
+    std::size_t                                   bytesValue{0};
+
+    friend class InternedString;
+};
@@ -0,0 +1,535 @@
+#include "unrolled_list.h"
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+// блоки
+
+std::string* UnrolledList::Chunk::items() noexcept
+{
+    return std::launder(reinterpret_cast<std::string*>(storage));
+}
+
+const std::string* UnrolledList::Chunk::items() const noexcept
+{
+    return std::launder(reinterpret_cast<const std::string*>(storage));
+}
+
+UnrolledList::~UnrolledList()
+{
+    clear();
+}
+
+void UnrolledList::clear() noexcept
+{
+    Chunk* current = headChunk;
+    while (current != nullptr) {
+        Chunk* chunkToDelete = current;
+        current              = current->next;
+        std::string* items   = chunkToDelete->items();
+        for (std::uint32_t i = chunkToDelete->begin; i < chunkToDelete->end; ++i) {
+            items[i].~basic_string();
+        }
+        delete chunkToDelete;
+    }
+    headChunk = nullptr;
+    tailChunk = nullptr;
+    sizeValue = 0;
+}
+
+UnrolledList::Chunk* UnrolledList::linkChunkAfter(Chunk* chunk)
+{
+    Chunk* fresh = new Chunk;
+    if (chunk == nullptr) {
+        fresh->next = headChunk;
+        if (headChunk != nullptr) {
+            headChunk->prev = fresh;
+        } else {
+            tailChunk = fresh;
+        }
+        headChunk = fresh;
+    } else {
+        fresh->prev = chunk;
+        fresh->next = chunk->next;
+        if (chunk->next != nullptr) {
+            chunk->next->prev = fresh;
+        } else {
+            tailChunk = fresh;
+        }
+        chunk->next = fresh;
+    }
+    return fresh;
+}
+
+void UnrolledList::unlinkChunk(Chunk* chunk) noexcept
+{
+    if (chunk->prev != nullptr) {
+        chunk->prev->next = chunk->next;
+    } else {
+        headChunk = chunk->next;
+    }
+    if (chunk->next != nullptr) {
+        chunk->next->prev = chunk->prev;
+    } else {
+        tailChunk = chunk->prev;
+    }
+    delete chunk;
+}
+
+void UnrolledList::moveWindow(Chunk* chunk, std::uint32_t newBegin) noexcept
+{
+    // по одной строке в сторону сдвига: слот назначения уже свободен
+    std::string* items        = chunk->items();
+    const std::uint32_t count = chunk->count();
+    if (newBegin < chunk->begin) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(items + newBegin + i)) std::string(std::move(items[chunk->begin + i]));
+            items[chunk->begin + i].~basic_string();
+        }
+    } else if (newBegin > chunk->begin) {
+        for (std::uint32_t i = count; i > 0; --i) {
+            ::new (static_cast<void*>(items + newBegin + i - 1)) std::string(std::move(items[chunk->begin + i - 1]));
+            items[chunk->begin + i - 1].~basic_string();
+        }
+    }
+    chunk->begin = newBegin;
+    chunk->end   = newBegin + count;
+}
+
+void UnrolledList::insertAt(Position position, std::string item)
+{
+    Chunk* chunk        = position.chunk;
+    std::uint32_t index = position.index;
+
+    if (chunk->count() == kChunkCapacity) {
+        // деление пополам: верхняя половина переезжает в новый блок;
+        // у полного блока окно — весь массив
+        Chunk* upper             = linkChunkAfter(chunk);
+        constexpr std::uint32_t half = kChunkCapacity / 2;
+        std::string* from        = chunk->items();
+        std::string* to          = upper->items();
+        for (std::uint32_t i = half; i < kChunkCapacity; ++i) {
+            ::new (static_cast<void*>(to + i - half)) std::string(std::move(from[i]));
+            from[i].~basic_string();
+        }
+        upper->end = kChunkCapacity - half;
+        chunk->end = half;
+        if (index > half) {
+            chunk = upper;
+            index -= half;
+        }
+    }
+
+    // сдвигается меньшая сторона, если за ней есть свободный слот
+    std::string* items        = chunk->items();
+    const std::uint32_t count = chunk->count();
+    const std::uint32_t at    = chunk->begin + index;
+    const bool towardEnd      = chunk->end < kChunkCapacity && (chunk->begin == 0 || index >= count / 2);
+    if (towardEnd) {
+        if (at == chunk->end) {
+            ::new (static_cast<void*>(items + at)) std::string(std::move(item));
+        } else {
+            ::new (static_cast<void*>(items + chunk->end)) std::string(std::move(items[chunk->end - 1]));
+            std::move_backward(items + at, items + chunk->end - 1, items + chunk->end);
+            items[at] = std::move(item);
+        }
+        ++chunk->end;
+    } else {
+        if (index == 0) {
+            ::new (static_cast<void*>(items + at - 1)) std::string(std::move(item));
+        } else {
+            ::new (static_cast<void*>(items + chunk->begin - 1)) std::string(std::move(items[chunk->begin]));
+            std::move(items + chunk->begin + 1, items + at, items + chunk->begin);
+            items[at - 1] = std::move(item);
+        }
+        --chunk->begin;
+    }
+    ++sizeValue;
+}
+
+void UnrolledList::eraseAt(Position position) noexcept
+{
+    Chunk* chunk       = position.chunk;
+    std::string* items = chunk->items();
+    const std::uint32_t at = chunk->begin + position.index;
+    if (position.index < chunk->count() / 2) {
+        // ближе к началу: окно сжимается слева, у головы — без сдвига
+        std::move_backward(items + chunk->begin, items + at, items + at + 1);
+        items[chunk->begin].~basic_string();
+        ++chunk->begin;
+    } else {
+        std::move(items + at + 1, items + chunk->end, items + at);
+        items[chunk->end - 1].~basic_string();
+        --chunk->end;
+    }
+    --sizeValue;
+
+    if (chunk->count() == 0) {
+        unlinkChunk(chunk);
+    } else {
+        mergeIfSparse(chunk);
+    }
+}
+
+UnrolledList::Chunk* UnrolledList::mergeIfSparse(Chunk* chunk) noexcept
+{
+    // блок меньше чем на четверть заполнен — сливаем с соседом, если влезает
+    if (chunk->count() >= kChunkCapacity / 4) {
+        return chunk;
+    }
+
+    Chunk* into   = chunk;
+    Chunk* merged = chunk->next;
+    if (merged == nullptr || chunk->count() + merged->count() > kChunkCapacity) {
+        merged = chunk;
+        into   = chunk->prev;
+        if (into == nullptr || into->count() + chunk->count() > kChunkCapacity) {
+            return chunk;
+        }
+    }
+
+    // элементы merged дописываются за окном into
+    if (into->end + merged->count() > kChunkCapacity) {
+        moveWindow(into, 0);
+    }
+    std::string* from = merged->items();
+    std::string* to   = into->items();
+    for (std::uint32_t i = merged->begin; i < merged->end; ++i) {
+        ::new (static_cast<void*>(to + into->end)) std::string(std::move(from[i]));
+        from[i].~basic_string();
+        ++into->end;
+    }
+    merged->begin = merged->end = 0;
+    unlinkChunk(merged);
+    return into;
+}
+
+// позиции
+
+UnrolledList::Position UnrolledList::firstPosition() const noexcept
+{
+    return Position{headChunk, 0};
+}
+
+UnrolledList::Position UnrolledList::nextPosition(Position position) noexcept
+{
+    if (position.index + 1 < position.chunk->count()) {
+        return Position{position.chunk, position.index + 1};
+    }
+    return Position{position.chunk->next, 0};
+}
+
+UnrolledList::Position UnrolledList::prevPosition(Position position) noexcept
+{
+    if (position.index > 0) {
+        return Position{position.chunk, position.index - 1};
+    }
+    Chunk* previous = position.chunk->prev;
+    return previous == nullptr ? Position{} : Position{previous, previous->count() - 1};
+}
+
+UnrolledList::Position UnrolledList::find(const std::string& value, Position from) const noexcept
+{
+    for (Chunk* chunk = from.chunk; chunk != nullptr; chunk = chunk->next) {
+        const std::string* items = chunk->items() + chunk->begin;
+        const std::uint32_t start = chunk == from.chunk ? from.index : 0;
+        for (std::uint32_t i = start; i < chunk->count(); ++i) {
+            if (items[i] == value) {
+                return Position{chunk, i};
+            }
+        }
+    }
+    return Position{};
+}
+
+// базовые операции
+
+void UnrolledList::pushFront(const std::string& value)
+{
+    std::string item(value);   // до изменений списка: value может лежать в нём
+    if (headChunk == nullptr || headChunk->begin == 0) {
+        // слева нет места: полупустой блок сдвигается вправо, иначе новый
+        // блок с окном у правого края
+        if (headChunk != nullptr && headChunk->count() <= kChunkCapacity / 2) {
+            moveWindow(headChunk, kChunkCapacity - headChunk->count());
+        } else {
+            Chunk* fresh = linkChunkAfter(nullptr);
+            fresh->begin = fresh->end = kChunkCapacity;
+        }
+    }
+    insertAt(Position{headChunk, 0}, std::move(item));
+}
+
+void UnrolledList::pushBack(const std::string& value)
+{
+    std::string item(value);
+    if (tailChunk == nullptr || tailChunk->end == kChunkCapacity) {
+        if (tailChunk != nullptr && tailChunk->count() <= kChunkCapacity / 2) {
+            moveWindow(tailChunk, 0);
+        } else {
+            linkChunkAfter(tailChunk);
+        }
+    }
+    insertAt(Position{tailChunk, tailChunk->count()}, std::move(item));
+}
+
+void UnrolledList::popFront()
+{
+    if (headChunk != nullptr) {
+        eraseAt(Position{headChunk, 0});
+    }
+}
+
+void UnrolledList::popBack()
+{
+    if (tailChunk != nullptr) {
+        eraseAt(Position{tailChunk, tailChunk->count() - 1});
+    }
+}
+
+void UnrolledList::removeByValue(const std::string& value)
+{
+    // один проход: совпадения уничтожаются, остальное сдвигается внутри блока
+    Chunk* chunk = headChunk;
+    while (chunk != nullptr) {
+        Chunk* next        = chunk->next;
+        std::string* items = chunk->items() + chunk->begin;
+        std::uint32_t kept = 0;
+        for (std::uint32_t i = 0; i < chunk->count(); ++i) {
+            if (items[i] == value) {
+                items[i].~basic_string();
+                --sizeValue;
+            } else {
+                if (kept != i) {
+                    ::new (static_cast<void*>(items + kept)) std::string(std::move(items[i]));
+                    items[i].~basic_string();
+                }
+                ++kept;
+            }
+        }
+        chunk->end = chunk->begin + kept;
+        if (kept == 0) {
+            unlinkChunk(chunk);
+        }
+        chunk = next;
+    }
+
+    // поредевшие блоки сливаются с соседями
+    for (chunk = headChunk; chunk != nullptr; chunk = chunk->next) {
+        chunk = mergeIfSparse(chunk);
+    }
+}
+
+bool UnrolledList::contains(const std::string& value) const noexcept
+{
+    return find(value, firstPosition()).chunk != nullptr;
+}
+
+void UnrolledList::insertAfter(const std::string& afterValue, const std::string& newValue)
+{
+    const Position position = find(afterValue, firstPosition());
+    if (position.chunk != nullptr) {
+        insertAt(Position{position.chunk, position.index + 1}, newValue);
+    }
+}
+
+void UnrolledList::insertBefore(const std::string& beforeValue, const std::string& newValue)
+{
+    const Position position = find(beforeValue, firstPosition());
+    if (position.chunk != nullptr) {
+        insertAt(position, newValue);
+    }
+}
+
+void UnrolledList::removeAfter(const std::string& afterValue)
+{
+    const Position position = find(afterValue, firstPosition());
+    if (position.chunk == nullptr) {
+        return;
+    }
+    const Position following = nextPosition(position);
+    if (following.chunk != nullptr) {
+        eraseAt(following);
+    }
+}
+
+void UnrolledList::removeBefore(const std::string& beforeValue)
+{
+    // первое вхождение, у которого есть предшественник (как у List)
+    Position position = find(beforeValue, firstPosition());
+    if (position.chunk != nullptr && position.chunk == headChunk && position.index == 0) {
+        const Position following = nextPosition(position);
+        position = following.chunk == nullptr ? Position{} : find(beforeValue, following);
+    }
+    if (position.chunk != nullptr) {
+        eraseAt(prevPosition(position));
+    }
+}
+
+std::size_t UnrolledList::size() const noexcept
+{
+    return sizeValue;
+}
+
+bool UnrolledList::empty() const noexcept
+{
+    return sizeValue == 0;
+}
+
+std::size_t UnrolledList::memoryUsage() const noexcept
+{
+    std::size_t total = sizeof(UnrolledList);
+    for (const Chunk* chunk = headChunk; chunk != nullptr; chunk = chunk->next) {
+        total += memory_usage::heapBlock(sizeof(Chunk));
+        const std::string* items = chunk->items();
+        for (std::uint32_t i = chunk->begin; i < chunk->end; ++i) {
+            total += memory_usage::stringHeap(items[i]);
+        }
+    }
+    return total;
+}
+
+void UnrolledList::print() const
+{
+    std::cout << '[';
+    for (ConstIterator it = begin(); it != end();) {
+        std::cout << *it;
+        if (++it != end()) {
+            std::cout << "<->";
+        }
+    }
+    std::cout << "]\n";
+}
+
+// итераторы
+
+UnrolledList::ConstIterator UnrolledList::begin() const noexcept
+{
+    return ConstIterator(firstPosition());
+}
+
+UnrolledList::ConstIterator UnrolledList::end() const noexcept
+{
+    return ConstIterator(Position{});
+}
+
+const std::string& UnrolledList::ConstIterator::operator*() const noexcept
+{
+    return at.chunk->items()[at.chunk->begin + at.index];
+}
+
+const std::string* UnrolledList::ConstIterator::operator->() const noexcept
+{
+    return at.chunk->items() + at.chunk->begin + at.index;
+}
+
+UnrolledList::ConstIterator& UnrolledList::ConstIterator::operator++() noexcept
+{
+    at = nextPosition(at);
+    return *this;
+}
+
+UnrolledList::ConstIterator UnrolledList::ConstIterator::operator++(int) noexcept
+{
+    ConstIterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+bool UnrolledList::ConstIterator::operator==(const ConstIterator& other) const noexcept
+{
+    return at.chunk == other.at.chunk && at.index == other.at.index;
+}
+
+bool UnrolledList::ConstIterator::operator!=(const ConstIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+// текстовая сериализация
+
+void UnrolledList::serializeText(std::ostream& outputStream) const
+{
+    for (const std::string& value : *this) {
+        outputStream << value << '\n';
+    }
+}
+
+void UnrolledList::deserializeText(std::istream& inputStream)
+{
+    clear();
+
+    std::string line;
+    while (std::getline(inputStream, line)) {
+        if (!line.empty()) {
+            pushBack(line);
+        }
+    }
+}
+
+std::string UnrolledList::serialize() const
+{
+    std::ostringstream output;
+    serializeText(output);
+    return output.str();
+}
+
+void UnrolledList::deserialize(const std::string& text)
+{
+    std::istringstream input(text);
+    deserializeText(input);
+}
+
+// бинарная сериализация
+
+void UnrolledList::serializeBinary(std::ostream& outputStream) const
+{
+    std::uint64_t count = static_cast<std::uint64_t>(sizeValue);
+    outputStream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    for (const std::string& value : *this) {
+        std::uint64_t length = static_cast<std::uint64_t>(value.size());
+        outputStream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        if (length > 0) {
+            outputStream.write(value.data(), static_cast<std::streamsize>(length));
+        }
+    }
+
+    if (!outputStream) {
+        throw std::runtime_error("UnrolledList::serializeBinary: ERROR");
+    }
+}
+
+void UnrolledList::deserializeBinary(std::istream& inputStream)
+{
+    clear();
+
+    std::uint64_t count = 0;
+    inputStream.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!inputStream) {
+        throw std::runtime_error("UnrolledList::deserializeBinary: ERROR");
+    }
+
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t length = 0;
+        inputStream.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!inputStream) {
+            throw std::runtime_error("UnrolledList::deserializeBinary: ERROR");
+        }
+
+        std::string value;
+        value.resize(static_cast<std::size_t>(length));
+        if (length > 0) {
+            inputStream.read(value.data(), static_cast<std::streamsize>(length));
+            if (!inputStream) {
+                throw std::runtime_error("UnrolledList::deserializeBinary: ERROR");
+            }
+        }
+        pushBack(value);
+    }
+}
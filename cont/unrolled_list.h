@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+
+//  UnrolledList — двусвязный список блоков по kChunkCapacity строк
+//
+//  Операции и форматы сериализации — как у List, но элементы лежат блоками:
+//  одна аллокация на блок, проход и поиск читают строки подряд. Живые
+//  слоты блока — окно [begin, end), как у Queue: добавление и удаление у
+//  концов списка — O(1), внутри блока сдвигается меньшая сторона. Полный
+//  блок при вставке делится пополам, почти пустой при удалении сливается
+//  с соседом.
+//  Узлов наружу нет: вместо findNode — contains и итераторы.
+//  Отдельный контейнер: своего вида записи и команд в DBMS у него нет.
+
+class UnrolledList
+{
+public:
+    UnrolledList() noexcept = default;
+    ~UnrolledList();
+
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+    UnrolledList(UnrolledList&&) = delete;
+    UnrolledList& operator=(UnrolledList&&) = delete;
+
+    void pushFront(const std::string& value);
+    void pushBack(const std::string& value);
+    void popFront();
+    void popBack();
+    void removeByValue(const std::string& value);
+    [[nodiscard]] bool contains(const std::string& value) const noexcept;
+    void insertAfter(const std::string& afterValue, const std::string& newValue);
+    void insertBefore(const std::string& beforeValue, const std::string& newValue);
+    void removeAfter(const std::string& afterValue);
+    void removeBefore(const std::string& beforeValue);
+    void print() const;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты: объект + куча
+
+    // Обход; любое изменение списка делает итераторы недействительными
+    class ConstIterator;
+
+    [[nodiscard]] ConstIterator begin() const noexcept;
+    [[nodiscard]] ConstIterator end() const noexcept;
+
+    // текстовая сериализация (как у List)
+    [[nodiscard]] std::string serialize() const;
+    void deserialize(const std::string& text);
+
+    void serializeText(std::ostream& outputStream) const;
+    void deserializeText(std::istream& inputStream);
+
+    // бинарная сериализация (как у List)
+    void serializeBinary(std::ostream& outputStream) const;
+    void deserializeBinary(std::istream& inputStream);
+
+private:
+    static constexpr std::uint32_t kChunkCapacity = 32;
+
+    struct Chunk
+    {
+        Chunk*        prev{nullptr};
+        Chunk*        next{nullptr};
+        std::uint32_t begin{0};   // первый живой слот
+        std::uint32_t end{0};     // за последним живым слотом
+        alignas(std::string) unsigned char storage[kChunkCapacity * sizeof(std::string)];
+
+        [[nodiscard]] std::string* items() noexcept;   // слоты с нулевого
+        [[nodiscard]] const std::string* items() const noexcept;
+        [[nodiscard]] std::uint32_t count() const noexcept { return end - begin; }
+    };
+
+    // позиция элемента: блок и номер среди живых слотов (от begin)
+    struct Position
+    {
+        Chunk*        chunk{nullptr};
+        std::uint32_t index{0};
+    };
+
+    Chunk*      headChunk{nullptr};
+    Chunk*      tailChunk{nullptr};
+    std::size_t sizeValue{0};
+
+    void clear() noexcept;
+
+    Chunk* linkChunkAfter(Chunk* chunk);        // новый пустой блок; nullptr — в голову
+    void unlinkChunk(Chunk* chunk) noexcept;    // блок уже пуст
+    static void moveWindow(Chunk* chunk, std::uint32_t newBegin) noexcept;   // окно целиком на newBegin
+    // item уже скопирован: при нехватке памяти список не меняется
+    void insertAt(Position position, std::string item);
+    void eraseAt(Position position) noexcept;
+    // возвращает блок, в котором теперь лежат элементы chunk
+    Chunk* mergeIfSparse(Chunk* chunk) noexcept;
+
+    [[nodiscard]] Position find(const std::string& value, Position from) const noexcept;
+    [[nodiscard]] Position firstPosition() const noexcept;
+    [[nodiscard]] static Position nextPosition(Position position) noexcept;
+    [[nodiscard]] static Position prevPosition(Position position) noexcept;
+};
+
+
+//  UnrolledList::ConstIterator — проход по блокам
+
+class UnrolledList::ConstIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const std::string*;
+    using reference         = const std::string&;
+
+    ConstIterator() noexcept = default;
+
+    [[nodiscard]] const std::string& operator*() const noexcept;
+    [[nodiscard]] const std::string* operator->() const noexcept;
+    ConstIterator& operator++() noexcept;
+    ConstIterator operator++(int) noexcept;
+
+    [[nodiscard]] bool operator==(const ConstIterator& other) const noexcept;
+    [[nodiscard]] bool operator!=(const ConstIterator& other) const noexcept;
+
+private:
+    friend class UnrolledList;
+
+    explicit ConstIterator(Position position) noexcept : at(position) {}
+
+    Position at;
+};
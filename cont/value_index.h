@@ -0,0 +1,132 @@
+#pragma once
+
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//  ValueIndex — хеш-индекс «значение → узлы» для списков
+//
+//  Владелец добавляет каждый новый узел и убирает каждый удаляемый, поэтому
+//  поиск узла по значению — O(1) в среднем вместо прохода со сравнением
+//  строк. Ключ — string_view на значение одного из узлов записи; когда этот
+//  узел уходит, ключ перевешивается на оставшийся. Порядок повторов в записи
+//  не совпадает со списочным: первое вхождение повторяющегося значения
+//  владелец ищет проходом. Неактивный (по умолчанию) индекс пуст.
+//  Node — узел с getValue().
+
+template <class Node>
+class ValueIndex
+{
+public:
+    // узлы со значением: first и повторы в more
+    struct Entry
+    {
+        Node* first{nullptr};
+        std::vector<Node*> more;
+
+        [[nodiscard]] bool unique() const noexcept { return more.empty(); }
+    };
+
+    [[nodiscard]] bool active() const noexcept { return isActive; }
+    void activate() noexcept { isActive = true; }
+    // выключить и освободить память
+    void disable() noexcept
+    {
+        std::unordered_map<std::string_view, Entry>().swap(entries);
+        isActive = false;
+    }
+    void clear() noexcept { entries.clear(); }
+
+    void add(Node* node);
+    void remove(Node* node) noexcept;
+    [[nodiscard]] const Entry* find(std::string_view value) const noexcept;
+
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;   // байты кучи
+
+    void swap(ValueIndex& other) noexcept
+    {
+        entries.swap(other.entries);
+        std::swap(isActive, other.isActive);
+    }
+
+private:
+    std::unordered_map<std::string_view, Entry> entries;
+    bool isActive{false};
+};
+
+template <class Node>
+void ValueIndex<Node>::add(Node* node)
+{
+    const auto [it, inserted] = entries.try_emplace(node->getValue());
+    if (inserted) {
+        it->second.first = node;
+    } else {
+        it->second.more.push_back(node);
+    }
+}
+
+template <class Node>
+void ValueIndex<Node>::remove(Node* node) noexcept
+{
+    const auto it = entries.find(node->getValue());
+    if (it == entries.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (entry.first == node) {
+        if (entry.more.empty()) {
+            entries.erase(it);
+            return;
+        }
+        entry.first = entry.more.back();
+        entry.more.pop_back();
+    } else {
+        const auto pos = std::find(entry.more.begin(), entry.more.end(), node);
+        if (pos == entry.more.end()) {
+            return;
+        }
+        *pos = entry.more.back();
+        entry.more.pop_back();
+    }
+
+    // ключ смотрел на строку уходящего узла: перевешиваем на first; число
+    // элементов не меняется, поэтому перехеширования нет
+    if (it->first.data() == node->getValue().data()) {
+        auto handle = entries.extract(it);
+        handle.key() = handle.mapped().first->getValue();
+        entries.insert(std::move(handle));
+    }
+}
+
+template <class Node>
+auto ValueIndex<Node>::find(std::string_view value) const noexcept -> const Entry*
+{
+    const auto it = entries.find(value);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+template <class Node>
+std::size_t ValueIndex<Node>::memoryUsage() const noexcept
+{
+    // модель libstdc++: массив корзин (одна корзина встроена в объект) и
+    // по узлу на запись — указатель next, пара и кешированный хеш
+    std::size_t total = 0;
+    if (entries.bucket_count() > 1) {
+        total += memory_usage::heapBlock(entries.bucket_count() * sizeof(void*));
+    }
+    const std::size_t nodeBytes =
+        sizeof(void*) + sizeof(std::pair<const std::string_view, Entry>) + sizeof(std::size_t);
+    for (const auto& item : entries) {
+        total += memory_usage::heapBlock(nodeBytes);
+        if (item.second.more.capacity() > 0) {
+            total += memory_usage::heapBlock(item.second.more.capacity() * sizeof(Node*));
+        }
+    }
+    return total;
+}
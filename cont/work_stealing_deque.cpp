@@ -0,0 +1,169 @@
+#include "work_stealing_deque.h"
+#include "memory_usage.h"
+
+#include <memory>
+#include <utility>
+
+//  Порядок памяти — по Ле, Поп, Коэн, Нардели (2013), но вместо отдельных
+//  барьеров критичные операции с top и bottom — seq_cst: так pop и steal
+//  не могут оба не увидеть запись друг друга у последнего элемента.
+
+// кольцо
+
+WorkStealingDeque::Ring::Ring(std::size_t capacity)
+    : mask(capacity - 1),
+      slots(capacity)
+{
+}
+
+std::string* WorkStealingDeque::Ring::get(std::int64_t index) const noexcept
+{
+    return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+}
+
+void WorkStealingDeque::Ring::put(std::int64_t index, std::string* task) noexcept
+{
+    slots[static_cast<std::size_t>(index) & mask].store(task, std::memory_order_relaxed);
+}
+
+// конструктор / деструктор
+
+WorkStealingDeque::WorkStealingDeque(std::size_t initialCapacity)
+{
+    std::size_t capacity = 2;
+    while (capacity < initialCapacity) {
+        capacity *= 2;
+    }
+    ring.store(new Ring(capacity), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque()
+{
+    Ring* current = ring.load(std::memory_order_relaxed);
+    const std::int64_t last = bottom.load(std::memory_order_relaxed);
+    for (std::int64_t i = top.load(std::memory_order_relaxed); i < last; ++i) {
+        delete current->get(i);
+    }
+    delete current;
+    for (Ring* old : retired) {
+        delete old;
+    }
+}
+
+WorkStealingDeque::Ring* WorkStealingDeque::grow(Ring* current, std::int64_t from, std::int64_t to)
+{
+    auto bigger = std::make_unique<Ring>((current->mask + 1) * 2);
+    for (std::int64_t i = from; i < to; ++i) {
+        bigger->put(i, current->get(i));
+    }
+    retired.push_back(current);   // может бросить — до публикации нового кольца
+    Ring* published = bigger.release();
+    ring.store(published, std::memory_order_release);
+    return published;
+}
+
+// операции владельца
+
+void WorkStealingDeque::push(std::string task)
+{
+    const std::int64_t b = bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = top.load(std::memory_order_acquire);
+    Ring* current = ring.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::int64_t>(current->mask)) {
+        current = grow(current, t, b);
+    }
+
+    auto owned = std::make_unique<std::string>(std::move(task));
+    current->put(b, owned.release());
+    // release публикует и слот, и саму строку для воров
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+bool WorkStealingDeque::pop(std::string& out)
+{
+    const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Ring* current = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_seq_cst);
+
+    if (t > b) {
+        // пуст
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::string* task = current->get(b);
+    if (t == b) {
+        // последний элемент: спорим с ворами за top
+        const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        if (!won) {
+            return false;
+        }
+    }
+
+    out = std::move(*task);
+    delete task;
+    return true;
+}
+
+// кража
+
+bool WorkStealingDeque::steal(std::string& out)
+{
+    std::int64_t t = top.load(std::memory_order_seq_cst);
+    const std::int64_t b = bottom.load(std::memory_order_seq_cst);
+    if (t >= b) {
+        return false;
+    }
+
+    Ring* current = ring.load(std::memory_order_acquire);
+    std::string* task = current->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // после успешного CAS задача принадлежит только этому потоку
+    out = std::move(*task);
+    delete task;
+    return true;
+}
+
+// размер и память
+
+std::size_t WorkStealingDeque::size() const noexcept
+{
+    const std::int64_t t = top.load(std::memory_order_seq_cst);
+    const std::int64_t b = bottom.load(std::memory_order_seq_cst);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+}
+
+bool WorkStealingDeque::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::size_t WorkStealingDeque::memoryUsage() const noexcept
+{
+    const auto ringBytes = [](const Ring* r) {
+        return memory_usage::heapBlock(sizeof(Ring))
+             + memory_usage::heapBlock(r->slots.size() * sizeof(std::atomic<std::string*>));
+    };
+
+    const Ring* current = ring.load(std::memory_order_relaxed);
+    std::size_t total = sizeof(WorkStealingDeque) + ringBytes(current);
+    for (const Ring* old : retired) {
+        total += ringBytes(old);
+    }
+    if (retired.capacity() > 0) {
+        total += memory_usage::heapBlock(retired.capacity() * sizeof(Ring*));
+    }
+
+    const std::int64_t last = bottom.load(std::memory_order_relaxed);
+    for (std::int64_t i = top.load(std::memory_order_relaxed); i < last; ++i) {
+        const std::string* task = current->get(i);
+        total += memory_usage::heapBlock(sizeof(std::string)) + memory_usage::stringHeap(*task);
+    }
+    return total;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  WorkStealingDeque — дек Чейза–Лева для пула потоков
+//
+//  Владелец кладёт и забирает задачи с нижнего конца, как у Stack: свежие
+//  задачи горячие в кеше, и без соперников push/pop обходятся без CAS.
+//  Остальные потоки крадут с верхнего конца в порядке Queue; CAS нужен
+//  только на последнем элементе и при краже. Задачи — строки; в кольце
+//  лежат указатели на них, поэтому вор не читает строку, которую владелец
+//  может перезаписать. При росте кольца старое остаётся жить до
+//  разрушения дека: вор мог успеть его прочитать.
+
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(std::size_t initialCapacity = 64);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    // только поток-владелец
+    void push(std::string task);
+    [[nodiscard]] bool pop(std::string& out);     // false, если пуст
+
+    // любой поток; false — пуст или задачу забрал другой поток
+    [[nodiscard]] bool steal(std::string& out);
+
+    [[nodiscard]] std::size_t size() const noexcept;   // оценка при работающих ворах
+    [[nodiscard]] bool empty() const noexcept;
+    // байты: объект + куча; только когда другие потоки не трогают дек
+    [[nodiscard]] std::size_t memoryUsage() const noexcept;
+
+private:
+    struct Ring
+    {
+        explicit Ring(std::size_t capacity);
+
+        std::size_t mask;
+        std::vector<std::atomic<std::string*>> slots;
+
+        [[nodiscard]] std::string* get(std::int64_t index) const noexcept;
+        void put(std::int64_t index, std::string* task) noexcept;
+    };
+
+    alignas(64) std::atomic<std::int64_t> top{0};      // крадут отсюда
+    alignas(64) std::atomic<std::int64_t> bottom{0};   // владелец
+    std::atomic<Ring*> ring;
+    std::vector<Ring*> retired;                        // старые кольца, только владелец
+
+    Ring* grow(Ring* current, std::int64_t from, std::int64_t to);
+};
@@ -1,17 +1,25 @@
 // serialize_cli.cpp
 #include "cont/array.h"
+#include "cont/compact_string_array.h"
 #include "cont/forward_list.h"
 #include "cont/list.h"
 #include "cont/stack.h"
 #include "cont/queue.h"
+#include "cont/concurrent_queue.h"
+#include "cont/priority_queue.h"
 #include "cont/hashtable.h"
 #include "cont/avltree.h"
+#include "cont/bplus_tree.h"
+#include "cont/persistent_avltree.h"
+#include "cont/string_pool.h"
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <stdexcept>
 #include <string>
 #include <cstdint>
+#include <vector>
 
 // =======================
 // Типы структур данных
@@ -26,7 +34,13 @@ enum class DSKind
     QUEUE,
     AVL,
     HCHAIN, // цепная хеш-таблица
-    HOPEN   // хеш-таблица с открытой адресацией
+    HOPEN,  // хеш-таблица с открытой адресацией
+    BTREE,  // B+-дерево
+    PAVL,   // персистентное AVL-дерево
+    CARRAY, // компактный массив строк (только чтение)
+    SPSC,   // очередь без блокировок: один производитель, один потребитель
+    MPMC,   // очередь без блокировок: много производителей и потребителей
+    PQUEUE  // очередь с приоритетами (4-арная куча)
 };
 
 struct DSRecord
@@ -64,6 +78,9 @@ private:
     int       find(const std::string& name) const;
     DSRecord* add(const std::string& name, DSKind kind);
 
+    static const char* kindName(DSKind kind);
+    static std::size_t memoryOf(const DSRecord& rec);
+
 private:
     DSRecord recs[MAX_DS];
     int      count;
@@ -111,6 +128,24 @@ void DBMS::clear()
         case DSKind::HOPEN:
             delete static_cast<HashTableOpen*>(recs[i].ptr);
             break;
+        case DSKind::BTREE:
+            delete static_cast<BPlusTree*>(recs[i].ptr);
+            break;
+        case DSKind::PAVL:
+            delete static_cast<PersistentAvlTree*>(recs[i].ptr);
+            break;
+        case DSKind::CARRAY:
+            delete static_cast<CompactStringArray*>(recs[i].ptr);
+            break;
+        case DSKind::SPSC:
+            delete static_cast<SpscQueue*>(recs[i].ptr);
+            break;
+        case DSKind::MPMC:
+            delete static_cast<MpmcQueue*>(recs[i].ptr);
+            break;
+        case DSKind::PQUEUE:
+            delete static_cast<PriorityQueue*>(recs[i].ptr);
+            break;
         }
     }
     count = 0;
@@ -160,12 +195,86 @@ DSRecord* DBMS::add(const std::string& name, DSKind kind)
     case DSKind::HOPEN:
         recs[count].ptr = new HashTableOpen();
         break;
+    case DSKind::BTREE:
+        recs[count].ptr = new BPlusTree();
+        break;
+    case DSKind::PAVL:
+        recs[count].ptr = new PersistentAvlTree();
+        break;
+    case DSKind::CARRAY:
+        recs[count].ptr = new CompactStringArray();
+        break;
+    case DSKind::SPSC:
+        recs[count].ptr = new SpscQueue();
+        break;
+    case DSKind::MPMC:
+        recs[count].ptr = new MpmcQueue();
+        break;
+    case DSKind::PQUEUE:
+        recs[count].ptr = new PriorityQueue();
+        break;
     }
 
     ++count;
     return &recs[count - 1];
 }
 
+const char* DBMS::kindName(DSKind kind)
+{
+    switch (kind) {
+    case DSKind::ARRAY:  return "ARRAY";
+    case DSKind::FLIST:  return "FLIST";
+    case DSKind::LLIST:  return "LLIST";
+    case DSKind::STACK:  return "STACK";
+    case DSKind::QUEUE:  return "QUEUE";
+    case DSKind::AVL:    return "AVL";
+    case DSKind::HCHAIN: return "HCHAIN";
+    case DSKind::HOPEN:  return "HOPEN";
+    case DSKind::BTREE:  return "BTREE";
+    case DSKind::PAVL:   return "PAVL";
+    case DSKind::CARRAY: return "CARRAY";
+    case DSKind::SPSC:   return "SPSC";
+    case DSKind::MPMC:   return "MPMC";
+    case DSKind::PQUEUE: return "PQUEUE";
+    }
+    return "?";
+}
+
+std::size_t DBMS::memoryOf(const DSRecord& rec)
+{
+    switch (rec.kind) {
+    case DSKind::ARRAY:
+        return static_cast<MyArray*>(rec.ptr)->memoryUsage();
+    case DSKind::FLIST:
+        return static_cast<ForwardList*>(rec.ptr)->memoryUsage();
+    case DSKind::LLIST:
+        return static_cast<List*>(rec.ptr)->memoryUsage();
+    case DSKind::STACK:
+        return static_cast<Stack*>(rec.ptr)->memoryUsage();
+    case DSKind::QUEUE:
+        return static_cast<Queue*>(rec.ptr)->memoryUsage();
+    case DSKind::AVL:
+        return static_cast<AvlTree*>(rec.ptr)->memoryUsage();
+    case DSKind::HCHAIN:
+        return static_cast<HashTable*>(rec.ptr)->memoryUsage();
+    case DSKind::HOPEN:
+        return static_cast<HashTableOpen*>(rec.ptr)->memoryUsage();
+    case DSKind::BTREE:
+        return static_cast<BPlusTree*>(rec.ptr)->memoryUsage();
+    case DSKind::PAVL:
+        return static_cast<PersistentAvlTree*>(rec.ptr)->memoryUsage();
+    case DSKind::CARRAY:
+        return static_cast<CompactStringArray*>(rec.ptr)->memoryUsage();
+    case DSKind::SPSC:
+        return static_cast<SpscQueue*>(rec.ptr)->memoryUsage();
+    case DSKind::MPMC:
+        return static_cast<MpmcQueue*>(rec.ptr)->memoryUsage();
+    case DSKind::PQUEUE:
+        return static_cast<PriorityQueue*>(rec.ptr)->memoryUsage();
+    }
+    return 0;
+}
+
 // =======================
 // Текстовая сериализация
 // Формат:
@@ -236,6 +345,30 @@ void DBMS::load(const std::string& filename)
             auto* ho = new HashTableOpen();
             ho->deserialize(content);
             recs[count++] = DSRecord{name, DSKind::HOPEN, ho};
+        } else if (type == "BTREE") {
+            auto* bt = new BPlusTree();
+            bt->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::BTREE, bt};
+        } else if (type == "PAVL") {
+            auto* pt = new PersistentAvlTree();
+            pt->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::PAVL, pt};
+        } else if (type == "CARRAY") {
+            auto* ca = new CompactStringArray();
+            ca->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::CARRAY, ca};
+        } else if (type == "SPSC") {
+            auto* sq = new SpscQueue();
+            sq->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::SPSC, sq};
+        } else if (type == "MPMC") {
+            auto* mq = new MpmcQueue();
+            mq->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::MPMC, mq};
+        } else if (type == "PQUEUE") {
+            auto* pq = new PriorityQueue();
+            pq->deserialize(content);
+            recs[count++] = DSRecord{name, DSKind::PQUEUE, pq};
         }
 
         if (count >= MAX_DS) {
@@ -288,6 +421,30 @@ void DBMS::save(const std::string& filename) const
             type = "HOPEN";
             data = static_cast<HashTableOpen*>(recs[i].ptr)->serialize();
             break;
+        case DSKind::BTREE:
+            type = "BTREE";
+            data = static_cast<BPlusTree*>(recs[i].ptr)->serialize();
+            break;
+        case DSKind::PAVL:
+            type = "PAVL";
+            data = static_cast<PersistentAvlTree*>(recs[i].ptr)->serialize();
+            break;
+        case DSKind::CARRAY:
+            type = "CARRAY";
+            data = static_cast<CompactStringArray*>(recs[i].ptr)->serialize();
+            break;
+        case DSKind::SPSC:
+            type = "SPSC";
+            data = static_cast<SpscQueue*>(recs[i].ptr)->serialize();
+            break;
+        case DSKind::MPMC:
+            type = "MPMC";
+            data = static_cast<MpmcQueue*>(recs[i].ptr)->serialize();
+            break;
+        case DSKind::PQUEUE:
+            type = "PQUEUE";
+            data = static_cast<PriorityQueue*>(recs[i].ptr)->serialize();
+            break;
         }
 
         fout << type << ' ' << recs[i].name << '\n';
@@ -356,6 +513,28 @@ void DBMS::saveBinary(const std::string& filename) const
         case DSKind::HOPEN:
             static_cast<HashTableOpen*>(recs[i].ptr)->serializeBinary(buf);
             break;
+        case DSKind::BTREE:
+            static_cast<BPlusTree*>(recs[i].ptr)->serializeBinary(buf);
+            break;
+        case DSKind::PAVL: {
+            // снапшот версии за O(1): запись идёт по неизменяемым узлам,
+            // дальнейшие изменения дерева её не затрагивают
+            const PersistentAvlTree snapshot(*static_cast<PersistentAvlTree*>(recs[i].ptr));
+            snapshot.serializeBinary(buf);
+            break;
+        }
+        case DSKind::CARRAY:
+            static_cast<CompactStringArray*>(recs[i].ptr)->serializeBinary(buf);
+            break;
+        case DSKind::SPSC:
+            static_cast<SpscQueue*>(recs[i].ptr)->serializeBinary(buf);
+            break;
+        case DSKind::MPMC:
+            static_cast<MpmcQueue*>(recs[i].ptr)->serializeBinary(buf);
+            break;
+        case DSKind::PQUEUE:
+            static_cast<PriorityQueue*>(recs[i].ptr)->serializeBinary(buf);
+            break;
         }
 
         const std::string bytes = buf.str();
@@ -456,6 +635,42 @@ void DBMS::loadBinary(const std::string& filename)
             ptr = h;
             break;
         }
+        case DSKind::BTREE: {
+            auto* b = new BPlusTree();
+            b->deserializeBinary(buf);
+            ptr = b;
+            break;
+        }
+        case DSKind::PAVL: {
+            auto* p = new PersistentAvlTree();
+            p->deserializeBinary(buf);
+            ptr = p;
+            break;
+        }
+        case DSKind::CARRAY: {
+            auto* c = new CompactStringArray();
+            c->deserializeBinary(buf);
+            ptr = c;
+            break;
+        }
+        case DSKind::SPSC: {
+            auto* q = new SpscQueue();
+            q->deserializeBinary(buf);
+            ptr = q;
+            break;
+        }
+        case DSKind::MPMC: {
+            auto* q = new MpmcQueue();
+            q->deserializeBinary(buf);
+            ptr = q;
+            break;
+        }
+        case DSKind::PQUEUE: {
+            auto* q = new PriorityQueue();
+            q->deserializeBinary(buf);
+            ptr = q;
+            break;
+        }
         }
 
         recs[count++] = DSRecord{name, kind, ptr};
@@ -490,7 +705,27 @@ void DBMS::execute(const std::string& query)
         this->saveBinary("db_autosave.bin");
     };
 
+    // запись нужного вида: существующая или новая; nullptr — другой вид
+    // или нет места
+    auto typedRecord = [this](const std::string& name, DSKind kind, bool create) -> void* {
+        int idx = find(name);
+        if (idx != -1) return recs[idx].kind == kind ? recs[idx].ptr : nullptr;
+        if (!create) return nullptr;
+        DSRecord* rec = add(name, kind);
+        return rec != nullptr ? rec->ptr : nullptr;
+    };
+
     // ----------------- МАССИВ -----------------
+    // компактный массив только читается: правки — после MEXPAND
+    if ((cmd == "MPUSH" || cmd == "MINSERT" || cmd == "MDEL" || cmd == "MSET" || cmd == "MMODE")
+        && tokCount >= 2) {
+        int idx = find(tokens[1]);
+        if (idx != -1 && recs[idx].kind == DSKind::CARRAY) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+    }
+
     if (cmd == "MPUSH") {
         if (tokCount < 3) return;
         int idx = find(tokens[1]);
@@ -527,10 +762,13 @@ void DBMS::execute(const std::string& query)
         if (tokCount < 3) return;
         int idx = find(tokens[1]);
         if (idx == -1) return;
-        MyArray* arr = static_cast<MyArray*>(recs[idx].ptr);
         int pos = std::stoi(tokens[2]);
         try {
-            std::cout << arr->at(static_cast<std::size_t>(pos)) << '\n';
+            if (recs[idx].kind == DSKind::CARRAY) {
+                std::cout << static_cast<CompactStringArray*>(recs[idx].ptr)->at(static_cast<std::size_t>(pos)) << '\n';
+            } else {
+                std::cout << static_cast<MyArray*>(recs[idx].ptr)->at(static_cast<std::size_t>(pos)) << '\n';
+            }
         } catch (...) {
             std::cout << "<ERR>\n";
         }
@@ -538,8 +776,40 @@ void DBMS::execute(const std::string& query)
         if (tokCount < 2) return;
         int idx = find(tokens[1]);
         if (idx == -1) return;
+        if (recs[idx].kind == DSKind::CARRAY) {
+            static_cast<CompactStringArray*>(recs[idx].ptr)->print();
+        } else {
+            static_cast<MyArray*>(recs[idx].ptr)->print();
+        }
+    } else if (cmd == "MCOMPACT" || cmd == "MEXPAND") {
+        // перевод записи между изменяемым и компактным видом
+        if (tokCount < 2) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (cmd == "MCOMPACT" && recs[idx].kind == DSKind::ARRAY) {
+            auto* arr = static_cast<MyArray*>(recs[idx].ptr);
+            recs[idx].ptr = new CompactStringArray(*arr);
+            recs[idx].kind = DSKind::CARRAY;
+            delete arr;
+        } else if (cmd == "MEXPAND" && recs[idx].kind == DSKind::CARRAY) {
+            auto* compact = static_cast<CompactStringArray*>(recs[idx].ptr);
+            recs[idx].ptr = new MyArray(compact->toMyArray());
+            recs[idx].kind = DSKind::ARRAY;
+            delete compact;
+        } else {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        autoSave();
+    } else if (cmd == "MMODE") {
+        // GAP — буфер с разрывом для серий правок у одной позиции
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1 || recs[idx].kind != DSKind::ARRAY) return;
         MyArray* arr = static_cast<MyArray*>(recs[idx].ptr);
-        arr->print();
+        if (tokens[2] == "GAP")       arr->setGapBuffer(true);
+        else if (tokens[2] == "FLAT") arr->setGapBuffer(false);
+        else                          std::cout << "<ERR>\n";
     }
 
     // ----------- ОДНОСВЯЗНЫЙ СПИСОК -----------
@@ -593,6 +863,43 @@ void DBMS::execute(const std::string& query)
         ForwardList* fl = static_cast<ForwardList*>(recs[idx].ptr);
         fl->popBack();
         autoSave();
+    } else if (cmd == "FCONCAT" || cmd == "FSPLICE") {
+        // FCONCAT dst src — src в конец dst; FSPLICE dst after src — после значения after;
+        // узлы переносятся без копирования, src остаётся пустым
+        const bool splice = cmd == "FSPLICE";
+        if (tokCount < (splice ? 4 : 3)) return;
+        const std::string& srcName = tokens[splice ? 3 : 2];
+        auto* src = static_cast<ForwardList*>(typedRecord(srcName, DSKind::FLIST, false));
+        auto* dst = src != nullptr && srcName != tokens[1]
+                  ? static_cast<ForwardList*>(typedRecord(tokens[1], DSKind::FLIST, !splice))
+                  : nullptr;
+        FNode* position = dst != nullptr && splice ? dst->findNode(tokens[2]) : nullptr;
+        if (dst == nullptr || (splice && position == nullptr)) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        if (splice) dst->spliceAfter(position, *src);
+        else        dst->concat(*src);
+        autoSave();
+    } else if (cmd == "FSPLIT") {
+        // FSPLIT src index dst — элементы с номера index в конец dst
+        if (tokCount < 4) return;
+        auto* src = static_cast<ForwardList*>(typedRecord(tokens[1], DSKind::FLIST, false));
+        std::size_t index = 0;
+        try {
+            index = static_cast<std::size_t>(std::stoull(tokens[2]));
+        } catch (...) {
+            src = nullptr;
+        }
+        auto* dst = src != nullptr && tokens[3] != tokens[1]
+                  ? static_cast<ForwardList*>(typedRecord(tokens[3], DSKind::FLIST, true))
+                  : nullptr;
+        if (dst == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        src->splitAt(index, *dst);
+        autoSave();
     } else if (cmd == "FPRINT") {
         if (tokCount < 2) return;
         int idx = find(tokens[1]);
@@ -646,6 +953,43 @@ void DBMS::execute(const std::string& query)
         List* l = static_cast<List*>(recs[idx].ptr);
         l->removeBefore(tokens[2]);
         autoSave();
+    } else if (cmd == "LCONCAT" || cmd == "LSPLICE") {
+        // LCONCAT dst src — src в конец dst; LSPLICE dst before src — перед значением before;
+        // узлы переносятся без копирования, src остаётся пустым
+        const bool splice = cmd == "LSPLICE";
+        if (tokCount < (splice ? 4 : 3)) return;
+        const std::string& srcName = tokens[splice ? 3 : 2];
+        auto* src = static_cast<List*>(typedRecord(srcName, DSKind::LLIST, false));
+        auto* dst = src != nullptr && srcName != tokens[1]
+                  ? static_cast<List*>(typedRecord(tokens[1], DSKind::LLIST, !splice))
+                  : nullptr;
+        LNode* position = dst != nullptr && splice ? dst->findNode(tokens[2]) : nullptr;
+        if (dst == nullptr || (splice && position == nullptr)) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        if (splice) dst->splice(position, *src);
+        else        dst->concat(*src);
+        autoSave();
+    } else if (cmd == "LSPLIT") {
+        // LSPLIT src index dst — элементы с номера index в конец dst
+        if (tokCount < 4) return;
+        auto* src = static_cast<List*>(typedRecord(tokens[1], DSKind::LLIST, false));
+        std::size_t index = 0;
+        try {
+            index = static_cast<std::size_t>(std::stoull(tokens[2]));
+        } catch (...) {
+            src = nullptr;
+        }
+        auto* dst = src != nullptr && tokens[3] != tokens[1]
+                  ? static_cast<List*>(typedRecord(tokens[3], DSKind::LLIST, true))
+                  : nullptr;
+        if (dst == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        src->splitAt(index, *dst);
+        autoSave();
     } else if (cmd == "LPRINT") {
         if (tokCount < 2) return;
         int idx = find(tokens[1]);
@@ -661,7 +1005,10 @@ void DBMS::execute(const std::string& query)
         Stack* s;
         if (idx == -1) s = static_cast<Stack*>(add(tokens[1], DSKind::STACK)->ptr);
         else           s = static_cast<Stack*>(recs[idx].ptr);
-        s->push(tokens[2]);
+        if (!s->tryPush(tokens[2])) {
+            std::cout << "<FULL>\n";
+            return;
+        }
         autoSave();
     } else if (cmd == "SPOP") {
         if (tokCount < 2) return;
@@ -679,27 +1026,187 @@ void DBMS::execute(const std::string& query)
     }
 
     // --------------- ОЧЕРЕДЬ ---------------
-    else if (cmd == "QPUSH") {
+    else if (cmd == "QNEW") {
+        // QNEW name SPSC|MPMC [capacity] — очередь без блокировок
+        if (tokCount < 3 || find(tokens[1]) != -1) return;
+        if (count >= MAX_DS || (tokens[2] != "SPSC" && tokens[2] != "MPMC")) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        try {
+            std::size_t capacity = SpscQueue::kDefaultCapacity;
+            if (tokCount >= 4) capacity = static_cast<std::size_t>(std::stoull(tokens[3]));
+            if (tokens[2] == "SPSC") recs[count] = DSRecord{tokens[1], DSKind::SPSC, new SpscQueue(capacity)};
+            else                     recs[count] = DSRecord{tokens[1], DSKind::MPMC, new MpmcQueue(capacity)};
+            ++count;
+        } catch (...) {
+            // неразборчивая или слишком большая вместимость
+            std::cout << "<ERR>\n";
+            return;
+        }
+        autoSave();
+    } else if (cmd == "QPUSH") {
         if (tokCount < 3) return;
         int idx = find(tokens[1]);
-        Queue* q;
-        if (idx == -1) q = static_cast<Queue*>(add(tokens[1], DSKind::QUEUE)->ptr);
-        else           q = static_cast<Queue*>(recs[idx].ptr);
-        q->push(tokens[2]);
+        bool pushed = false;
+        if (idx != -1 && recs[idx].kind == DSKind::SPSC) {
+            pushed = static_cast<SpscQueue*>(recs[idx].ptr)->tryPush(tokens[2]);
+        } else if (idx != -1 && recs[idx].kind == DSKind::MPMC) {
+            pushed = static_cast<MpmcQueue*>(recs[idx].ptr)->tryPush(tokens[2]);
+        } else {
+            auto* q = static_cast<Queue*>(typedRecord(tokens[1], DSKind::QUEUE, true));
+            if (q == nullptr) {
+                std::cout << "<ERR>\n";
+                return;
+            }
+            pushed = q->tryPush(tokens[2]);
+        }
+        if (!pushed) {
+            std::cout << "<FULL>\n";
+            return;
+        }
         autoSave();
     } else if (cmd == "QPOP") {
         if (tokCount < 2) return;
         int idx = find(tokens[1]);
         if (idx == -1) return;
-        Queue* q = static_cast<Queue*>(recs[idx].ptr);
-        q->pop();
+        if (recs[idx].kind == DSKind::SPSC) {
+            std::string value;
+            if (!static_cast<SpscQueue*>(recs[idx].ptr)->tryPop(value)) return;
+        } else if (recs[idx].kind == DSKind::MPMC) {
+            std::string value;
+            if (!static_cast<MpmcQueue*>(recs[idx].ptr)->tryPop(value)) return;
+        } else if (recs[idx].kind == DSKind::QUEUE) {
+            // пустая очередь — молча, как у SPSC и MPMC
+            Queue* q = static_cast<Queue*>(recs[idx].ptr);
+            if (q->empty()) return;
+            q->pop();
+        } else {
+            std::cout << "<ERR>\n";
+            return;
+        }
         autoSave();
+    } else if (cmd == "QPUSHN") {
+        // QPUSHN name v1 v2 ... — пакет с одним автосохранением;
+        // при пределе принимается начало пакета, остальное — <FULL>
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        std::size_t pushed = 0;
+        const std::size_t total = static_cast<std::size_t>(tokCount - 2);
+        if (idx != -1 && recs[idx].kind == DSKind::SPSC) {
+            auto* q = static_cast<SpscQueue*>(recs[idx].ptr);
+            while (pushed < total && q->tryPush(tokens[2 + pushed])) ++pushed;
+        } else if (idx != -1 && recs[idx].kind == DSKind::MPMC) {
+            auto* q = static_cast<MpmcQueue*>(recs[idx].ptr);
+            while (pushed < total && q->tryPush(tokens[2 + pushed])) ++pushed;
+        } else {
+            auto* q = static_cast<Queue*>(typedRecord(tokens[1], DSKind::QUEUE, true));
+            if (q == nullptr) {
+                std::cout << "<ERR>\n";
+                return;
+            }
+            pushed = q->pushBatch(tokens + 2, tokens + tokCount);
+        }
+        if (pushed < total) {
+            std::cout << "<FULL>\n";
+        }
+        if (pushed > 0) {
+            autoSave();
+        }
+    } else if (cmd == "QPOPN") {
+        // QPOPN name N — забрать до N элементов и напечатать их
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::SPSC && recs[idx].kind != DSKind::MPMC
+            && recs[idx].kind != DSKind::QUEUE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        std::size_t maxCount = 0;
+        try {
+            maxCount = static_cast<std::size_t>(std::stoull(tokens[2]));
+        } catch (...) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        std::vector<std::string> popped;
+        std::string value;
+        if (recs[idx].kind == DSKind::SPSC) {
+            auto* q = static_cast<SpscQueue*>(recs[idx].ptr);
+            while (popped.size() < maxCount && q->tryPop(value)) popped.push_back(std::move(value));
+        } else if (recs[idx].kind == DSKind::MPMC) {
+            auto* q = static_cast<MpmcQueue*>(recs[idx].ptr);
+            while (popped.size() < maxCount && q->tryPop(value)) popped.push_back(std::move(value));
+        } else {
+            static_cast<Queue*>(recs[idx].ptr)->popBatch(maxCount, popped);
+        }
+        std::cout << '[';
+        for (std::size_t i = 0; i < popped.size(); ++i) {
+            std::cout << (i > 0 ? ", " : "") << popped[i];
+        }
+        std::cout << "]\n";
+        if (!popped.empty()) {
+            autoSave();
+        }
     } else if (cmd == "QPRINT") {
         if (tokCount < 2) return;
         int idx = find(tokens[1]);
         if (idx == -1) return;
-        Queue* q = static_cast<Queue*>(recs[idx].ptr);
-        q->print();
+        if (recs[idx].kind == DSKind::SPSC)      static_cast<SpscQueue*>(recs[idx].ptr)->print();
+        else if (recs[idx].kind == DSKind::MPMC)  static_cast<MpmcQueue*>(recs[idx].ptr)->print();
+        else if (recs[idx].kind == DSKind::QUEUE) static_cast<Queue*>(recs[idx].ptr)->print();
+        else                                      std::cout << "<ERR>\n";
+    }
+
+    // -------- ОЧЕРЕДЬ С ПРИОРИТЕТАМИ --------
+    else if (cmd == "PQPUSH") {
+        if (tokCount < 4) return;
+        int idx = find(tokens[1]);
+        if (idx != -1 && recs[idx].kind != DSKind::PQUEUE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        std::int64_t priority = 0;
+        try {
+            std::size_t parsed = 0;
+            priority = std::stoll(tokens[2], &parsed);
+            if (parsed != tokens[2].size()) throw std::invalid_argument(tokens[2]);
+        } catch (...) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        PriorityQueue* pq;
+        if (idx == -1) {
+            DSRecord* rec = add(tokens[1], DSKind::PQUEUE);
+            if (rec == nullptr) return;
+            pq = static_cast<PriorityQueue*>(rec->ptr);
+        } else {
+            pq = static_cast<PriorityQueue*>(recs[idx].ptr);
+        }
+        pq->push(priority, tokens[3]);
+        autoSave();
+    } else if (cmd == "PQPOP" || cmd == "PQPEEK") {
+        if (tokCount < 2) return;
+        int idx = find(tokens[1]);
+        if (idx == -1 || recs[idx].kind != DSKind::PQUEUE
+            || static_cast<PriorityQueue*>(recs[idx].ptr)->empty()) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        PriorityQueue* pq = static_cast<PriorityQueue*>(recs[idx].ptr);
+        const std::int64_t priority = pq->topPriority();
+        if (cmd == "PQPEEK") {
+            std::cout << priority << ' ' << pq->top() << '\n';
+            return;
+        }
+        std::cout << priority << ' ' << pq->pop() << '\n';
+        autoSave();
+    } else if (cmd == "PQPRINT") {
+        if (tokCount < 2) return;
+        int idx = find(tokens[1]);
+        if (idx == -1 || recs[idx].kind != DSKind::PQUEUE) return;
+        static_cast<PriorityQueue*>(recs[idx].ptr)->print();
     }
 
     // ------------- AVL-ДЕРЕВО -------------
@@ -724,6 +1231,212 @@ void DBMS::execute(const std::string& query)
         if (idx == -1) return;
         AvlTree* t = static_cast<AvlTree*>(recs[idx].ptr);
         t->print();
+    } else if (cmd == "TRANGE") {
+        // TRANGE name lo hi — значения из [lo, hi] по возрастанию
+        if (tokCount < 4) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::AVL) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        AvlTree* t = static_cast<AvlTree*>(recs[idx].ptr);
+        if (tokens[3] < tokens[2]) {
+            std::cout << '\n';
+            return;
+        }
+        const char* separator = "";
+        for (auto it = t->lowerBound(tokens[2]), last = t->upperBound(tokens[3]); it != last; ++it) {
+            std::cout << separator << *it;
+            separator = " ";
+        }
+        std::cout << '\n';
+    } else if (cmd == "TRANK") {
+        // TRANK name val — сколько значений меньше val
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::AVL) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        AvlTree* t = static_cast<AvlTree*>(recs[idx].ptr);
+        std::cout << t->rank(tokens[2]) << '\n';
+    } else if (cmd == "TNTH") {
+        // TNTH name k — k-е по возрастанию значение (с нуля)
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::AVL) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        AvlTree* t = static_cast<AvlTree*>(recs[idx].ptr);
+        try {
+            std::cout << t->nth(static_cast<std::size_t>(std::stoull(tokens[2]))) << '\n';
+        } catch (...) {
+            std::cout << "<ERR>\n";
+        }
+    }
+
+    else if (cmd == "TUNION" || cmd == "TINTER" || cmd == "TDIFF") {
+        // TUNION/TINTER/TDIFF dst a b — dst = a ∪ b / a ∩ b / a \ b
+        if (tokCount < 4) return;
+        int ia = find(tokens[2]);
+        int ib = find(tokens[3]);
+        int id = find(tokens[1]);
+        if (ia == -1 || ib == -1
+            || recs[ia].kind != DSKind::AVL || recs[ib].kind != DSKind::AVL
+            || (id != -1 && recs[id].kind != DSKind::AVL)) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        AvlTree result(*static_cast<AvlTree*>(recs[ia].ptr));
+        const AvlTree& other = *static_cast<AvlTree*>(recs[ib].ptr);
+        if (cmd == "TUNION")      result.unionWith(other);
+        else if (cmd == "TINTER") result.intersectWith(other);
+        else                      result.subtract(other);
+
+        auto* dst = static_cast<AvlTree*>(typedRecord(tokens[1], DSKind::AVL, true));
+        if (dst == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        // фильтр Блума — настройка dst, а не операндов
+        if (dst->hasBloomFilter()) result.enableBloomFilter();
+        else                       result.disableBloomFilter();
+        *dst = std::move(result);
+        std::cout << dst->size() << '\n';
+        autoSave();
+    }
+
+    // ------------- B+-ДЕРЕВО -------------
+    else if (cmd == "BINSERT") {
+        if (tokCount < 3) return;
+        auto* b = static_cast<BPlusTree*>(typedRecord(tokens[1], DSKind::BTREE, true));
+        if (b == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        b->insert(tokens[2]);
+        autoSave();
+    } else if (cmd == "BDEL") {
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::BTREE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        BPlusTree* b = static_cast<BPlusTree*>(recs[idx].ptr);
+        b->remove(tokens[2]);
+        autoSave();
+    } else if (cmd == "BPRINT") {
+        if (tokCount < 2) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::BTREE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        BPlusTree* b = static_cast<BPlusTree*>(recs[idx].ptr);
+        b->print();
+    } else if (cmd == "BRANGE") {
+        // BRANGE name lo hi — как TRANGE
+        if (tokCount < 4) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::BTREE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        BPlusTree* b = static_cast<BPlusTree*>(recs[idx].ptr);
+        if (tokens[3] < tokens[2]) {
+            std::cout << '\n';
+            return;
+        }
+        const char* separator = "";
+        for (auto it = b->lowerBound(tokens[2]), last = b->upperBound(tokens[3]); it != last; ++it) {
+            std::cout << separator << *it;
+            separator = " ";
+        }
+        std::cout << '\n';
+    } else if (cmd == "BRANK") {
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::BTREE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        BPlusTree* b = static_cast<BPlusTree*>(recs[idx].ptr);
+        std::cout << b->rank(tokens[2]) << '\n';
+    } else if (cmd == "BNTH") {
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::BTREE) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        BPlusTree* b = static_cast<BPlusTree*>(recs[idx].ptr);
+        try {
+            std::cout << b->nth(static_cast<std::size_t>(std::stoull(tokens[2]))) << '\n';
+        } catch (...) {
+            std::cout << "<ERR>\n";
+        }
+    }
+
+    // ------- ПЕРСИСТЕНТНОЕ AVL-ДЕРЕВО -------
+    else if (cmd == "PINSERT") {
+        if (tokCount < 3) return;
+        auto* p = static_cast<PersistentAvlTree*>(typedRecord(tokens[1], DSKind::PAVL, true));
+        if (p == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        p->insert(tokens[2]);
+        autoSave();
+    } else if (cmd == "PDEL") {
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::PAVL) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        PersistentAvlTree* p = static_cast<PersistentAvlTree*>(recs[idx].ptr);
+        p->remove(tokens[2]);
+        autoSave();
+    } else if (cmd == "PPRINT") {
+        if (tokCount < 2) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        if (recs[idx].kind != DSKind::PAVL) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        PersistentAvlTree* p = static_cast<PersistentAvlTree*>(recs[idx].ptr);
+        p->print();
+    } else if (cmd == "PSNAP") {
+        // PSNAP dst src — dst становится текущей версией src за O(1)
+        if (tokCount < 3) return;
+        int is = find(tokens[2]);
+        int id = find(tokens[1]);
+        if (is == -1 || recs[is].kind != DSKind::PAVL
+            || (id != -1 && recs[id].kind != DSKind::PAVL)) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        const PersistentAvlTree snapshot(*static_cast<PersistentAvlTree*>(recs[is].ptr));
+        auto* dst = static_cast<PersistentAvlTree*>(typedRecord(tokens[1], DSKind::PAVL, true));
+        if (dst == nullptr) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+        *dst = snapshot;
+        std::cout << dst->size() << '\n';
+        autoSave();
     }
 
     // ---------- ХЕШ-Таблица ЦЕПНАЯ ----------
@@ -778,21 +1491,150 @@ void DBMS::execute(const std::string& query)
         h->print();
     }
 
+    // --------------- ПАМЯТЬ ---------------
+    else if (cmd == "MEMORY") {
+        // MEMORY [name] — байты, занимаемые структурой (или всеми структурами)
+        if (tokCount >= 2) {
+            int idx = find(tokens[1]);
+            if (idx == -1) return;
+            std::cout << recs[idx].name << ' ' << kindName(recs[idx].kind) << ' '
+                      << memoryOf(recs[idx]) << '\n';
+            return;
+        }
+
+        std::size_t total = 0;
+        for (int i = 0; i < count; ++i) {
+            const std::size_t bytes = memoryOf(recs[i]);
+            total += bytes;
+            std::cout << recs[i].name << ' ' << kindName(recs[i].kind) << ' ' << bytes << '\n';
+        }
+        // общий пул строк (значения AVL-деревьев)
+        const std::size_t poolBytes = StringPool::global().memoryUsage();
+        std::cout << "STRING_POOL " << poolBytes << '\n';
+        std::cout << "TOTAL " << total + poolBytes << '\n';
+    }
+
+    // ------------ ФИЛЬТР БЛУМА ------------
+    else if (cmd == "BLOOM") {
+        // BLOOM name ON|OFF — фильтр промахов для AVL и хеш-таблиц
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        const bool enable = tokens[2] == "ON";
+        if (!enable && tokens[2] != "OFF") return;
+
+        switch (recs[idx].kind) {
+        case DSKind::AVL: {
+            AvlTree* t = static_cast<AvlTree*>(recs[idx].ptr);
+            if (enable) t->enableBloomFilter(); else t->disableBloomFilter();
+            break;
+        }
+        case DSKind::HCHAIN: {
+            HashTable* h = static_cast<HashTable*>(recs[idx].ptr);
+            if (enable) h->enableBloomFilter(); else h->disableBloomFilter();
+            break;
+        }
+        case DSKind::HOPEN: {
+            HashTableOpen* h = static_cast<HashTableOpen*>(recs[idx].ptr);
+            if (enable) h->enableBloomFilter(); else h->disableBloomFilter();
+            break;
+        }
+        default:
+            std::cout << "<ERR>\n";
+            return;
+        }
+        autoSave();
+    }
+
+    // ----------- ИНДЕКС ЗНАЧЕНИЙ -----------
+    else if (cmd == "VINDEX") {
+        // VINDEX name ON|OFF — хеш-индекс значений списка (не сохраняется)
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        const bool enable = tokens[2] == "ON";
+        if (!enable && tokens[2] != "OFF") return;
+
+        switch (recs[idx].kind) {
+        case DSKind::FLIST: {
+            ForwardList* fl = static_cast<ForwardList*>(recs[idx].ptr);
+            if (enable) fl->enableValueIndex(); else fl->disableValueIndex();
+            break;
+        }
+        case DSKind::LLIST: {
+            List* ll = static_cast<List*>(recs[idx].ptr);
+            if (enable) ll->enableValueIndex(); else ll->disableValueIndex();
+            break;
+        }
+        default:
+            std::cout << "<ERR>\n";
+            return;
+        }
+    }
+
+    // ---------- ПРЕДЕЛ РАЗМЕРА ----------
+    else if (cmd == "LIMIT") {
+        // LIMIT name N — предел размера стека или очереди, 0 — без предела
+        // (не сохраняется); SPUSH/QPUSH в полный отвечают <FULL>
+        if (tokCount < 3) return;
+        int idx = find(tokens[1]);
+        if (idx == -1) return;
+        std::size_t limit = 0;
+        try {
+            limit = static_cast<std::size_t>(std::stoull(tokens[2]));
+        } catch (...) {
+            std::cout << "<ERR>\n";
+            return;
+        }
+
+        switch (recs[idx].kind) {
+        case DSKind::STACK:
+            static_cast<Stack*>(recs[idx].ptr)->setCapacityLimit(limit);
+            break;
+        case DSKind::QUEUE:
+            static_cast<Queue*>(recs[idx].ptr)->setCapacityLimit(limit);
+            break;
+        default:
+            std::cout << "<ERR>\n";
+            return;
+        }
+    }
+
     // --------- HELP / PRINT ---------
     else if (cmd == "HELP") {
         std::cout <<
-            "МАССИВ (M): MPUSH name val | MINSERT name pos val | MDEL name pos | MSET name pos val | MGET name pos | MPRINT name\n"
+            "МАССИВ (M): MPUSH name val | MINSERT name pos val | MDEL name pos | MSET name pos val | MGET name pos | MPRINT name | MMODE name GAP|FLAT\n"
+            "                MCOMPACT name — в один буфер строк (только чтение) | MEXPAND name — обратно\n"
             "ОДНОСВЯЗНЫЙ СПИСОК (F): FPUSH name HEAD/TAIL val | FDEL name HEAD/VAL val |\n"
             "                        FPUSH_AFTER name after val | FPUSH_BEFORE name before val |\n"
             "                        FDEL_AFTER name after | FDEL_BEFORE name before | FDEL_TAIL name | FPRINT name\n"
+            "                        FCONCAT dst src | FSPLICE dst after src | FSPLIT src index dst\n"
             "ДВУСВЯЗНЫЙ СПИСОК (L): LPUSH name HEAD/TAIL val | LDEL name HEAD/TAIL/VAL val |\n"
             "                        LPUSH_AFTER name after val | LPUSH_BEFORE name before val |\n"
             "                        LDEL_AFTER name after | LDEL_BEFORE name before | LPRINT name\n"
+            "                        LCONCAT dst src | LSPLICE dst before src | LSPLIT src index dst\n"
+            "ПЕРЕНОС УЗЛОВ (F, L): src отдаёт узлы и остаётся пустым; SPLIT переносит\n"
+            "                      элементы с номера index в конец dst (dst создаётся)\n"
             "СТЕК (S): SPUSH name val | SPOP name | SPRINT name\n"
             "ОЧЕРЕДЬ (Q): QPUSH name val | QPOP name | QPRINT name\n"
-            "AVL-ДЕРЕВО (T): TINSERT name val | TDEL name val | TPRINT name\n"
+            "             QPUSHN name v1 v2 ... | QPOPN name N — пакетом, QPOPN печатает забранное\n"
+            "             QNEW name SPSC|MPMC [capacity] — очередь без блокировок (вместимость не сохраняется)\n"
+            "ОЧЕРЕДЬ С ПРИОРИТЕТАМИ (PQ): PQPUSH name priority val | PQPOP name | PQPEEK name | PQPRINT name\n"
+            "             первым выходит меньший приоритет, при равных — раньше добавленный;\n"
+            "             PQPOP и PQPEEK печатают «priority val», пустая очередь — <ERR>\n"
+            "AVL-ДЕРЕВО (T): TINSERT name val | TDEL name val | TPRINT name |\n"
+            "                TRANGE name lo hi | TRANK name val | TNTH name k |\n"
+            "                TUNION/TINTER/TDIFF dst a b\n"
+            "B+-ДЕРЕВО (B): BINSERT name val | BDEL name val | BPRINT name |\n"
+            "               BRANGE name lo hi | BRANK name val | BNTH name k\n"
+            "ПЕРСИСТЕНТНОЕ AVL (P): PINSERT name val | PDEL name val | PPRINT name |\n"
+            "                       PSNAP dst src — версия src за O(1)\n"
             "ХЕШ-ТАБЛИЦА цепная: HSET name key value... | HPRINT name\n"
             "ХЕШ-ТАБЛИЦА откр.: H2SET name key value... | H2PRINT name\n"
+            "ПАМЯТЬ: MEMORY [name]\n"
+            "ФИЛЬТР БЛУМА (AVL, HCHAIN, HOPEN): BLOOM name ON/OFF\n"
+            "ИНДЕКС ЗНАЧЕНИЙ (FLIST, LLIST): VINDEX name ON/OFF\n"
+            "ПРЕДЕЛ РАЗМЕРА (STACK, QUEUE): LIMIT name N — 0 без предела, push в полный: <FULL>\n"
             "EXIT/QUIT — выход\n";
     } else if (cmd == "PRINT") {
         if (tokCount < 2) return;
@@ -823,6 +1665,24 @@ void DBMS::execute(const std::string& query)
         case DSKind::HOPEN:
             static_cast<HashTableOpen*>(recs[idx].ptr)->print();
             break;
+        case DSKind::BTREE:
+            static_cast<BPlusTree*>(recs[idx].ptr)->print();
+            break;
+        case DSKind::PAVL:
+            static_cast<PersistentAvlTree*>(recs[idx].ptr)->print();
+            break;
+        case DSKind::CARRAY:
+            static_cast<CompactStringArray*>(recs[idx].ptr)->print();
+            break;
+        case DSKind::SPSC:
+            static_cast<SpscQueue*>(recs[idx].ptr)->print();
+            break;
+        case DSKind::MPMC:
+            static_cast<MpmcQueue*>(recs[idx].ptr)->print();
+            break;
+        case DSKind::PQUEUE:
+            static_cast<PriorityQueue*>(recs[idx].ptr)->print();
+            break;
         }
     }
 }
@@ -2,9 +2,11 @@
 #include "catch_amalgamated.hpp"
 #include "array.h"
 
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 TEST_CASE("MyArray: конструктор по умолчанию и базовые свойства", "[MyArray]")
 {
@@ -224,6 +226,51 @@ TEST_CASE("MyArray: resize увеличивает и уменьшает ёмко
 }
 
 
+TEST_CASE("MyArray: reserve и shrinkToFit меняют только ёмкость", "[MyArray]")
+{
+    MyArray arr(2);
+    arr.pushBack("one");
+    arr.pushBack("two");
+
+    arr.reserve(100);
+    REQUIRE(arr.getCapacity() == 100);
+    arr.reserve(10);
+    REQUIRE(arr.getCapacity() == 100);
+    REQUIRE(arr.size() == 2);
+
+    arr.shrinkToFit();
+    REQUIRE(arr.getCapacity() == 2);
+    REQUIRE(arr[0] == "one");
+    REQUIRE(arr[1] == "two");
+
+    arr.removeAt(0);
+    arr.removeAt(0);
+    arr.shrinkToFit();
+    REQUIRE(arr.getCapacity() == 1);
+    REQUIRE(arr.empty());
+}
+
+TEST_CASE("MyArray: вставка собственного элемента при росте и сдвиге", "[MyArray]")
+{
+    // длинные строки: перемещение отдаёт буфер, копия должна быть сделана раньше
+    const std::string longText(64, 'x');
+    MyArray arr(1);
+    arr.pushBack(longText);
+    arr.pushBack(arr[0]);             // рост при полном массиве
+    arr.insert(0, arr[1]);            // рост и сдвиг
+    arr.insert(1, arr[2]);            // сдвиг без роста
+    REQUIRE(arr.size() == 4);
+    for (std::size_t i = 0; i < arr.size(); ++i) {
+        REQUIRE(arr[i] == longText);
+    }
+
+    MyArray moved(std::move(arr));
+    arr.pushBack("after move");
+    REQUIRE(arr.size() == 1);
+    REQUIRE(arr[0] == "after move");
+}
+
+
 // 5. Правило пяти: копирование, перемещение, swap
 
 TEST_CASE("MyArray: копирующий конструктор делает глубокую копию", "[MyArray]")
@@ -398,3 +445,94 @@ TEST_CASE("MyArray: бинарная serialize/deserialize корректно в
     }
 }
 
+TEST_CASE("MyArray: испорченный счётчик в бинарном снапшоте не ведёт к огромному резерву", "[MyArray]")
+{
+    MyArray original;
+    original.pushBack("alpha");
+    original.pushBack("beta");
+
+    std::ostringstream oss(std::ios::binary);
+    original.serializeBinary(oss);
+    std::string bin = oss.str();
+
+    // заявлено 2^60 элементов, в потоке — два: резерв ограничен, чтение обрывается
+    const std::uint64_t huge = std::uint64_t{1} << 60;
+    bin.replace(0, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+    std::istringstream corrupt(bin, std::ios::binary);
+    MyArray restored;
+    REQUIRE_THROWS_AS(restored.deserializeBinary(corrupt), std::runtime_error);
+}
+
+
+// 8. Буфер с разрывом
+
+TEST_CASE("MyArray: правки у курсора в режиме буфера с разрывом совпадают с std::vector", "[MyArray]")
+{
+    MyArray arr;
+    arr.setGapBuffer(true);
+    REQUIRE(arr.gapBuffer());
+    std::vector<std::string> model;
+
+    // курсор блуждает, правки идут рядом с ним; длинные строки проверяют перенос
+    std::size_t cursor = 0;
+    std::uint32_t state = 7;
+    for (int step = 0; step < 4000; ++step) {
+        state = state * 1103515245U + 12345U;
+        if ((state >> 20) % 8 == 0) {
+            cursor = model.empty() ? 0 : (state >> 4) % (model.size() + 1);
+        }
+        if ((state >> 12) % 3 == 0 && cursor < model.size()) {
+            arr.removeAt(cursor);
+            model.erase(model.begin() + static_cast<std::ptrdiff_t>(cursor));
+        } else {
+            const std::string value = std::to_string(step) + std::string(step % 2 ? 40 : 0, '#');
+            arr.insert(cursor, value);
+            model.insert(model.begin() + static_cast<std::ptrdiff_t>(cursor), value);
+            ++cursor;
+        }
+    }
+    arr.pushBack("tail");
+    model.push_back("tail");
+    arr.set(0, "head");
+    model[0] = "head";
+
+    REQUIRE(arr.size() == model.size());
+    int mismatches = 0;
+    for (std::size_t i = 0; i < model.size(); ++i) {
+        mismatches += arr.at(i) == model[i] ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+
+    // сериализация и копия идут в логическом порядке
+    MyArray restored;
+    restored.deserialize(arr.serialize());
+    MyArray copy(arr);
+    REQUIRE(copy.gapBuffer());
+    for (std::size_t i = 0; i < model.size(); i += 97) {
+        REQUIRE(restored[i] == model[i]);
+        REQUIRE(copy[i] == model[i]);
+    }
+}
+
+TEST_CASE("MyArray: переключение режима сохраняет элементы", "[MyArray]")
+{
+    MyArray arr;
+    arr.setGapBuffer(true);
+    for (const char* value : {"a", "b", "c", "d"}) {
+        arr.pushBack(value);
+    }
+    arr.insert(1, "x");        // разрыв остаётся после "x"
+    arr.removeAt(3);           // "c"
+
+    arr.setGapBuffer(false);
+    REQUIRE_FALSE(arr.gapBuffer());
+    arr.insert(0, "first");
+    arr.removeAt(2);           // "x"
+
+    REQUIRE(arr.serialize() == "4\nfirst\na\nb\nd\n");
+
+    arr.setGapBuffer(true);
+    arr.insert(2, "y");
+    arr.resize(3);
+    REQUIRE(arr.serialize() == "3\nfirst\na\ny\n");
+}
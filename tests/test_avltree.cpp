@@ -1,11 +1,16 @@
 
 #include "catch_amalgamated.hpp"
 #include "avltree.h"
+#include "parallel.h"
 
 #include <sstream>
 #include <string>
 #include <cstdint>
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
 
 
 
@@ -344,3 +349,474 @@ TEST_CASE("AvlTree: serializeBinary выбрасывает, если поток
 
     REQUIRE_THROWS_AS(tree.serializeBinary(oss), std::runtime_error);
 }
+
+
+// 8. ФИЛЬТР БЛУМА
+
+
+TEST_CASE("AvlTree: фильтр Блума не меняет ответы contains и сохраняется в бинарном снапшоте", "[AvlTree][BloomFilter]")
+{
+    AvlTree tree;
+    tree.insert("a");
+    tree.enableBloomFilter();
+    for (int i = 0; i < 300; ++i) {
+        tree.insert("v" + std::to_string(i));
+    }
+    tree.remove("v10");
+    tree.remove("missing");
+
+    int mismatches = 0;
+    for (int i = 0; i < 300; ++i) {
+        mismatches += tree.contains("v" + std::to_string(i)) == (i != 10) ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(tree.contains("a"));
+    REQUIRE_FALSE(tree.contains("b"));
+    REQUIRE(tree.size() == 300U);
+
+    std::ostringstream oss(std::ios::binary);
+    tree.serializeBinary(oss);
+    std::istringstream iss(oss.str(), std::ios::binary);
+    AvlTree restored;
+    restored.deserializeBinary(iss);
+    REQUIRE(restored.hasBloomFilter());
+    REQUIRE(restored.size() == 300U);
+    REQUIRE(restored.contains("v299"));
+    REQUIRE_FALSE(restored.contains("v10"));
+
+    AvlTree copy;
+    copy = restored;
+    REQUIRE(copy.hasBloomFilter());
+    REQUIRE(copy.contains("a"));
+}
+
+
+// 9. ИТЕРАТИВНЫЕ ОПЕРАЦИИ И ПРОВЕРКА ФОРМЫ СНАПШОТА
+
+
+TEST_CASE("AvlTree: вставки и удаления вперемешку сохраняют баланс и порядок", "[AvlTree]")
+{
+    AvlTree tree;
+    std::set<std::string> model;
+    std::uint32_t state = 12345;
+    for (int step = 0; step < 20000; ++step) {
+        state = state * 1103515245U + 12345U;
+        const std::string value = std::to_string((state >> 8) % 3000);
+        if ((state >> 4) % 3 == 0) {
+            tree.remove(value);
+            model.erase(value);
+        } else {
+            tree.insert(value);
+            model.insert(value);
+        }
+    }
+    REQUIRE(tree.size() == model.size());
+
+    int mismatches = 0;
+    for (int i = 0; i < 3000; ++i) {
+        const std::string value = std::to_string(i);
+        mismatches += tree.contains(value) == (model.count(value) == 1) ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+
+    // загрузка проверяет баланс и порядок: повреждённое дерево не загрузится
+    AvlTree restored;
+    REQUIRE_NOTHROW(restored.deserialize(tree.serialize()));
+    REQUIRE(restored.size() == model.size());
+
+    AvlTree copy(restored);
+    REQUIRE(copy.serialize() == tree.serialize());
+}
+
+TEST_CASE("AvlTree: снапшот с неверной формой отклоняется без переполнения стека", "[AvlTree]")
+{
+    AvlTree tree;
+    tree.insert("keep");
+
+    SECTION("глубокая цепочка в бинарном снапшоте")
+    {
+        // 200000 узлов, каждый — левый ребёнок предыдущего
+        std::ostringstream oss(std::ios::binary);
+        const int depth = 200000;
+        for (int i = 0; i < depth; ++i) {
+            const std::string value = std::to_string(depth - i);
+            const std::uint8_t flag = 1;
+            const std::uint64_t len = value.size();
+            oss.write(reinterpret_cast<const char*>(&flag), sizeof(flag));
+            oss.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            oss.write(value.data(), static_cast<std::streamsize>(len));
+        }
+        const std::string nulls(depth + 1, '\0');
+        oss.write(nulls.data(), static_cast<std::streamsize>(nulls.size()));
+
+        std::istringstream iss(oss.str(), std::ios::binary);
+        REQUIRE_THROWS_AS(tree.deserializeBinary(iss), std::runtime_error);
+    }
+
+    SECTION("сбалансированное, но неупорядоченное дерево в тексте")
+    {
+        REQUIRE_THROWS_AS(tree.deserialize("a\nb\n#\n#\n#\n"), std::runtime_error);
+    }
+
+    // при ошибке старое содержимое остаётся
+    REQUIRE(tree.size() == 1U);
+    REQUIRE(tree.contains("keep"));
+}
+
+
+// 10. ПОРЯДКОВЫЕ ЗАПРОСЫ
+
+
+TEST_CASE("AvlTree: lowerBound, upperBound и обход по возрастанию", "[AvlTree]")
+{
+    AvlTree tree;
+    for (const char* value : {"d", "b", "f", "a", "c", "e", "g"}) {
+        tree.insert(value);
+    }
+
+    std::string all;
+    for (std::string_view value : tree) {
+        all += value;
+    }
+    REQUIRE(all == "abcdefg");
+
+    REQUIRE(*tree.lowerBound("c") == "c");
+    REQUIRE(*tree.lowerBound("cc") == "d");
+    REQUIRE(*tree.upperBound("c") == "d");
+    REQUIRE(tree.lowerBound("h") == tree.end());
+    REQUIRE(tree.upperBound("g") == tree.end());
+    REQUIRE(tree.lowerBound("") == tree.begin());
+
+    std::string range;
+    for (auto it = tree.lowerBound("b"), last = tree.upperBound("e"); it != last; ++it) {
+        range += *it;
+    }
+    REQUIRE(range == "bcde");
+
+    AvlTree empty;
+    REQUIRE(empty.begin() == empty.end());
+    REQUIRE(empty.lowerBound("a") == empty.end());
+}
+
+TEST_CASE("AvlTree: rank, nth, rangeCount и prefixRange", "[AvlTree]")
+{
+    AvlTree tree;
+    for (const char* value : {"apple", "apricot", "banana", "app", "ap", "b", "cherry"}) {
+        tree.insert(value);
+    }
+    // порядок: ap app apple apricot b banana cherry
+
+    REQUIRE(tree.rank("ap") == 0U);
+    REQUIRE(tree.rank("apple") == 2U);
+    REQUIRE(tree.rank("az") == 4U);
+    REQUIRE(tree.rank("zzz") == 7U);
+
+    REQUIRE(tree.nth(0) == "ap");
+    REQUIRE(tree.nth(3) == "apricot");
+    REQUIRE(tree.nth(6) == "cherry");
+    REQUIRE_THROWS_AS(tree.nth(7), std::out_of_range);
+
+    REQUIRE(tree.rangeCount("app", "b") == 4U);
+    REQUIRE(tree.rangeCount("b", "app") == 0U);
+    REQUIRE(tree.rangeCount("x", "y") == 0U);
+
+    auto [first, last] = tree.prefixRange("app");
+    std::string found;
+    for (; first != last; ++first) {
+        found += std::string(*first) + " ";
+    }
+    REQUIRE(found == "app apple ");
+
+    auto everything = tree.prefixRange("");
+    REQUIRE(everything.first == tree.begin());
+    REQUIRE(everything.second == tree.end());
+}
+
+TEST_CASE("AvlTree: размеры поддеревьев верны после вставок, удалений и загрузки", "[AvlTree]")
+{
+    AvlTree tree;
+    std::set<std::string> model;
+    std::uint32_t state = 777;
+    for (int step = 0; step < 5000; ++step) {
+        state = state * 1103515245U + 12345U;
+        const std::string value = std::to_string(1000 + (state >> 8) % 2000);
+        if ((state >> 4) % 3 == 0) {
+            tree.remove(value);
+            model.erase(value);
+        } else {
+            tree.insert(value);
+            model.insert(value);
+        }
+    }
+
+    AvlTree restored;
+    restored.deserialize(tree.serialize());
+    AvlTree copy(tree);
+
+    int mismatches = 0;
+    std::size_t index = 0;
+    for (const std::string& value : model) {
+        for (const AvlTree* checked : {&tree, &restored, &copy}) {
+            mismatches += checked->nth(index) == value ? 0 : 1;
+            mismatches += checked->rank(value) == index ? 0 : 1;
+        }
+        ++index;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(tree.rangeCount("1500", "2000")
+            == static_cast<std::size_t>(std::distance(model.lower_bound("1500"),
+                                                      model.upper_bound("2000"))));
+}
+
+
+// 11. СБОРКА ИЗ ОТСОРТИРОВАННЫХ ЗНАЧЕНИЙ
+
+
+TEST_CASE("AvlTree: buildFromSorted строит рабочее сбалансированное дерево", "[AvlTree]")
+{
+    std::vector<std::string> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(std::to_string(10000 + i));
+    }
+
+    AvlTree tree;
+    tree.insert("old");
+    tree.buildFromSorted(values);
+    REQUIRE(tree.size() == values.size());
+    REQUIRE_FALSE(tree.contains("old"));
+    REQUIRE(tree.nth(500) == values[500]);
+    REQUIRE(tree.rank("10250") == 250U);
+
+    // загрузка текста проверяет баланс каждого узла
+    AvlTree checked;
+    REQUIRE_NOTHROW(checked.deserialize(tree.serialize()));
+
+    tree.insert("0");
+    tree.remove("10000");
+    REQUIRE(tree.nth(0) == "0");
+    REQUIRE(tree.size() == values.size());
+
+    // неупорядоченный вход отклоняется, дерево не меняется
+    REQUIRE_THROWS_AS(tree.buildFromSorted({"b", "a"}), std::runtime_error);
+    REQUIRE_THROWS_AS(tree.buildFromSorted({"a", "a"}), std::runtime_error);
+    REQUIRE(tree.size() == values.size());
+
+    tree.buildFromSorted({});
+    REQUIRE(tree.empty());
+}
+
+TEST_CASE("AvlTree: отсортированный бинарный снапшот и чтение старого формата", "[AvlTree]")
+{
+    AvlTree tree;
+    for (int i = 0; i < 300; ++i) {
+        tree.insert("v" + std::to_string(i * 37 % 300));
+    }
+
+    std::ostringstream oss(std::ios::binary);
+    tree.serializeBinary(oss);
+    const std::string sorted = oss.str();
+    REQUIRE(sorted[0] == '\x02');
+    // ни одного маркера пустого поддерева: 9 + 8 байт длины на значение
+    std::size_t payload = 0;
+    for (std::string_view value : tree) {
+        payload += value.size();
+    }
+    REQUIRE(sorted.size() == 9 + tree.size() * 8 + payload);
+
+    std::istringstream iss(sorted, std::ios::binary);
+    AvlTree restored;
+    restored.deserializeBinary(iss);
+    REQUIRE(std::equal(restored.begin(), restored.end(), tree.begin(), tree.end()));
+
+    // старый префиксный формат: b(a, c)
+    std::ostringstream legacy(std::ios::binary);
+    for (const char* token : {"b", "a", "", "", "c", "", ""}) {
+        const std::uint8_t flag = token[0] != '\0' ? 1 : 0;
+        legacy.write(reinterpret_cast<const char*>(&flag), sizeof(flag));
+        if (flag != 0) {
+            const std::uint64_t len = 1;
+            legacy.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            legacy.write(token, 1);
+        }
+    }
+    std::istringstream legacyIn(legacy.str(), std::ios::binary);
+    restored.deserializeBinary(legacyIn);
+    REQUIRE(restored.size() == 3U);
+    REQUIRE(restored.nth(2) == "c");
+
+    // значения не по возрастанию отклоняются, дерево не меняется
+    std::ostringstream broken(std::ios::binary);
+    const std::uint8_t format = 2;
+    const std::uint64_t count = 2;
+    const std::uint64_t len = 1;
+    broken.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    broken.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const char* value : {"z", "a"}) {
+        broken.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        broken.write(value, 1);
+    }
+    std::istringstream brokenIn(broken.str(), std::ios::binary);
+    REQUIRE_THROWS_AS(restored.deserializeBinary(brokenIn), std::runtime_error);
+    REQUIRE(restored.size() == 3U);
+}
+
+
+// 12. ОПЕРАЦИИ НАД МНОЖЕСТВАМИ
+
+
+namespace
+{
+std::set<std::string> randomSet(std::uint32_t seed, int count, int range)
+{
+    std::set<std::string> values;
+    for (int i = 0; i < count; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        values.insert(std::to_string((seed >> 8) % static_cast<std::uint32_t>(range)));
+    }
+    return values;
+}
+
+AvlTree treeOf(const std::set<std::string>& values)
+{
+    AvlTree tree;
+    for (const std::string& value : values) {
+        tree.insert(value);
+    }
+    return tree;
+}
+
+// результат совпадает с моделью и проходит проверку баланса при загрузке
+bool sameSet(const AvlTree& tree, const std::set<std::string>& expected)
+{
+    AvlTree checked;
+    checked.deserialize(tree.serialize());
+    return tree.size() == expected.size()
+        && std::equal(tree.begin(), tree.end(), expected.begin(), expected.end());
+}
+
+// параллельная ветка включается даже на одноядерной машине
+struct WorkerLimitGuard
+{
+    explicit WorkerLimitGuard(unsigned limit) { parallel::setWorkerLimit(limit); }
+    ~WorkerLimitGuard() { parallel::setWorkerLimit(0); }
+};
+} // namespace
+
+TEST_CASE("AvlTree: unionWith, intersectWith и subtract совпадают с std::set", "[AvlTree]")
+{
+    // размеры сильно различаются в обе стороны, есть пустое множество
+    const int sizes[][2] = {{3000, 200}, {200, 3000}, {1000, 1000}, {0, 500}, {500, 0}};
+    std::uint32_t seed = 1;
+    for (const auto& size : sizes) {
+        const std::set<std::string> a = randomSet(seed++, size[0], 4000);
+        const std::set<std::string> b = randomSet(seed++, size[1], 4000);
+        std::set<std::string> expectedUnion = a;
+        expectedUnion.insert(b.begin(), b.end());
+        std::set<std::string> expectedInter;
+        std::set<std::string> expectedDiff;
+        for (const std::string& value : a) {
+            (b.count(value) != 0 ? expectedInter : expectedDiff).insert(value);
+        }
+
+        const AvlTree treeB = treeOf(b);
+        AvlTree united = treeOf(a);
+        united.unionWith(treeB);
+        AvlTree intersected = treeOf(a);
+        intersected.intersectWith(treeB);
+        AvlTree subtracted = treeOf(a);
+        subtracted.subtract(treeB);
+
+        REQUIRE(sameSet(united, expectedUnion));
+        REQUIRE(sameSet(intersected, expectedInter));
+        REQUIRE(sameSet(subtracted, expectedDiff));
+        REQUIRE(sameSet(treeB, b));
+    }
+
+    // операция с самим собой
+    AvlTree tree = treeOf({"a", "b", "c"});
+    tree.unionWith(tree);
+    REQUIRE(tree.size() == 3U);
+    tree.intersectWith(tree);
+    REQUIRE(tree.size() == 3U);
+    tree.subtract(tree);
+    REQUIRE(tree.empty());
+}
+
+TEST_CASE("AvlTree: операции над большими множествами в несколько потоков", "[AvlTree]")
+{
+    WorkerLimitGuard limit(4);
+    const std::set<std::string> a = randomSet(7, 60000, 200000);
+    const std::set<std::string> b = randomSet(8, 40000, 200000);
+    std::set<std::string> expectedInter;
+    for (const std::string& value : a) {
+        if (b.count(value) != 0) {
+            expectedInter.insert(value);
+        }
+    }
+
+    const AvlTree treeB = treeOf(b);
+    AvlTree intersected = treeOf(a);
+    intersected.enableBloomFilter();
+    intersected.intersectWith(treeB);
+    REQUIRE(sameSet(intersected, expectedInter));
+    REQUIRE(intersected.hasBloomFilter());
+
+    AvlTree united = treeOf(a);
+    united.unionWith(treeB);
+    united.subtract(treeB);
+    std::set<std::string> expectedDiff;
+    for (const std::string& value : a) {
+        if (b.count(value) == 0) {
+            expectedDiff.insert(value);
+        }
+    }
+    REQUIRE(sameSet(united, expectedDiff));
+    REQUIRE(united.rank(*expectedDiff.rbegin()) == expectedDiff.size() - 1);
+}
+
+
+// 13. ПУЛ УЗЛОВ
+
+
+TEST_CASE("AvlTree: освобождённые узлы переиспользуются, clear освобождает пул", "[AvlTree]")
+{
+    AvlTree tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert("key" + std::to_string(i));
+    }
+    const std::size_t fullMemory = tree.memoryUsage();
+
+    // удалённые узлы и узлы, освобождённые операцией, занимают свои же слоты
+    for (int i = 0; i < 1000; i += 2) {
+        tree.remove("key" + std::to_string(i));
+    }
+    AvlTree odd(tree);
+    tree.subtract(treeOf({"key1", "key3", "key5"}));
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert("key" + std::to_string(i));
+    }
+    REQUIRE(tree.size() == 1000U);
+    REQUIRE(tree.memoryUsage() == fullMemory);
+    std::set<std::string> all;
+    for (int i = 0; i < 1000; ++i) {
+        all.insert("key" + std::to_string(i));
+    }
+    REQUIRE(sameSet(tree, all));
+
+    // копия со свободными слотами независима от оригинала
+    REQUIRE(odd.size() == 500U);
+    REQUIRE_FALSE(odd.contains("key0"));
+    odd.insert("key0");
+    REQUIRE(odd.nth(0) == "key0");
+    REQUIRE(tree.contains("key0"));
+
+    tree.enableBloomFilter();
+    tree.clear();
+    REQUIRE(tree.empty());
+    REQUIRE(tree.begin() == tree.end());
+    REQUIRE_FALSE(tree.contains("key1"));
+    REQUIRE(tree.memoryUsage() < fullMemory);
+    tree.insert("again");
+    REQUIRE(tree.contains("again"));
+    REQUIRE(tree.hasBloomFilter());
+}
@@ -2,14 +2,34 @@
 #include "catch_amalgamated.hpp"
 
 #include "array.h"
+#include "compact_string_array.h"
 #include "forward_list.h"
 #include "list.h"
 #include "stack.h"
 #include "queue.h"
+#include "concurrent_queue.h"
+#include "blocking_queue.h"
+#include "work_stealing_deque.h"
+#include "priority_queue.h"
+#include "unrolled_list.h"
 #include "hashtable.h"
 #include "avltree.h"
+#include "bplus_tree.h"
+#include "persistent_avltree.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 
 //  MYARRAY 
@@ -36,6 +56,110 @@ TEST_CASE("Benchmark: MyArray insert at random", "[!benchmark]")
     };
 }
 
+TEST_CASE("Benchmark: MyArray with long strings", "[!benchmark]")
+{
+    // строки длиннее SSO: рост и сдвиги без перемещения копировали бы текст
+    const std::string payload(200, 'p');
+
+    BENCHMARK("MyArray::pushBack long strings (100000)") {
+        MyArray arr;
+        for (int i = 0; i < 100000; ++i)
+            arr.pushBack(payload);
+        return arr.size();
+    };
+
+    BENCHMARK("MyArray::pushBack after reserve (100000)") {
+        MyArray arr;
+        arr.reserve(100000);
+        for (int i = 0; i < 100000; ++i)
+            arr.pushBack(payload);
+        return arr.size();
+    };
+
+    MyArray arr;
+    for (int i = 0; i < 20000; ++i)
+        arr.pushBack(payload);
+
+    BENCHMARK("MyArray::insert + removeAt middle long strings (20000)") {
+        arr.insert(arr.size() / 2, payload);
+        arr.removeAt(arr.size() / 2);
+        return arr.size();
+    };
+}
+
+TEST_CASE("Benchmark: MyArray vs CompactStringArray scan", "[!benchmark]")
+{
+    // строки длиннее SSO: у MyArray каждая — отдельный блок кучи
+    MyArray arr;
+    for (int i = 0; i < 100000; ++i)
+        arr.pushBack("snapshot-record-" + std::to_string(i) + "-with-a-long-tail");
+    const CompactStringArray compact(arr);
+
+    BENCHMARK("MyArray scan (100000)") {
+        std::size_t checksum = 0;
+        for (std::size_t i = 0; i < arr.size(); ++i)
+            checksum += static_cast<unsigned char>(arr[i].back()) + arr[i].size();
+        return checksum;
+    };
+
+    BENCHMARK("CompactStringArray scan (100000)") {
+        std::size_t checksum = 0;
+        for (std::size_t i = 0; i < compact.size(); ++i)
+            checksum += static_cast<unsigned char>(compact[i].back()) + compact[i].size();
+        return checksum;
+    };
+
+    std::ostringstream image(std::ios::binary);
+    compact.serializeBinary(image);
+    const std::string bytes = image.str();
+    std::ostringstream plain(std::ios::binary);
+    arr.serializeBinary(plain);
+    const std::string plainBytes = plain.str();
+
+    BENCHMARK("MyArray::deserializeBinary (100000)") {
+        std::istringstream in(plainBytes, std::ios::binary);
+        MyArray loaded;
+        loaded.deserializeBinary(in);
+        return loaded.size();
+    };
+
+    BENCHMARK("CompactStringArray::deserializeBinary (100000)") {
+        std::istringstream in(bytes, std::ios::binary);
+        CompactStringArray loaded;
+        loaded.deserializeBinary(in);
+        return loaded.size();
+    };
+}
+
+TEST_CASE("Benchmark: MyArray cursor edits gap buffer vs flat", "[!benchmark]")
+{
+    // правки у медленно движущегося курсора, как при наборе текста
+    auto editAtCursor = [](bool gap) {
+        MyArray arr;
+        arr.setGapBuffer(gap);
+        for (int i = 0; i < 10000; ++i)
+            arr.pushBack("line " + std::to_string(i));
+        std::size_t cursor = 2500;
+        for (int i = 0; i < 2000; ++i) {
+            arr.insert(cursor, "typed");
+            ++cursor;
+            if (i % 4 == 3) {
+                arr.removeAt(cursor - 2);
+                --cursor;
+            }
+        }
+        return arr.size();
+    };
+
+    BENCHMARK("MyArray::insert at cursor flat (2000)") {
+        return editAtCursor(false);
+    };
+
+    BENCHMARK("MyArray::insert at cursor gap buffer (2000)") {
+        return editAtCursor(true);
+    };
+}
+
 
 
 //  FORWARD_LIST 
@@ -59,6 +183,11 @@ TEST_CASE("Benchmark: ForwardList find", "[!benchmark]")
     BENCHMARK("ForwardList::findNode middle (2000)") {
         return list.findNode("x1000");
     };
+
+    list.enableValueIndex();
+    BENCHMARK("ForwardList::findNode middle (2000), value index") {
+        return list.findNode("x1000");
+    };
 }
 
 
@@ -84,9 +213,131 @@ TEST_CASE("Benchmark: List insertBefore", "[!benchmark]")
     BENCHMARK("List::insertBefore middle") {
         list.insertBefore("10000", "XX");
     };
+
+    // тот же случай с индексом значений: без прохода до середины
+    List indexed;
+    indexed.enableValueIndex();
+    for (int i = 0; i < 20000; ++i)
+        indexed.pushBack(std::to_string(i));
+
+    BENCHMARK("List::insertBefore middle, value index") {
+        indexed.insertBefore("10000", "XX");
+    };
+
+    BENCHMARK("List::insertAfter + removeAfter middle, value index") {
+        indexed.insertAfter("15000", "YY");
+        indexed.removeAfter("15000");
+    };
+}
+
+// тот же набор на блочном списке: поиск и обход идут по строкам подряд
+TEST_CASE("Benchmark: List vs UnrolledList", "[!benchmark]")
+{
+    List list;
+    UnrolledList unrolled;
+    for (int i = 0; i < 20000; ++i) {
+        list.pushBack(std::to_string(i));
+        unrolled.pushBack(std::to_string(i));
+    }
+
+    BENCHMARK("List::pushBack + popFront (20000)") {
+        List local;
+        for (int i = 0; i < 20000; ++i)
+            local.pushBack("x");
+        for (int i = 0; i < 20000; ++i)
+            local.popFront();
+    };
+
+    BENCHMARK("UnrolledList::pushBack + popFront (20000)") {
+        UnrolledList local;
+        for (int i = 0; i < 20000; ++i)
+            local.pushBack("x");
+        for (int i = 0; i < 20000; ++i)
+            local.popFront();
+    };
+
+    BENCHMARK("List::insertAfter + removeAfter middle") {
+        list.insertAfter("15000", "YY");
+        list.removeAfter("15000");
+    };
+
+    BENCHMARK("UnrolledList::insertAfter + removeAfter middle") {
+        unrolled.insertAfter("15000", "YY");
+        unrolled.removeAfter("15000");
+    };
+
+    BENCHMARK("List::serializeBinary (20000)") {
+        std::ostringstream oss(std::ios::binary);
+        list.serializeBinary(oss);
+        return oss.str().size();
+    };
+
+    BENCHMARK("UnrolledList::serializeBinary (20000)") {
+        std::ostringstream oss(std::ios::binary);
+        unrolled.serializeBinary(oss);
+        return oss.str().size();
+    };
+
+    // простой проход без вывода: переход по узлам против строк подряд
+    BENCHMARK("List iteration (20000)") {
+        std::size_t total = 0;
+        for (const LNode* node = list.findNode("0"); node != nullptr; node = node->getNext())
+            total += node->getValue().size();
+        return total;
+    };
+
+    BENCHMARK("UnrolledList iteration (20000)") {
+        std::size_t total = 0;
+        for (const std::string& value : unrolled)
+            total += value.size();
+        return total;
+    };
 }
 
 
+// перенос половины списка в другой и обратно: поэлементно с копией строки
+// и новым узлом или перевешиванием узлов
+TEST_CASE("Benchmark: List rebalance by splitAt/concat", "[!benchmark]")
+{
+    constexpr int kCount = 100000;
+    std::vector<std::string> values;
+    for (int i = 0; i < kCount; ++i)
+        values.push_back("value-longer-than-sso-" + std::to_string(i));
+
+    List a;
+    List b;
+    ForwardList fa;
+    ForwardList fb;
+    for (const std::string& value : values) {
+        a.pushBack(value);
+        fa.pushBack(value);
+    }
+
+    BENCHMARK("List popFront + pushBack half there and back (100000)") {
+        for (int i = 0; i < kCount / 2; ++i) {
+            b.pushBack(values[i]);
+            a.popFront();
+        }
+        for (int i = 0; i < kCount / 2; ++i) {
+            a.pushBack(values[i]);
+            b.popFront();
+        }
+        return a.size();
+    };
+
+    BENCHMARK("List splitAt + concat half there and back (100000)") {
+        a.splitAt(kCount / 2, b);
+        a.concat(b);
+        return a.size();
+    };
+
+    BENCHMARK("ForwardList splitAt + concat half there and back (100000)") {
+        fa.splitAt(kCount / 2, fb);
+        fa.concat(fb);
+        return fa.size();
+    };
+}
+
 
 //  STACK 
 
@@ -115,6 +366,76 @@ TEST_CASE("Benchmark: Stack operations", "[!benchmark][Stack]")
         }
         return 0;
     };
+
+    // установившийся режим: вместимость уже есть, pop забирает строку
+    Stack steady;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        steady.push("value");
+    }
+    BENCHMARK("Stack::push + pop 100000 at size 1000")
+    {
+        for (std::size_t i = 0; i < 100000; ++i) {
+            steady.push("value");
+            (void)steady.pop();
+        }
+        return steady.size();
+    };
+}
+
+
+//  ЗАГРУЗКА СНАПШОТОВ 
+
+
+namespace
+{
+void appendItem(ForwardList& list, const std::string& value)
+{
+    list.pushBack(value);
+}
+
+void appendItem(Stack& stack, const std::string& value)
+{
+    stack.push(value);
+}
+
+// снапшот из count строк и загрузка его в пустой контейнер
+template <class C>
+void benchmarkSnapshotLoad(int count, const std::string& label)
+{
+    std::string bytes;
+    {
+        C source;
+        for (int i = 0; i < count; ++i)
+            appendItem(source, "item" + std::to_string(i));
+        std::ostringstream out(std::ios::binary);
+        source.serializeBinary(out);
+        bytes = out.str();
+    }
+
+    BENCHMARK(label + "::deserializeBinary (" + std::to_string(count) + ")") {
+        std::istringstream in(bytes, std::ios::binary);
+        C loaded;
+        loaded.deserializeBinary(in);
+        return loaded.size();
+    };
+}
+} // namespace
+
+TEST_CASE("Benchmark: snapshot load", "[!benchmark]")
+{
+    // ForwardList: до хвостового указателя каждый pushBack загрузки проходил
+    // весь список; Stack: загрузка без временного вектора
+    benchmarkSnapshotLoad<ForwardList>(100000, "ForwardList");
+    benchmarkSnapshotLoad<Stack>(100000, "Stack");
+}
+
+// ./tests_run "Benchmark: large snapshot load" --benchmark-samples 3
+TEST_CASE("Benchmark: large snapshot load", "[.][large][!benchmark]")
+{
+    for (int count : {1000000, 10000000}) {
+        benchmarkSnapshotLoad<ForwardList>(count, "ForwardList");
+        benchmarkSnapshotLoad<Stack>(count, "Stack");
+    }
 }
 
 
@@ -147,7 +468,411 @@ TEST_CASE("Benchmark: Queue operations", "[!benchmark][Queue]")
     };
 }
 
+// очередь в установившемся режиме: блоки переиспользуются, аллокаций нет
+TEST_CASE("Benchmark: Queue steady push/pop", "[!benchmark][Queue]")
+{
+    Queue q;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        q.push("value");
+    }
+    BENCHMARK("Queue::push + pop 100000 at size 1000")
+    {
+        for (std::size_t i = 0; i < 100000; ++i) {
+            q.push("value");
+            (void)q.pop();
+        }
+        return q.size();
+    };
+
+    // ограниченная очередь: производитель упирается в предел и ждёт pop
+    Queue bounded;
+    bounded.setCapacityLimit(1000);
+    BENCHMARK("Queue::tryPush until full + drain (limit 1000)")
+    {
+        std::size_t accepted = 0;
+        while (bounded.tryPush("value")) {
+            ++accepted;
+        }
+        while (!bounded.empty()) {
+            (void)bounded.pop();
+        }
+        return accepted;
+    };
+}
+
+
+
+// производители и потребители гоняют kItems строк через одну очередь;
+// tryPush/tryPop — обёртки над конкретной очередью
+template <class TryPush, class TryPop>
+std::size_t runPipeline(int producers, int consumers, int items, TryPush tryPush, TryPop tryPop)
+{
+    std::atomic<int> consumed{0};
+    std::atomic<std::size_t> checksum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = p; i < items; i += producers) {
+                std::string value = std::to_string(i);
+                while (!tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            std::string out;
+            std::size_t local = 0;
+            while (consumed.load(std::memory_order_relaxed) < items) {
+                if (tryPop(out)) {
+                    local += out.size();
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(local);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return checksum.load();
+}
+
+TEST_CASE("Benchmark: concurrent queues vs mutex Queue", "[!benchmark][ConcurrentQueue]")
+{
+    constexpr int kItems = 200000;
+
+    // Queue под одним мьютексом с тем же пределом, что у колец
+    Queue locked;
+    locked.setCapacityLimit(1024);
+    std::mutex lock;
+    auto lockedPush = [&](std::string& value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return locked.tryPush(value);
+    };
+    auto lockedPop = [&](std::string& out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (locked.empty()) {
+            return false;
+        }
+        out = locked.pop();
+        return true;
+    };
+
+    SpscQueue spsc(1024);
+    MpmcQueue mpmc(1024);
+    auto spscPush = [&](std::string& value) { return spsc.tryPush(std::move(value)); };
+    auto spscPop  = [&](std::string& out) { return spsc.tryPop(out); };
+    auto mpmcPush = [&](std::string& value) { return mpmc.tryPush(std::move(value)); };
+    auto mpmcPop  = [&](std::string& out) { return mpmc.tryPop(out); };
+
+    BENCHMARK("mutex Queue 1 producer 1 consumer (200000)") {
+        return runPipeline(1, 1, kItems, lockedPush, lockedPop);
+    };
+    BENCHMARK("SpscQueue 1 producer 1 consumer (200000)") {
+        return runPipeline(1, 1, kItems, spscPush, spscPop);
+    };
+    BENCHMARK("mutex Queue 4 producers 4 consumers (200000)") {
+        return runPipeline(4, 4, kItems, lockedPush, lockedPop);
+    };
+    BENCHMARK("MpmcQueue 1 producer 1 consumer (200000)") {
+        return runPipeline(1, 1, kItems, mpmcPush, mpmcPop);
+    };
+    BENCHMARK("MpmcQueue 4 producers 4 consumers (200000)") {
+        return runPipeline(4, 4, kItems, mpmcPush, mpmcPop);
+    };
+}
+
+
+
+// одна пара потоков через BlockingQueue: по элементу или пакетами
+std::size_t runBlockingPair(int items, std::size_t batch)
+{
+    BlockingQueue queue(1024);
+    std::thread producer([&queue, items, batch]() {
+        std::vector<std::string> pending;
+        for (int i = 0; i < items; ++i) {
+            if (batch == 1) {
+                queue.push(std::to_string(i));
+                continue;
+            }
+            pending.push_back(std::to_string(i));
+            if (pending.size() == batch) {
+                queue.pushBatch(std::make_move_iterator(pending.begin()),
+                                std::make_move_iterator(pending.end()));
+                pending.clear();
+            }
+        }
+        queue.pushBatch(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+        queue.close();
+    });
+
+    std::size_t received = 0;
+    if (batch == 1) {
+        std::string out;
+        while (queue.popWait(out, std::chrono::seconds(5))) {
+            ++received;
+        }
+    } else {
+        std::vector<std::string> out;
+        while (queue.popBatch(batch, out, std::chrono::seconds(5)) > 0) {
+            received += out.size();
+            out.clear();
+        }
+    }
+    producer.join();
+    return received;
+}
+
+TEST_CASE("Benchmark: BlockingQueue producer/consumer pair", "[!benchmark][BlockingQueue]")
+{
+    constexpr int kItems = 100000;
+    BENCHMARK("BlockingQueue push/popWait per item (100000)") {
+        return runBlockingPair(kItems, 1);
+    };
+    BENCHMARK("BlockingQueue pushBatch/popBatch by 64 (100000)") {
+        return runBlockingPair(kItems, 64);
+    };
+
+    // задержка: пинг-понг одной строкой между двумя потоками
+    BENCHMARK("BlockingQueue ping-pong round trip (x1000)") {
+        BlockingQueue ping;
+        BlockingQueue pong;
+        std::thread echo([&]() {
+            std::string value;
+            while (ping.popWait(value, std::chrono::seconds(5))) {
+                pong.push(std::move(value));
+            }
+        });
+        std::string value;
+        for (int i = 0; i < 1000; ++i) {
+            ping.push("ball");
+            (void)pong.popWait(value, std::chrono::seconds(5));
+        }
+        ping.close();
+        echo.join();
+        return value.size();
+    };
+}
+
+
+
+//  Пул потоков: дерево задач «fork-join». Задача "n" при n > 0 порождает
+//  две задачи "n-1"; всё дерево стартует с одной задачи у работника 0.
+//  Вариант с деками: свои задачи — с низа своего дека, чужие — кражей
+//  сверху. Вариант с общей очередью: все задачи под одним мьютексом.
+
+namespace
+{
+std::atomic<std::size_t> poolChecksum{0};   // чтобы работу задач не выбросил оптимизатор
+
+std::size_t burnTask(const std::string& task)
+{
+    // немного настоящей работы на каждую задачу
+    std::size_t hash = task.size();
+    for (int i = 0; i < 200; ++i) {
+        hash = hash * 1099511628211ULL + static_cast<unsigned char>(task[i % task.size()]);
+    }
+    return hash;
+}
+
+std::vector<std::size_t> runStealingPool(int workers, int depth)
+{
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+    for (int w = 0; w < workers; ++w) {
+        deques.push_back(std::make_unique<WorkStealingDeque>());
+    }
+    std::atomic<long> pending{1};
+    deques[0]->push(std::to_string(depth));
+
+    std::vector<std::size_t> processed(workers, 0);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            std::string task;
+            std::size_t sink = 0;
+            unsigned victim = static_cast<unsigned>(w);
+            while (pending.load(std::memory_order_acquire) > 0) {
+                bool got = deques[w]->pop(task);
+                for (int attempt = 0; !got && attempt < workers; ++attempt) {
+                    victim = (victim + 1) % static_cast<unsigned>(workers);
+                    got = victim != static_cast<unsigned>(w) && deques[victim]->steal(task);
+                }
+                if (!got) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                sink += burnTask(task);
+                const int n = std::stoi(task);
+                if (n > 0) {
+                    pending.fetch_add(2, std::memory_order_relaxed);
+                    deques[w]->push(std::to_string(n - 1));
+                    deques[w]->push(std::to_string(n - 1));
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+                ++processed[w];
+            }
+            poolChecksum.fetch_add(sink, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return processed;
+}
+
+std::vector<std::size_t> runLockedQueuePool(int workers, int depth)
+{
+    Queue queue;
+    std::mutex lock;
+    std::atomic<long> pending{1};
+    queue.push(std::to_string(depth));
+
+    std::vector<std::size_t> processed(workers, 0);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            std::string task;
+            std::size_t sink = 0;
+            while (pending.load(std::memory_order_acquire) > 0) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (queue.empty()) {
+                        task.clear();
+                    } else {
+                        task = queue.pop();
+                    }
+                }
+                if (task.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                sink += burnTask(task);
+                const int n = std::stoi(task);
+                if (n > 0) {
+                    pending.fetch_add(2, std::memory_order_relaxed);
+                    std::lock_guard<std::mutex> guard(lock);
+                    queue.push(std::to_string(n - 1));
+                    queue.push(std::to_string(n - 1));
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+                ++processed[w];
+            }
+            poolChecksum.fetch_add(sink, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return processed;
+}
+
+std::size_t total(const std::vector<std::size_t>& processed)
+{
+    std::size_t sum = 0;
+    for (std::size_t count : processed) {
+        sum += count;
+    }
+    return sum;
+}
+} // namespace
+
+TEST_CASE("Benchmark: work-stealing pool vs mutex Queue pool", "[!benchmark][WorkStealingDeque]")
+{
+    constexpr int kDepth = 15;   // 65535 задач
+    const int cores = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+
+    // распределение задач по работникам: всё дерево начиналось у работника 0
+    const std::vector<std::size_t> spread = runStealingPool(4, kDepth);
+    std::ostringstream perWorker;
+    for (std::size_t count : spread) {
+        perWorker << ' ' << count;
+    }
+    WARN("work-stealing pool, tasks per worker:" << perWorker.str() << " (cores: " << cores << ")");
+    REQUIRE(total(spread) == 65535);   // дерево обработано целиком
+
+    for (int workers : {1, 2, 4}) {
+        BENCHMARK("work-stealing pool " + std::to_string(workers) + " workers (65535 tasks)") {
+            return total(runStealingPool(workers, kDepth));
+        };
+        BENCHMARK("mutex Queue pool " + std::to_string(workers) + " workers (65535 tasks)") {
+            return total(runLockedQueuePool(workers, kDepth));
+        };
+    }
+}
+
+
+
+//  PRIORITY_QUEUE 
+
+
+namespace
+{
+// прежняя эмуляция в DBMS: ключ «приоритет с нулями|номер|значение» в AvlTree,
+// минимум — nth(0) и remove
+std::string avlPriorityKey(std::int64_t priority, std::uint64_t order, const std::string& value)
+{
+    char prefix[48];
+    std::snprintf(prefix, sizeof(prefix), "%020lld|%010llu|",
+                  static_cast<long long>(priority) + 1000000000LL, static_cast<unsigned long long>(order));
+    return prefix + value;
+}
+} // namespace
+
+TEST_CASE("Benchmark: PriorityQueue vs AvlTree emulation", "[!benchmark][PriorityQueue]")
+{
+    constexpr int kCount = 20000;
+    std::mt19937 rng(49);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    std::vector<std::int64_t> priorities(kCount);
+    for (std::int64_t& priority : priorities) {
+        priority = dist(rng);
+    }
+    const std::string payload(24, 'p');   // строки длиннее SSO
+
+    BENCHMARK("PriorityQueue push + pop all (20000)") {
+        PriorityQueue pq;
+        for (int i = 0; i < kCount; ++i) {
+            pq.push(priorities[i], payload);
+        }
+        std::size_t total = 0;
+        while (!pq.empty()) {
+            total += pq.pop().size();
+        }
+        return total;
+    };
+
+    BENCHMARK("AvlTree emulation insert + nth(0)/remove all (20000)") {
+        AvlTree tree;
+        for (int i = 0; i < kCount; ++i) {
+            tree.insert(avlPriorityKey(priorities[i], static_cast<std::uint64_t>(i), payload));
+        }
+        std::size_t total = 0;
+        while (tree.size() > 0) {
+            const std::string smallest(tree.nth(0));
+            total += smallest.size();
+            tree.remove(smallest);
+        }
+        return total;
+    };
 
+    // установившийся режим: очередь держит 10000 элементов
+    PriorityQueue steady;
+    for (int i = 0; i < 10000; ++i) {
+        steady.push(priorities[i], payload);
+    }
+    BENCHMARK("PriorityQueue push + pop 20000 at size 10000") {
+        std::size_t total = 0;
+        for (int i = 0; i < kCount; ++i) {
+            steady.push(steady.topPriority() + priorities[i], payload);
+            total += steady.pop().size();
+        }
+        return total;
+    };
+}
 
 //  HASHTABLE 
 
@@ -199,6 +924,141 @@ TEST_CASE("Benchmark: HashTableOpen find", "[!benchmark]")
     };
 }
 
+namespace
+{
+// find: 1000 попаданий и 1000 промахов на таблице из size элементов
+void benchmarkOpenTableAtSize(int size)
+{
+    HashTableOpen table;
+    for (int i = 0; i < size; ++i)
+        table.insert("k" + std::to_string(i), "v");
+
+    std::vector<std::string> probes;
+    for (int i = 0; i < 1000; ++i) {
+        probes.push_back("k" + std::to_string((i * 7919) % size));
+        probes.push_back("miss" + std::to_string(i));
+    }
+
+    BENCHMARK("HashTableOpen::find 2000 probes (" + std::to_string(size) + ")") {
+        std::size_t hits = 0;
+        for (const auto& key : probes)
+            hits += table.find(key) != nullptr ? 1U : 0U;
+        return hits;
+    };
+
+    BENCHMARK("HashTableOpen::insert " + std::to_string(size)) {
+        HashTableOpen fresh;
+        for (int i = 0; i < size; ++i)
+            fresh.insert("k" + std::to_string(i), "v");
+        return fresh.size();
+    };
+}
+} // namespace
+
+TEST_CASE("Benchmark: HashTableOpen by size", "[!benchmark]")
+{
+    for (int size : {1000, 10000, 100000})
+        benchmarkOpenTableAtSize(size);
+}
+
+// большие размеры запускаются явно: ./tests_run "[large]" --benchmark-samples 3
+TEST_CASE("Benchmark: HashTableOpen large sizes", "[.][large][!benchmark]")
+{
+    for (int size : {1000000, 10000000})
+        benchmarkOpenTableAtSize(size);
+}
+
+
+
+//  ЗАГРУЗКА СНАПШОТОВ ХЕШ-ТАБЛИЦ 
+
+
+TEST_CASE("Benchmark: hash table snapshot load", "[!benchmark]")
+{
+    HashTable chained;
+    HashTableOpen open;
+    for (int i = 0; i < 200000; ++i) {
+        chained.insert("key" + std::to_string(i), "value" + std::to_string(i));
+        open.insert("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+
+    std::ostringstream chainedOut(std::ios::binary);
+    chained.serializeBinary(chainedOut);
+    const std::string chainedData = chainedOut.str();
+
+    std::ostringstream openOut(std::ios::binary);
+    open.serializeBinary(openOut);
+    const std::string openData = openOut.str();
+
+    BENCHMARK("HashTable::deserializeBinary 200000") {
+        std::istringstream in(chainedData, std::ios::binary);
+        HashTable table;
+        table.deserializeBinary(in);
+        return table.size();
+    };
+
+    BENCHMARK("HashTableOpen::deserializeBinary 200000") {
+        std::istringstream in(openData, std::ios::binary);
+        HashTableOpen table;
+        table.deserializeBinary(in);
+        return table.size();
+    };
+}
+
+
+
+//  ФИЛЬТР БЛУМА: ПОИСК С ПРЕОБЛАДАНИЕМ ПРОМАХОВ
+
+
+namespace
+{
+// 100000 ключей, 9 из 10 запросов — промахи
+template <class Lookup>
+void benchmarkMissHeavy(const std::string& name, Lookup&& lookup)
+{
+    std::vector<std::string> probes;
+    for (int i = 0; i < 10000; ++i) {
+        probes.push_back(i % 10 == 0 ? "key" + std::to_string(i * 7)
+                                     : "miss" + std::to_string(i));
+    }
+
+    BENCHMARK(name + " 10000 probes, 90% misses") {
+        std::size_t hits = 0;
+        for (const auto& key : probes)
+            hits += lookup(key) ? 1U : 0U;
+        return hits;
+    };
+}
+} // namespace
+
+TEST_CASE("Benchmark: miss-heavy lookups with and without Bloom filter", "[!benchmark]")
+{
+    HashTable chained;
+    HashTableOpen open;
+    AvlTree tree;
+    for (int i = 0; i < 100000; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        chained.insert(key, "v");
+        open.insert(key, "v");
+        tree.insert(key);
+    }
+
+    for (bool withFilter : {false, true}) {
+        const std::string suffix = withFilter ? " (bloom)" : "";
+        if (withFilter) {
+            chained.enableBloomFilter();
+            open.enableBloomFilter();
+            tree.enableBloomFilter();
+        }
+        benchmarkMissHeavy("HashTable::find" + suffix,
+                           [&](const std::string& key) { return chained.find(key) != nullptr; });
+        benchmarkMissHeavy("HashTableOpen::find" + suffix,
+                           [&](const std::string& key) { return open.find(key) != nullptr; });
+        benchmarkMissHeavy("AvlTree::contains" + suffix,
+                           [&](const std::string& key) { return tree.contains(key); });
+    }
+}
+
 
 
 //  AVL TREE 
@@ -223,5 +1083,237 @@ TEST_CASE("Benchmark: AvlTree contains", "[!benchmark]")
         return t.contains("15000");
     };
 }
+
+namespace
+{
+// вставка, 100000 поисков и бинарный снапшот дерева из size узлов
+void benchmarkAvlAtSize(int size)
+{
+    std::vector<std::string> keys;
+    keys.reserve(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i)
+        keys.push_back(std::to_string((static_cast<long long>(i) * 7919) % size));
+
+    const std::string label = " (" + std::to_string(size) + ")";
+    BENCHMARK_ADVANCED("AvlTree::insert" + label)(Catch::Benchmark::Chronometer meter) {
+        AvlTree tree;
+        meter.measure([&] {
+            for (const auto& key : keys)
+                tree.insert(key);
+            return tree.size();
+        });
+    };
+
+    AvlTree tree;
+    for (const auto& key : keys)
+        tree.insert(key);
+
+    BENCHMARK("AvlTree::contains 100000 probes" + label) {
+        std::size_t hits = 0;
+        for (int i = 0; i < 100000; ++i)
+            hits += tree.contains(keys[static_cast<std::size_t>(i) % keys.size()]) ? 1U : 0U;
+        return hits;
+    };
+
+    BENCHMARK("AvlTree::serializeBinary" + label) {
+        std::ostringstream out(std::ios::binary);
+        tree.serializeBinary(out);
+        return out.tellp();
+    };
+
+    BENCHMARK("AvlTree copy + destroy" + label) {
+        AvlTree copy(tree);
+        return copy.size();
+    };
+
+    BENCHMARK("AvlTree::rank + nth 100000" + label) {
+        std::size_t sum = 0;
+        for (int i = 0; i < 100000; ++i) {
+            const std::size_t index = static_cast<std::size_t>(i) % keys.size();
+            sum += tree.rank(keys[index]) + tree.nth(index).size();
+        }
+        return sum;
+    };
+
+    BENCHMARK("AvlTree range scan 1000 x 100" + label) {
+        std::size_t seen = 0;
+        for (int i = 0; i < 1000; ++i) {
+            auto it = tree.lowerBound(keys[static_cast<std::size_t>(i) % keys.size()]);
+            for (int k = 0; k < 100 && it != tree.end(); ++k, ++it)
+                seen += (*it).size();
+        }
+        return seen;
+    };
+
+    std::ostringstream out(std::ios::binary);
+    tree.serializeBinary(out);
+    const std::string data = out.str();
+    BENCHMARK("AvlTree::deserializeBinary" + label) {
+        std::istringstream in(data, std::ios::binary);
+        AvlTree restored;
+        restored.deserializeBinary(in);
+        return restored.size();
+    };
+}
+} // namespace
+
+TEST_CASE("Benchmark: AvlTree by size", "[!benchmark]")
+{
+    benchmarkAvlAtSize(100000);
+}
+
+// ./tests_run "Benchmark: AvlTree large sizes" --benchmark-samples 3
+TEST_CASE("Benchmark: AvlTree large sizes", "[.][large][!benchmark]")
+{
+    for (int size : {1000000, 10000000})
+        benchmarkAvlAtSize(size);
+}
+TEST_CASE("Benchmark: AvlTree set operations", "[!benchmark]")
+{
+    // большое множество и маленькое, половина маленького пересекается
+    AvlTree large;
+    AvlTree small;
+    for (int i = 0; i < 200000; ++i)
+        large.insert("tag:" + std::to_string(i * 2));
+    for (int i = 0; i < 2000; ++i)
+        small.insert("tag:" + std::to_string(i * 199));
+
+    BENCHMARK("AvlTree intersection via contains (2000 x 200000)") {
+        AvlTree result;
+        for (std::string_view value : small) {
+            const std::string key(value);
+            if (large.contains(key))
+                result.insert(key);
+        }
+        return result.size();
+    };
+
+    BENCHMARK("AvlTree::intersectWith (2000 x 200000)") {
+        AvlTree result(small);
+        result.intersectWith(large);
+        return result.size();
+    };
+
+    BENCHMARK("AvlTree::subtract (2000 x 200000)") {
+        AvlTree result(small);
+        result.subtract(large);
+        return result.size();
+    };
+
+    BENCHMARK("AvlTree::unionWith (200000 + 2000)") {
+        AvlTree result(large);
+        result.unionWith(small);
+        return result.size();
+    };
+}
+
+namespace
+{
+// одни и те же операции над AvlTree и BPlusTree: вставка, поиск,
+// обход диапазона, загрузка снапшота
+template <typename Tree>
+void benchmarkOrderedSet(const std::string& name, const std::vector<std::string>& keys)
+{
+    const std::string label = " (" + std::to_string(keys.size()) + ")";
+    BENCHMARK_ADVANCED(name + "::insert" + label)(Catch::Benchmark::Chronometer meter) {
+        Tree tree;
+        meter.measure([&] {
+            for (const auto& key : keys)
+                tree.insert(key);
+            return tree.size();
+        });
+    };
+
+    Tree tree;
+    for (const auto& key : keys)
+        tree.insert(key);
+
+    BENCHMARK(name + "::contains 100000 probes" + label) {
+        std::size_t hits = 0;
+        for (int i = 0; i < 100000; ++i)
+            hits += tree.contains(keys[(static_cast<std::size_t>(i) * 40503) % keys.size()]) ? 1U : 0U;
+        return hits;
+    };
+
+    BENCHMARK(name + " range scan 1000 x 100" + label) {
+        std::size_t seen = 0;
+        for (int i = 0; i < 1000; ++i) {
+            auto it = tree.lowerBound(keys[(static_cast<std::size_t>(i) * 40503) % keys.size()]);
+            for (int k = 0; k < 100 && it != tree.end(); ++k, ++it)
+                seen += (*it).size();
+        }
+        return seen;
+    };
+
+    std::ostringstream out(std::ios::binary);
+    tree.serializeBinary(out);
+    const std::string data = out.str();
+    BENCHMARK(name + "::deserializeBinary" + label) {
+        std::istringstream in(data, std::ios::binary);
+        Tree restored;
+        restored.deserializeBinary(in);
+        return restored.size();
+    };
+}
+
+void benchmarkOrderedSetsAtSize(int size)
+{
+    std::vector<std::string> keys;
+    keys.reserve(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i)
+        keys.push_back("user:" + std::to_string((static_cast<long long>(i) * 7919) % size));
+
+    benchmarkOrderedSet<AvlTree>("AvlTree", keys);
+    benchmarkOrderedSet<BPlusTree>("BPlusTree", keys);
+}
+} // namespace
+
+TEST_CASE("Benchmark: BPlusTree vs AvlTree", "[!benchmark]")
+{
+    benchmarkOrderedSetsAtSize(100000);
+}
+
+// ./tests_run "Benchmark: BPlusTree vs AvlTree large sizes" --benchmark-samples 3
+TEST_CASE("Benchmark: BPlusTree vs AvlTree large sizes", "[.][large][!benchmark]")
+{
+    for (int size : {1000000, 10000000})
+        benchmarkOrderedSetsAtSize(size);
+}
+
+TEST_CASE("Benchmark: PersistentAvlTree snapshot vs AvlTree copy", "[!benchmark]")
+{
+    // снапшот для записи чекпоинта: копия AvlTree против новой версии
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100000; ++i)
+        keys.push_back("user:" + std::to_string((static_cast<long long>(i) * 7919) % 100000));
+
+    BENCHMARK_ADVANCED("PersistentAvlTree::insert (100000)")(Catch::Benchmark::Chronometer meter) {
+        PersistentAvlTree tree;
+        meter.measure([&] {
+            for (const auto& key : keys)
+                tree.insert(key);
+            return tree.size();
+        });
+    };
+
+    AvlTree mutableTree;
+    PersistentAvlTree persistentTree;
+    for (const auto& key : keys) {
+        mutableTree.insert(key);
+        persistentTree.insert(key);
+    }
+
+    BENCHMARK("AvlTree copy (100000)") {
+        AvlTree copy(mutableTree);
+        return copy.size();
+    };
+
+    BENCHMARK("PersistentAvlTree snapshot + 100 inserts (100000)") {
+        PersistentAvlTree version(persistentTree);
+        for (int i = 0; i < 100; ++i)
+            version.insert(keys[static_cast<std::size_t>(i)] + "+");
+        return version.size();
+    };
+}
 //./tests_run "[!benchmark]" --benchmark-samples 10
 
@@ -0,0 +1,80 @@
+// test_blocking_queue.cpp
+#include "catch_amalgamated.hpp"
+#include "blocking_queue.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+
+// 1. ОЖИДАНИЕ С ТАЙМАУТОМ И ЗАКРЫТИЕ
+
+
+TEST_CASE("BlockingQueue: popWait ждёт элемент или истекает по таймауту", "[BlockingQueue]")
+{
+    BlockingQueue queue;
+    std::string out;
+
+    const auto started = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(queue.popWait(out, 20ms));
+    REQUIRE(std::chrono::steady_clock::now() - started >= 20ms);
+
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(10ms);
+        queue.push("late");
+    });
+    REQUIRE(queue.popWait(out, 5s));
+    REQUIRE(out == "late");
+    producer.join();
+
+    // close будит ждущих; остаток дочитывается, новое не принимается
+    REQUIRE(queue.push("rest"));
+    std::thread closer([&queue]() {
+        std::this_thread::sleep_for(10ms);
+        queue.close();
+    });
+    REQUIRE(queue.popWait(out, 5s));
+    REQUIRE(out == "rest");
+    REQUIRE_FALSE(queue.popWait(out, 5s));
+    closer.join();
+    REQUIRE(queue.closed());
+    REQUIRE_FALSE(queue.push("after close"));
+    REQUIRE(queue.size() == 0);
+}
+
+
+// 2. КОНВЕЙЕР ПРОИЗВОДИТЕЛЬ → ПОТРЕБИТЕЛЬ
+
+
+TEST_CASE("BlockingQueue: пакеты при пределе доходят целиком и по порядку", "[BlockingQueue]")
+{
+    BlockingQueue queue(64);
+    constexpr int kItems = 20000;
+
+    std::thread producer([&queue]() {
+        std::vector<std::string> batch;
+        for (int i = 0; i < kItems; ++i) {
+            batch.push_back(std::to_string(i));
+            if (batch.size() == 100) {
+                queue.pushBatch(batch.begin(), batch.end());
+                batch.clear();
+            }
+        }
+        queue.close();
+    });
+
+    std::vector<std::string> received;
+    while (queue.popBatch(50, received, 5s) > 0) {
+    }
+    producer.join();
+
+    REQUIRE(received.size() == kItems);
+    int mismatches = 0;
+    for (int i = 0; i < kItems; ++i) {
+        mismatches += received[i] == std::to_string(i) ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+}
@@ -0,0 +1,99 @@
+#include "catch_amalgamated.hpp"
+#include "bloom_filter.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+
+// 1. ОТВЕТЫ ФИЛЬТРА
+
+
+TEST_CASE("BloomFilter: неактивный фильтр отвечает «возможно» и не занимает памяти", "[BloomFilter]")
+{
+    BloomFilter filter;
+    REQUIRE_FALSE(filter.active());
+    REQUIRE(filter.mayContain("anything"));
+    REQUIRE(filter.memoryUsage() == 0U);
+
+    filter.add("ignored");
+    REQUIRE(filter.itemCount() == 0U);
+}
+
+TEST_CASE("BloomFilter: нет ложноотрицательных, ложноположительных около процента", "[BloomFilter]")
+{
+    const int count = 20000;
+    BloomFilter filter(count);
+    for (int i = 0; i < count; ++i) {
+        filter.add("key" + to_string(i));
+    }
+    REQUIRE(filter.itemCount() == static_cast<size_t>(count));
+    REQUIRE(filter.saturated());
+
+    int missing = 0;
+    for (int i = 0; i < count; ++i) {
+        missing += filter.mayContain("key" + to_string(i)) ? 0 : 1;
+    }
+    REQUIRE(missing == 0);
+
+    int falsePositives = 0;
+    for (int i = 0; i < count; ++i) {
+        falsePositives += filter.mayContain("miss" + to_string(i)) ? 1 : 0;
+    }
+    // 10 бит на ключ: ~1% для обычного фильтра, блочный немного хуже
+    REQUIRE(falsePositives < count / 50);
+
+    filter.clearBits();
+    REQUIRE(filter.active());
+    REQUIRE_FALSE(filter.mayContain("key1"));
+}
+
+
+// 2. БИНАРНАЯ СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("BloomFilter: хвост снапшота читается, чужие данные не трогаются", "[BloomFilter]")
+{
+    BloomFilter filter(100);
+    filter.add("alpha");
+    filter.add("beta");
+
+    ostringstream oss(ios::binary);
+    filter.serializeBinary(oss);
+    oss << "rest";
+
+    istringstream iss(oss.str(), ios::binary);
+    BloomFilter restored;
+    REQUIRE(restored.deserializeBinary(iss));
+    REQUIRE(restored.mayContain("alpha"));
+    REQUIRE(restored.mayContain("beta"));
+    REQUIRE(restored.itemCount() == 2U);
+    REQUIRE(restored.blockCount() == filter.blockCount());
+
+    // дальше не фильтр: позиция потока сохраняется
+    REQUIRE_FALSE(restored.deserializeBinary(iss));
+    REQUIRE_FALSE(restored.active());
+    string rest;
+    iss >> rest;
+    REQUIRE(rest == "rest");
+
+    // конец потока: фильтра нет, поток остаётся годным
+    istringstream empty(string{}, ios::binary);
+    REQUIRE_FALSE(restored.deserializeBinary(empty));
+    REQUIRE(empty.good());
+}
+
+TEST_CASE("BloomFilter: обрезанный хвост выбрасывает", "[BloomFilter]")
+{
+    BloomFilter filter(100);
+    ostringstream oss(ios::binary);
+    filter.serializeBinary(oss);
+    string data = oss.str();
+    data.resize(data.size() - 8);
+
+    istringstream iss(data, ios::binary);
+    BloomFilter restored;
+    REQUIRE_THROWS_AS(restored.deserializeBinary(iss), runtime_error);
+}
@@ -0,0 +1,261 @@
+#include "catch_amalgamated.hpp"
+#include "bplus_tree.h"
+
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+// ключи разной длины: короткие решаются по префиксу, длинные с общим
+// началом — полным сравнением строк
+std::string mixedKey(std::uint32_t number)
+{
+    switch (number % 3) {
+    case 0:  return std::to_string(number);
+    case 1:  return "common_prefix_" + std::to_string(number);
+    default: return std::string("ab\0", 3) + std::to_string(number);
+    }
+}
+
+std::vector<std::string> contentsOf(const BPlusTree& tree)
+{
+    std::vector<std::string> values;
+    for (std::string_view value : tree) {
+        values.emplace_back(value);
+    }
+    return values;
+}
+} // namespace
+
+
+// 1. ВСТАВКА, ПОИСК, УДАЛЕНИЕ
+
+
+TEST_CASE("BPlusTree: пустое дерево, вставка, дубликаты и удаление", "[BPlusTree]")
+{
+    BPlusTree tree;
+    REQUIRE(tree.empty());
+    REQUIRE(tree.height() == 0);
+    REQUIRE(tree.begin() == tree.end());
+
+    tree.insert("b");
+    tree.insert("a");
+    tree.insert("c");
+    tree.insert("a");
+    REQUIRE(tree.size() == 3U);
+    REQUIRE(tree.contains("a"));
+    REQUIRE_FALSE(tree.contains("x"));
+    REQUIRE(contentsOf(tree) == std::vector<std::string>{"a", "b", "c"});
+
+    tree.remove("x");
+    tree.remove("b");
+    REQUIRE(tree.size() == 2U);
+    REQUIRE_FALSE(tree.contains("b"));
+
+    tree.remove("a");
+    tree.remove("c");
+    REQUIRE(tree.empty());
+    REQUIRE(tree.height() == 0);
+
+    std::ostringstream oss;
+    std::streambuf* oldBuf = std::cout.rdbuf(oss.rdbuf());
+    tree.print();
+    tree.insert("z");
+    tree.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(oss.str() == "(z) \n");
+}
+
+TEST_CASE("BPlusTree: вставки и удаления вперемешку совпадают с std::set", "[BPlusTree]")
+{
+    // достаточно ключей для трёх уровней, удаления сливают узлы обратно
+    BPlusTree tree;
+    std::set<std::string> model;
+    std::uint32_t state = 2024;
+    for (int step = 0; step < 60000; ++step) {
+        state = state * 1103515245U + 12345U;
+        const std::string value = mixedKey((state >> 8) % 20000);
+        if ((state >> 4) % 3 == 0) {
+            tree.remove(value);
+            model.erase(value);
+        } else {
+            tree.insert(value);
+            model.insert(value);
+        }
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(tree.height() >= 3);
+    REQUIRE(contentsOf(tree) == std::vector<std::string>(model.begin(), model.end()));
+
+    int mismatches = 0;
+    for (std::uint32_t i = 0; i < 20000; ++i) {
+        const std::string value = mixedKey(i);
+        mismatches += tree.contains(value) == (model.count(value) == 1) ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+
+    // удаление почти всего: дерево сжимается до одного листа
+    std::vector<std::string> values(model.begin(), model.end());
+    for (std::size_t i = 0; i + 5 < values.size(); ++i) {
+        tree.remove(values[(i * 7919) % values.size()]);
+        model.erase(values[(i * 7919) % values.size()]);
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(contentsOf(tree) == std::vector<std::string>(model.begin(), model.end()));
+}
+
+
+// 2. ПОРЯДКОВЫЕ ЗАПРОСЫ
+
+
+TEST_CASE("BPlusTree: lowerBound, upperBound, rank, nth, rangeCount и prefixRange", "[BPlusTree]")
+{
+    BPlusTree tree;
+    for (const char* value : {"apple", "apricot", "banana", "app", "ap", "b", "cherry"}) {
+        tree.insert(value);
+    }
+    // порядок: ap app apple apricot b banana cherry
+
+    REQUIRE(*tree.lowerBound("apq") == "apricot");
+    REQUIRE(*tree.upperBound("b") == "banana");
+    REQUIRE(tree.lowerBound("d") == tree.end());
+
+    REQUIRE(tree.rank("apple") == 2U);
+    REQUIRE(tree.rank("zzz") == 7U);
+    REQUIRE(tree.nth(3) == "apricot");
+    REQUIRE_THROWS_AS(tree.nth(7), std::out_of_range);
+    REQUIRE(tree.rangeCount("app", "b") == 4U);
+    REQUIRE(tree.rangeCount("b", "app") == 0U);
+
+    auto [first, last] = tree.prefixRange("app");
+    REQUIRE(std::distance(first, last) == 2);
+    REQUIRE(*first == "app");
+}
+
+TEST_CASE("BPlusTree: rank и nth верны по всему многоуровневому дереву", "[BPlusTree]")
+{
+    BPlusTree tree;
+    std::set<std::string> model;
+    std::uint32_t state = 99;
+    for (int step = 0; step < 15000; ++step) {
+        state = state * 1103515245U + 12345U;
+        const std::string value = mixedKey((state >> 8) % 6000);
+        if ((state >> 4) % 4 == 0) {
+            tree.remove(value);
+            model.erase(value);
+        } else {
+            tree.insert(value);
+            model.insert(value);
+        }
+    }
+
+    int mismatches = 0;
+    std::size_t index = 0;
+    for (const std::string& value : model) {
+        mismatches += tree.nth(index) == value ? 0 : 1;
+        mismatches += tree.rank(value) == index ? 0 : 1;
+        const auto it = tree.upperBound(value);
+        const auto expected = model.upper_bound(value);
+        mismatches += (it == tree.end()) == (expected == model.end()) ? 0 : 1;
+        if (it != tree.end() && expected != model.end()) {
+            mismatches += *it == *expected ? 0 : 1;
+        }
+        ++index;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(tree.rangeCount("1", "5")
+            == static_cast<std::size_t>(std::distance(model.lower_bound("1"),
+                                                      model.upper_bound("5"))));
+}
+
+
+// 3. СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("BPlusTree: текстовый и бинарный снапшоты восстанавливают дерево", "[BPlusTree]")
+{
+    BPlusTree tree;
+    for (std::uint32_t i = 0; i < 5000; ++i) {
+        tree.insert(mixedKey(i * 7));
+    }
+
+    BPlusTree fromText;
+    fromText.insert("old");
+    fromText.deserialize(tree.serialize());
+    REQUIRE(contentsOf(fromText) == contentsOf(tree));
+    REQUIRE(fromText.nth(4321) == tree.nth(4321));
+    REQUIRE_FALSE(fromText.contains("old"));
+
+    std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+    tree.serializeBinary(binary);
+    BPlusTree fromBinary;
+    fromBinary.deserializeBinary(binary);
+    REQUIRE(contentsOf(fromBinary) == contentsOf(tree));
+    REQUIRE(fromBinary.rank(mixedKey(700)) == tree.rank(mixedKey(700)));
+
+    // сборка снизу вверх даёт рабочее дерево: дальнейшие вставки и удаления
+    fromBinary.insert("new");
+    fromBinary.remove(mixedKey(0));
+    REQUIRE(fromBinary.contains("new"));
+    REQUIRE(fromBinary.size() == tree.size());
+
+    fromText.deserialize("");
+    REQUIRE(fromText.empty());
+}
+
+TEST_CASE("BPlusTree: неупорядоченный текст вставляется по одному, обрезанный выбрасывает", "[BPlusTree]")
+{
+    BPlusTree tree;
+    tree.deserialize("4\nc\na\nc\nb\n");
+    REQUIRE(contentsOf(tree) == std::vector<std::string>{"a", "b", "c"});
+
+    REQUIRE_THROWS_AS(tree.deserialize("3\nx\ny\n"), std::runtime_error);
+    REQUIRE(tree.size() == 3U);
+
+    std::istringstream truncated(std::string("\x02\0\0\0\0\0\0\0", 8), std::ios::binary);
+    REQUIRE_THROWS_AS(tree.deserializeBinary(truncated), std::runtime_error);
+    REQUIRE(tree.size() == 3U);
+}
+
+
+// 4. ПРАВИЛО ПЯТИ
+
+
+TEST_CASE("BPlusTree: копирование, перемещение и swap", "[BPlusTree]")
+{
+    BPlusTree tree;
+    for (std::uint32_t i = 0; i < 3000; ++i) {
+        tree.insert(mixedKey(i));
+    }
+
+    BPlusTree copy(tree);
+    copy.remove(mixedKey(1));
+    REQUIRE(tree.contains(mixedKey(1)));
+    REQUIRE(copy.size() == tree.size() - 1);
+    REQUIRE_FALSE(copy.contains(mixedKey(1)));
+
+    BPlusTree assigned;
+    assigned = tree;
+    assigned = assigned;
+    REQUIRE(contentsOf(assigned) == contentsOf(tree));
+
+    BPlusTree moved(std::move(assigned));
+    REQUIRE(moved.size() == tree.size());
+    REQUIRE(assigned.empty());
+
+    BPlusTree other;
+    other.insert("only");
+    other.swap(moved);
+    REQUIRE(other.size() == tree.size());
+    REQUIRE(moved.size() == 1U);
+
+    moved = std::move(other);
+    REQUIRE(contentsOf(moved) == contentsOf(tree));
+}
@@ -0,0 +1,174 @@
+#include "catch_amalgamated.hpp"
+#include "compact_string_array.h"
+#include "array.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+MyArray sampleArray()
+{
+    MyArray arr;
+    for (const char* value : {"alpha", "", "gamma with spaces", "русский текст", "x"}) {
+        arr.pushBack(value);
+    }
+    arr.pushBack(std::string(100, 'L'));
+    return arr;
+}
+
+std::string imageOf(const CompactStringArray& compact)
+{
+    std::ostringstream oss(std::ios::binary);
+    compact.serializeBinary(oss);
+    return oss.str();
+}
+} // namespace
+
+
+// 1. ПЕРЕВОД ИЗ MyArray И ОБРАТНО
+
+
+TEST_CASE("CompactStringArray: строки из MyArray лежат в одном буфере и возвращаются обратно", "[CompactStringArray]")
+{
+    const MyArray source = sampleArray();
+    const CompactStringArray compact(source);
+
+    REQUIRE(compact.size() == source.size());
+    REQUIRE(compact.totalChars() == 5 + 17 + std::string("русский текст").size() + 1 + 100);
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        REQUIRE(compact[i] == source[i]);
+    }
+    REQUIRE(compact.at(1).empty());
+    REQUIRE_THROWS_AS(compact.at(source.size()), std::out_of_range);
+
+    MyArray back = compact.toMyArray();
+    REQUIRE(back.serialize() == source.serialize());
+    back.pushBack("mutable again");
+    REQUIRE(back.size() == source.size() + 1);
+
+    // источник в режиме буфера с разрывом переводится в логическом порядке
+    MyArray gapped;
+    gapped.setGapBuffer(true);
+    gapped.pushBack("b");
+    gapped.insert(0, "a");
+    REQUIRE(CompactStringArray(gapped).serialize() == "2\na\nb\n");
+
+    const CompactStringArray empty{MyArray()};
+    REQUIRE(empty.empty());
+    REQUIRE(CompactStringArray().toMyArray().empty());
+}
+
+TEST_CASE("CompactStringArray: print, текстовая сериализация и правило пяти", "[CompactStringArray]")
+{
+    CompactStringArray compact;
+    compact.deserialize("3\none\n\nthree words\n");
+    REQUIRE(compact.size() == 3);
+    REQUIRE(compact[2] == "three words");
+    REQUIRE_THROWS_AS(compact.deserialize("2\nonly\n"), std::runtime_error);
+    REQUIRE(compact.size() == 3);
+
+    std::ostringstream oss;
+    std::streambuf* oldBuf = std::cout.rdbuf(oss.rdbuf());
+    compact.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(oss.str() == "[one, , three words]\n");
+
+    CompactStringArray copy(compact);
+    CompactStringArray moved(std::move(compact));
+    REQUIRE(compact.empty());
+    REQUIRE(moved.serialize() == copy.serialize());
+
+    CompactStringArray assigned;
+    assigned = copy;
+    assigned = assigned;
+    REQUIRE(assigned[0] == "one");
+    moved = CompactStringArray();
+    REQUIRE(moved.empty());
+}
+
+
+// 2. ОБРАЗ: ПОТОК, ЧУЖАЯ ПАМЯТЬ, ФАЙЛ
+
+
+TEST_CASE("CompactStringArray: бинарный образ читается из потока и используется на месте", "[CompactStringArray]")
+{
+    const CompactStringArray compact(sampleArray());
+    const std::string image = imageOf(compact);
+    REQUIRE(image.size() == compact.imageBytes());
+    REQUIRE(image.size() % 8 == 0);
+
+    std::istringstream iss(image, std::ios::binary);
+    CompactStringArray restored;
+    restored.deserializeBinary(iss);
+    REQUIRE(restored.serialize() == compact.serialize());
+
+    // образ в выровненном чужом буфере: без копирования и без своей памяти
+    std::vector<std::uint64_t> words(image.size() / 8);
+    std::memcpy(words.data(), image.data(), image.size());
+    const CompactStringArray view =
+        CompactStringArray::viewImage(reinterpret_cast<const char*>(words.data()), image.size());
+    REQUIRE(view[5].data() == reinterpret_cast<const char*>(words.data()) + image.size() - 104);
+    REQUIRE(view.memoryUsage() == sizeof(CompactStringArray));
+    REQUIRE(CompactStringArray(view).serialize() == compact.serialize());
+
+    std::istringstream emptyImage(imageOf(CompactStringArray()), std::ios::binary);
+    restored.deserializeBinary(emptyImage);
+    REQUIRE(restored.empty());
+}
+
+TEST_CASE("CompactStringArray: испорченный образ отвергается", "[CompactStringArray]")
+{
+    const std::string image = imageOf(CompactStringArray(sampleArray()));
+    std::vector<std::uint64_t> words(image.size() / 8);
+    std::memcpy(words.data(), image.data(), image.size());
+    const char* bytes = reinterpret_cast<const char*>(words.data());
+
+    REQUIRE_THROWS_AS(CompactStringArray::viewImage(bytes, image.size() - 8), std::runtime_error);
+    REQUIRE_THROWS_AS(CompactStringArray::viewImage(bytes + 1, 16), std::runtime_error);
+
+    words[3] = 1000;   // смещение второй строки за пределами символов
+    REQUIRE_THROWS_AS(CompactStringArray::viewImage(bytes, image.size()), std::runtime_error);
+    words[0] = 0;      // чужой заголовок
+    REQUIRE_THROWS_AS(CompactStringArray::viewImage(bytes, image.size()), std::runtime_error);
+
+    std::istringstream truncated(image.substr(0, image.size() - 8), std::ios::binary);
+    CompactStringArray restored;
+    restored.deserialize("1\nkept\n");
+    REQUIRE_THROWS_AS(restored.deserializeBinary(truncated), std::runtime_error);
+    REQUIRE(restored[0] == "kept");
+}
+
+TEST_CASE("CompactStringArray: файл с образом отображается в память", "[CompactStringArray]")
+{
+    const CompactStringArray compact(sampleArray());
+    const std::string path = "compact_string_array_test.img";
+    {
+        std::ofstream out(path, std::ios::binary);
+        compact.serializeBinary(out);
+    }
+
+    {
+        CompactStringArray mapped = CompactStringArray::mapFile(path);
+        REQUIRE(mapped.serialize() == compact.serialize());
+        REQUIRE(mapped.memoryUsage() == sizeof(CompactStringArray));
+        CompactStringArray moved(std::move(mapped));
+        REQUIRE(moved[0] == "alpha");
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not an image";
+    }
+    REQUIRE_THROWS_AS(CompactStringArray::mapFile(path), std::runtime_error);
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(CompactStringArray::mapFile(path), std::runtime_error);
+}
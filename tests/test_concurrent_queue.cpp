@@ -0,0 +1,198 @@
+// test_concurrent_queue.cpp
+#include "catch_amalgamated.hpp"
+#include "concurrent_queue.h"
+#include "queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// 1. ОДИН ПОТОК: FIFO, ПРЕДЕЛ, ОКРУГЛЕНИЕ ВМЕСТИМОСТИ
+
+
+TEMPLATE_TEST_CASE("Очереди без блокировок: FIFO, полная и пустая очередь", "[ConcurrentQueue]",
+                   SpscQueue, MpmcQueue)
+{
+    TestType queue(5);
+    REQUIRE(queue.capacity() == 8);
+    REQUIRE(queue.empty());
+    REQUIRE(TestType(0).capacity() == 2);
+
+    std::string out;
+    REQUIRE_FALSE(queue.tryPop(out));
+    REQUIRE_THROWS_AS(queue.pop(), std::out_of_range);
+
+    // несколько кругов по кольцу
+    const std::string longValue(60, 'L');
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 5; ++round) {
+        while (queue.tryPush(std::to_string(next) + (next % 3 == 0 ? longValue : ""))) {
+            ++next;
+        }
+        REQUIRE(queue.size() == 8);
+        REQUIRE_THROWS_AS(queue.push("overflow"), std::overflow_error);
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(queue.pop() == std::to_string(expected) + (expected % 3 == 0 ? longValue : ""));
+            ++expected;
+        }
+    }
+
+    std::string moved = "moved";
+    REQUIRE(queue.tryPush(std::move(moved)));
+    while (queue.tryPop(out)) {
+    }
+    REQUIRE(out == "moved");
+    REQUIRE(queue.empty());
+}
+
+
+// 2. СЕРИАЛИЗАЦИЯ — ФОРМАТЫ Queue
+
+
+TEMPLATE_TEST_CASE("Очереди без блокировок: форматы совпадают с Queue, загрузка растит кольцо", "[ConcurrentQueue]",
+                   SpscQueue, MpmcQueue)
+{
+    Queue reference;
+    TestType queue(4);
+    for (const char* value : {"alpha", "beta", "русский текст", "d", "e", "f"}) {
+        reference.push(value);
+        if (queue.size() == 4) {
+            (void)queue.pop();
+        }
+        queue.push(value);
+    }
+    // в очереди последние четыре значения, голова кольца не в нулевом слоте
+    for (int i = 0; i < 2; ++i) {
+        (void)reference.pop();
+    }
+    REQUIRE(queue.serialize() == reference.serialize());
+
+    std::ostringstream referenceBytes(std::ios::binary);
+    reference.serializeBinary(referenceBytes);
+    std::ostringstream bytes(std::ios::binary);
+    queue.serializeBinary(bytes);
+    REQUIRE(bytes.str() == referenceBytes.str());
+
+    std::ostringstream printed;
+    std::streambuf* oldBuf = std::cout.rdbuf(printed.rdbuf());
+    queue.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(printed.str() == "[русский текст, d, e, f]\n");
+
+    // больше строк, чем слотов: кольцо удваивается при загрузке
+    TestType small(2);
+    std::string text;
+    for (int i = 0; i < 37; ++i) {
+        text += "v" + std::to_string(i) + "\n";
+    }
+    small.deserialize(text);
+    REQUIRE(small.size() == 37);
+    REQUIRE(small.capacity() == 64);
+    REQUIRE(small.serialize() == text);
+
+    std::ostringstream bigBytes(std::ios::binary);
+    small.serializeBinary(bigBytes);
+    TestType restored(2);
+    std::istringstream input(bigBytes.str(), std::ios::binary);
+    restored.deserializeBinary(input);
+    REQUIRE(restored.serialize() == text);
+    REQUIRE(restored.pop() == "v0");
+
+    std::istringstream truncated(bigBytes.str().substr(0, 20), std::ios::binary);
+    REQUIRE_THROWS_AS(restored.deserializeBinary(truncated), std::runtime_error);
+}
+
+
+// 3. НЕСКОЛЬКО ПОТОКОВ
+
+
+TEST_CASE("SpscQueue: потребитель получает всё в порядке производителя", "[ConcurrentQueue]")
+{
+    SpscQueue queue(64);
+    constexpr int kItems = 200000;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < kItems; ++i) {
+            std::string value = std::to_string(i);
+            while (!queue.tryPush(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int mismatches = 0;
+    std::string out;
+    for (int i = 0; i < kItems; ++i) {
+        while (!queue.tryPop(out)) {
+            std::this_thread::yield();
+        }
+        mismatches += out == std::to_string(i) ? 0 : 1;
+    }
+    producer.join();
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("MpmcQueue: каждое значение забирают ровно один раз", "[ConcurrentQueue]")
+{
+    MpmcQueue queue(128);
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 50000;
+
+    std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+    std::atomic<int> consumed{0};
+    // у каждого производителя свои значения идут по возрастанию
+    std::atomic<int> orderViolations{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                const std::string value = std::to_string(p * kPerProducer + i);
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&]() {
+            std::vector<int> lastByProducer(kProducers, -1);
+            std::string out;
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (!queue.tryPop(out)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const int value = std::stoi(out);
+                seen[value].fetch_add(1);
+                int& last = lastByProducer[value / kPerProducer];
+                if (value <= last) {
+                    orderViolations.fetch_add(1);
+                }
+                last = value;
+                consumed.fetch_add(1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    int wrongCounts = 0;
+    for (const std::atomic<int>& count : seen) {
+        wrongCounts += count.load() == 1 ? 0 : 1;
+    }
+    REQUIRE(wrongCounts == 0);
+    REQUIRE(orderViolations.load() == 0);
+    REQUIRE(queue.empty());
+}
@@ -5,6 +5,10 @@
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
+#include <cstdint>
+#include <string>
+#include <string>
+#include <vector>
 
 
 // БАЗОВОЕ СОСТОЯНИЕ / ДЕСТРУКТОР / CLEAR
@@ -307,6 +311,228 @@ TEST_CASE("ForwardList: removeBefore обрабатывает граничные
 }
 
 
+// ХВОСТ И РАЗМЕР
+
+
+TEST_CASE("ForwardList: хвост и размер согласованы после любых удалений и вставок", "[ForwardList]")
+{
+    ForwardList list;
+    REQUIRE(list.empty());
+
+    // каждая операция, которая может сменить хвост, проверяется pushBack после неё
+    list.pushFront("a");
+    list.pushBack("b");
+    list.insertAfter("b", "c");       // новый хвост
+    list.pushBack("d");
+    list.removeAfter("c");            // удалён хвост
+    list.pushBack("e");
+    list.removeByValue("e");          // удалён хвост по значению
+    list.pushBack("f");
+    list.popBack();
+    list.pushBack("g");
+    list.insertBefore("a", "z");
+    list.removeBefore("b");           // "a"
+    REQUIRE(list.size() == 4);
+    REQUIRE(list.serialize() == "z\nb\nc\ng\n");
+
+    while (!list.empty()) {
+        list.popFront();
+    }
+    list.pushBack("only");
+    REQUIRE(list.size() == 1);
+    REQUIRE(list.serialize() == "only\n");
+    list.popBack();
+    list.pushFront("again");
+    list.pushBack("tail");
+    REQUIRE(list.serialize() == "again\ntail\n");
+}
+
+TEST_CASE("ForwardList: assign и загрузка собирают список за один проход", "[ForwardList]")
+{
+    const std::vector<std::string> values{"x", "y", "z"};
+    ForwardList list;
+    list.pushBack("old");
+    list.assign(values.begin(), values.end());
+    REQUIRE(list.size() == 3);
+    list.pushBack("w");
+    REQUIRE(list.serialize() == "x\ny\nz\nw\n");
+
+    ForwardList restored;
+    restored.deserialize(list.serialize());
+    restored.pushBack("after load");
+    REQUIRE(restored.size() == 5);
+
+    std::ostringstream oss(std::ios::binary);
+    restored.serializeBinary(oss);
+    ForwardList fromBinary;
+    std::istringstream iss(oss.str(), std::ios::binary);
+    fromBinary.deserializeBinary(iss);
+    fromBinary.pushBack("tail");
+    REQUIRE(fromBinary.size() == 6);
+    REQUIRE(fromBinary.serialize() == "x\ny\nz\nw\nafter load\ntail\n");
+
+    list.assign(values.end(), values.end());
+    REQUIRE(list.empty());
+}
+
+
+// ИНДЕКС ЗНАЧЕНИЙ
+
+
+TEST_CASE("ForwardList: операции с индексом значений совпадают с проходом", "[ForwardList]")
+{
+    // мало различных значений — много повторов и смен первого вхождения
+    ForwardList plain;
+    ForwardList indexed;
+    indexed.enableValueIndex();
+    REQUIRE(indexed.hasValueIndex());
+
+    std::uint32_t state = 17;
+    auto next = [&state](std::uint32_t bound) {
+        state = state * 1103515245U + 12345U;
+        return (state >> 8) % bound;
+    };
+    int mismatches = 0;
+    for (int step = 0; step < 6000; ++step) {
+        const std::string a = "v" + std::to_string(next(40));
+        const std::string b = "v" + std::to_string(next(40));
+        switch (next(9)) {
+        case 0:  plain.pushFront(a);        indexed.pushFront(a);        break;
+        case 1:  plain.pushBack(a);         indexed.pushBack(a);         break;
+        case 2:  plain.insertAfter(a, b);   indexed.insertAfter(a, b);   break;
+        case 3:  plain.insertBefore(a, b);  indexed.insertBefore(a, b);  break;
+        case 4:  plain.removeAfter(a);      indexed.removeAfter(a);      break;
+        case 5:  plain.removeBefore(a);     indexed.removeBefore(a);     break;
+        case 6:  plain.popBack();           indexed.popBack();           break;
+        case 7:  plain.popFront();          indexed.popFront();          break;
+        default:
+            if (next(8) == 0) {
+                plain.removeByValue(a);
+                indexed.removeByValue(a);
+            }
+            break;
+        }
+        mismatches += plain.findNode(b) == nullptr && indexed.findNode(b) == nullptr ? 0
+                    : plain.findNode(b) != nullptr && indexed.findNode(b) != nullptr ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(indexed.serialize() == plain.serialize());
+
+    // через индекс находится первое вхождение: хвосты списка от узла совпадают
+    for (int i = 0; i < 40; ++i) {
+        const std::string value = "v" + std::to_string(i);
+        std::string expected;
+        std::string actual;
+        for (FNode* node = plain.findNode(value); node != nullptr; node = node->getNext()) {
+            expected += node->getValue() + ' ';
+        }
+        for (FNode* node = indexed.findNode(value); node != nullptr; node = node->getNext()) {
+            actual += node->getValue() + ' ';
+        }
+        mismatches += expected == actual ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(indexed.size() == plain.size());
+
+    // загрузка перестраивает индекс, выключение его освобождает
+    indexed.deserialize("x\ny\nx\n");
+    indexed.insertAfter("x", "after first x");
+    REQUIRE(indexed.serialize() == "x\nafter first x\ny\nx\n");
+    REQUIRE(indexed.findNode("y") != nullptr);
+    indexed.disableValueIndex();
+    REQUIRE_FALSE(indexed.hasValueIndex());
+    indexed.removeByValue("x");
+    REQUIRE(indexed.serialize() == "after first x\ny\n");
+}
+
+
+// ПЕРЕНОС УЗЛОВ
+
+
+TEST_CASE("ForwardList: spliceAfter/concat/splitAt переносят узлы без копирования строк", "[ForwardList]")
+{
+    const std::string longValue(40, 'L');
+    ForwardList a;
+    ForwardList b;
+    a.pushBack("a1");
+    a.pushBack("a2");
+    b.pushBack(longValue);
+    b.pushBack("b2");
+    const char* storage = b.findNode(longValue)->getValue().data();
+
+    a.spliceAfter(a.findNode("a1"), b);   // после a1
+    REQUIRE(a.serialize() == "a1\n" + longValue + "\nb2\na2\n");
+    REQUIRE(a.size() == 4);
+    REQUIRE(b.empty());
+    REQUIRE(a.findNode(longValue)->getValue().data() == storage);
+
+    // пустой и собственный источник ничего не меняют
+    a.concat(b);
+    a.concat(a);
+    REQUIRE(a.size() == 4);
+
+    b.pushBack("b3");
+    a.spliceAfter(nullptr, b);            // в начало
+    b.pushBack("b4");
+    a.concat(b);                     // в конец
+    REQUIRE(a.serialize() == "b3\na1\n" + longValue + "\nb2\na2\nb4\n");
+
+    // хвост дописывается к rest
+    ForwardList rest;
+    rest.pushBack("r");
+    a.splitAt(4, rest);
+    REQUIRE(a.serialize() == "b3\na1\n" + longValue + "\nb2\n");
+    REQUIRE(rest.serialize() == "r\na2\nb4\n");
+    REQUIRE(a.size() == 4);
+    REQUIRE(rest.size() == 3);
+    a.splitAt(1, rest);
+    REQUIRE(a.serialize() == "b3\n");
+    REQUIRE(rest.findNode(longValue)->getValue().data() == storage);
+    a.splitAt(1, rest);   // index == size — ничего
+    a.splitAt(0, rest);
+    REQUIRE(a.empty());
+    REQUIRE(rest.serialize() == "r\na2\nb4\na1\n" + longValue + "\nb2\nb3\n");
+
+    // хвост и голова согласованы после переносов
+    a.pushBack("x");
+    a.pushFront("w");
+    rest.popBack();
+    rest.pushBack("end");
+    REQUIRE(a.serialize() == "w\nx\n");
+    REQUIRE(rest.size() == 7);
+}
+
+TEST_CASE("ForwardList: перенос узлов поддерживает индексы значений", "[ForwardList]")
+{
+    ForwardList indexed;
+    ForwardList plain;
+    indexed.enableValueIndex();
+    for (int i = 0; i < 6; ++i) {
+        indexed.pushBack("i" + std::to_string(i));
+        plain.pushBack("p" + std::to_string(i % 3));
+    }
+
+    indexed.concat(plain);   // индекс принимающего пополняется
+    REQUIRE(indexed.findNode("p2") != nullptr);
+    indexed.removeByValue("p1");
+    REQUIRE(indexed.size() == 10);
+
+    ForwardList other;
+    other.enableValueIndex();
+    indexed.splitAt(3, other);   // узлы уходят из индекса источника
+    REQUIRE(indexed.findNode("i4") == nullptr);
+    REQUIRE(indexed.findNode("i2") != nullptr);
+    REQUIRE(other.findNode("i4") != nullptr);
+    other.removeByValue("p0");
+    REQUIRE(other.serialize() == "i3\ni4\ni5\np2\np2\n");
+
+    indexed.spliceAfter(nullptr, other);
+    REQUIRE(other.findNode("i3") == nullptr);
+    indexed.removeByValue("p2");
+    REQUIRE(indexed.serialize() == "i3\ni4\ni5\ni0\ni1\ni2\n");
+}
+
+
 // PRINT
 
 
@@ -436,3 +662,20 @@ TEST_CASE("ForwardList: serializeBinary бросает, если поток в 
 
     REQUIRE_THROWS_AS(list.serializeBinary(oss), std::runtime_error);
 }
+
+TEST_CASE("ForwardList: обрезанный бинарный поток не меняет список", "[ForwardList]")
+{
+    ForwardList source;
+    source.pushBack("first");
+    source.pushBack("second");
+    std::ostringstream oss(std::ios::binary);
+    source.serializeBinary(oss);
+    const std::string bin = oss.str();
+
+    ForwardList list;
+    list.pushBack("kept");
+    std::istringstream truncated(bin.substr(0, bin.size() - 2), std::ios::binary);
+    REQUIRE_THROWS_AS(list.deserializeBinary(truncated), std::runtime_error);
+    REQUIRE(list.size() == 1);
+    REQUIRE(list.serialize() == "kept\n");
+}
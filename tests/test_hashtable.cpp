@@ -1,11 +1,13 @@
 
 #include "catch_amalgamated.hpp"
 #include "hashtable.h"
+#include "parallel.h"
 
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <cstdint>
 
 
 // HashTable — базовые свойства / конструкторы
@@ -628,3 +630,205 @@ TEST_CASE("HashTableOpen: serializeBinary бросает, если поток в
 
     REQUIRE_THROWS_AS(table.serializeBinary(oss), runtime_error);
 }
+
+
+// Загрузка снапшота: предвыделение и параллельная вставка
+
+
+namespace
+{
+void writeSized(ostream& out, const string& text)
+{
+    const uint64_t size = text.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(text.data(), static_cast<streamsize>(text.size()));
+}
+
+// снапшот с повтором ключа "dup": значение из последней записи должно победить
+string snapshotWithDuplicates(int count)
+{
+    ostringstream oss(ios::binary);
+    const uint64_t total = static_cast<uint64_t>(count) + 2;
+    oss.write(reinterpret_cast<const char*>(&total), sizeof(total));
+    writeSized(oss, "dup");
+    writeSized(oss, "first");
+    for (int i = 0; i < count; ++i) {
+        writeSized(oss, "key" + to_string(i));
+        writeSized(oss, "v" + to_string(i));
+    }
+    writeSized(oss, "dup");
+    writeSized(oss, "last");
+    return oss.str();
+}
+
+// параллельная ветка включается даже на одноядерной машине
+struct WorkerLimitGuard
+{
+    explicit WorkerLimitGuard(unsigned limit) { parallel::setWorkerLimit(limit); }
+    ~WorkerLimitGuard() { parallel::setWorkerLimit(0); }
+};
+} // namespace
+
+TEST_CASE("HashTable: deserializeBinary большого снапшота по частям", "[HashTable]")
+{
+    WorkerLimitGuard limit(4);
+    const int count = 70000;
+    const string data = snapshotWithDuplicates(count);
+
+    istringstream iss(data, ios::binary);
+    HashTable table;
+    table.insert("stale", "x");
+    table.deserializeBinary(iss);
+
+    REQUIRE(table.size() == static_cast<size_t>(count) + 1);
+    REQUIRE(table.find("stale") == nullptr);
+    REQUIRE(*table.find("dup") == "last");
+    for (int i = 0; i < count; i += 997) {
+        REQUIRE(*table.find("key" + to_string(i)) == "v" + to_string(i));
+    }
+    // бакеты выделены сразу: load factor не выше 0.75
+    REQUIRE(table.size() * 4 <= table.bucketCount() * 3);
+
+    // после загрузки таблица работает как обычно
+    table.insert("after", "1");
+    table.erase("key0");
+    REQUIRE(*table.find("after") == "1");
+    REQUIRE(table.find("key0") == nullptr);
+    REQUIRE(table.size() == static_cast<size_t>(count) + 1);
+}
+
+TEST_CASE("HashTableOpen: deserializeBinary большого снапшота по частям", "[HashTableOpen]")
+{
+    WorkerLimitGuard limit(4);
+    const int count = 70000;
+    const string data = snapshotWithDuplicates(count);
+
+    istringstream iss(data, ios::binary);
+    HashTableOpen table;
+    table.insert("stale", "x");
+    table.deserializeBinary(iss);
+
+    REQUIRE(table.size() == static_cast<size_t>(count) + 1);
+    REQUIRE(table.find("stale") == nullptr);
+    REQUIRE(*table.find("dup") == "last");
+    int mismatches = 0;
+    for (int i = 0; i < count; ++i) {
+        const string* value = table.find("key" + to_string(i));
+        if (value == nullptr || *value != "v" + to_string(i)) {
+            ++mismatches;
+        }
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(table.size() * 2 < table.capacity());
+
+    // повторная сериализация даёт ту же таблицу
+    ostringstream oss(ios::binary);
+    table.serializeBinary(oss);
+    istringstream again(oss.str(), ios::binary);
+    HashTableOpen restored;
+    restored.deserializeBinary(again);
+    REQUIRE(restored.size() == table.size());
+    REQUIRE(*restored.find("dup") == "last");
+}
+
+TEST_CASE("HashTable: deserializeBinary бросает на обрезанном снапшоте", "[HashTable]")
+{
+    string data = snapshotWithDuplicates(10);
+    data.resize(data.size() - 3);
+
+    istringstream iss(data, ios::binary);
+    HashTable table;
+    REQUIRE_THROWS_AS(table.deserializeBinary(iss), runtime_error);
+
+    istringstream iss2(data, ios::binary);
+    HashTableOpen open;
+    REQUIRE_THROWS_AS(open.deserializeBinary(iss2), runtime_error);
+}
+
+TEST_CASE("HashTable: фильтр Блума не теряет ключей и переживает снапшот", "[HashTable][BloomFilter]")
+{
+    HashTable table;
+    for (int i = 0; i < 100; ++i) {
+        table.insert("key" + to_string(i), "v" + to_string(i));
+    }
+    table.enableBloomFilter();
+    REQUIRE(table.hasBloomFilter());
+
+    // вставки после включения, в том числе сверх расчётной ёмкости
+    for (int i = 100; i < 1000; ++i) {
+        table.insert("key" + to_string(i), "v" + to_string(i));
+    }
+    table.insert("key5", "updated");
+    table.erase("key7");
+
+    int mismatches = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const string* value = table.find("key" + to_string(i));
+        mismatches += (i == 7) == (value == nullptr) ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(*table.find("key5") == "updated");
+    REQUIRE(table.size() == 999U);
+    REQUIRE(table.find("absent") == nullptr);
+
+    ostringstream oss(ios::binary);
+    table.serializeBinary(oss);
+    istringstream iss(oss.str(), ios::binary);
+    HashTable restored;
+    restored.deserializeBinary(iss);
+    REQUIRE(restored.hasBloomFilter());
+    REQUIRE(restored.size() == 999U);
+    REQUIRE(*restored.find("key999") == "v999");
+
+    HashTable copy(restored);
+    REQUIRE(copy.hasBloomFilter());
+    REQUIRE(copy.find("key500") != nullptr);
+
+    copy.clear();
+    copy.insert("fresh", "1");
+    REQUIRE(*copy.find("fresh") == "1");
+    REQUIRE(copy.find("key500") == nullptr);
+
+    // без фильтра снапшот прежний и фильтр не появляется
+    restored.disableBloomFilter();
+    ostringstream plain(ios::binary);
+    restored.serializeBinary(plain);
+    REQUIRE(plain.str().size() < oss.str().size());
+    istringstream plainIn(plain.str(), ios::binary);
+    HashTable fromPlain;
+    fromPlain.deserializeBinary(plainIn);
+    REQUIRE_FALSE(fromPlain.hasBloomFilter());
+}
+
+TEST_CASE("HashTableOpen: фильтр Блума строится при загрузке старого снапшота", "[HashTableOpen][BloomFilter]")
+{
+    HashTableOpen source;
+    for (int i = 0; i < 500; ++i) {
+        source.insert("key" + to_string(i), "v" + to_string(i));
+    }
+    ostringstream oss(ios::binary);
+    source.serializeBinary(oss);
+
+    // таблица с включённым фильтром загружает снапшот без хвоста
+    HashTableOpen table;
+    table.enableBloomFilter();
+    istringstream iss(oss.str(), ios::binary);
+    table.deserializeBinary(iss);
+    REQUIRE(table.hasBloomFilter());
+
+    int missing = 0;
+    for (int i = 0; i < 500; ++i) {
+        missing += table.find("key" + to_string(i)) != nullptr ? 0 : 1;
+    }
+    REQUIRE(missing == 0);
+    REQUIRE(table.find("miss") == nullptr);
+
+    table.erase("key1");
+    table.insert("key1", "again");
+    REQUIRE(*table.find("key1") == "again");
+
+    HashTableOpen moved(std::move(table));
+    REQUIRE(moved.hasBloomFilter());
+    REQUIRE_FALSE(table.hasBloomFilter());
+    REQUIRE(moved.find("key499") != nullptr);
+}
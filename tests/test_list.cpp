@@ -5,6 +5,8 @@
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
+#include <cstdint>
+#include <string>
 
 
 // БАЗОВОЕ СОСТОЯНИЕ / ДЕСТРУКТОР / CLEAR
@@ -388,6 +390,148 @@ TEST_CASE("List: removeBefore обрабатывает голову/середи
 }
 
 
+// ИНДЕКС ЗНАЧЕНИЙ
+
+
+TEST_CASE("List: операции с индексом значений совпадают с проходом", "[List]")
+{
+    // мало различных значений — много повторов и смен первого вхождения
+    List plain;
+    List indexed;
+    indexed.enableValueIndex();
+    REQUIRE(indexed.hasValueIndex());
+
+    std::uint32_t state = 17;
+    auto next = [&state](std::uint32_t bound) {
+        state = state * 1103515245U + 12345U;
+        return (state >> 8) % bound;
+    };
+    int mismatches = 0;
+    for (int step = 0; step < 6000; ++step) {
+        const std::string a = "v" + std::to_string(next(40));
+        const std::string b = "v" + std::to_string(next(40));
+        switch (next(9)) {
+        case 0:  plain.pushFront(a);        indexed.pushFront(a);        break;
+        case 1:  plain.pushBack(a);         indexed.pushBack(a);         break;
+        case 2:  plain.insertAfter(a, b);   indexed.insertAfter(a, b);   break;
+        case 3:  plain.insertBefore(a, b);  indexed.insertBefore(a, b);  break;
+        case 4:  plain.removeAfter(a);      indexed.removeAfter(a);      break;
+        case 5:  plain.removeBefore(a);     indexed.removeBefore(a);     break;
+        case 6:  plain.popBack();           indexed.popBack();           break;
+        case 7:  plain.popFront();          indexed.popFront();          break;
+        default:
+            if (next(8) == 0) {
+                plain.removeByValue(a);
+                indexed.removeByValue(a);
+            }
+            break;
+        }
+        mismatches += plain.findNode(b) == nullptr && indexed.findNode(b) == nullptr ? 0
+                    : plain.findNode(b) != nullptr && indexed.findNode(b) != nullptr ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(indexed.serialize() == plain.serialize());
+
+    // загрузка перестраивает индекс, выключение его освобождает
+    indexed.deserialize("x\ny\nx\n");
+    indexed.insertAfter("x", "after first x");
+    REQUIRE(indexed.serialize() == "x\nafter first x\ny\nx\n");
+    REQUIRE(indexed.findNode("y") != nullptr);
+    indexed.disableValueIndex();
+    REQUIRE_FALSE(indexed.hasValueIndex());
+    indexed.removeByValue("x");
+    REQUIRE(indexed.serialize() == "after first x\ny\n");
+}
+
+
+// ПЕРЕНОС УЗЛОВ
+
+
+TEST_CASE("List: splice/concat/splitAt переносят узлы без копирования строк", "[List]")
+{
+    const std::string longValue(40, 'L');
+    List a;
+    List b;
+    a.pushBack("a1");
+    a.pushBack("a2");
+    b.pushBack(longValue);
+    b.pushBack("b2");
+    const char* storage = b.findNode(longValue)->getValue().data();
+
+    a.splice(a.findNode("a2"), b);   // перед a2
+    REQUIRE(a.serialize() == "a1\n" + longValue + "\nb2\na2\n");
+    REQUIRE(a.size() == 4);
+    REQUIRE(b.empty());
+    REQUIRE(a.findNode(longValue)->getValue().data() == storage);
+
+    // пустой и собственный источник ничего не меняют
+    a.concat(b);
+    a.concat(a);
+    REQUIRE(a.size() == 4);
+
+    b.pushBack("b3");
+    a.splice(a.findNode("a1"), b);   // перед головой
+    b.pushBack("b4");
+    a.concat(b);                     // в конец
+    REQUIRE(a.serialize() == "b3\na1\n" + longValue + "\nb2\na2\nb4\n");
+    REQUIRE(a.findNode("b3")->getPrev() == nullptr);
+
+    // splitAt ищет узел с ближнего конца; хвост дописывается к rest
+    List rest;
+    rest.pushBack("r");
+    a.splitAt(4, rest);
+    REQUIRE(a.serialize() == "b3\na1\n" + longValue + "\nb2\n");
+    REQUIRE(rest.serialize() == "r\na2\nb4\n");
+    REQUIRE(a.size() == 4);
+    REQUIRE(rest.size() == 3);
+    a.splitAt(1, rest);
+    REQUIRE(a.serialize() == "b3\n");
+    REQUIRE(rest.findNode(longValue)->getValue().data() == storage);
+    a.splitAt(1, rest);   // index == size — ничего
+    a.splitAt(0, rest);
+    REQUIRE(a.empty());
+    REQUIRE(rest.serialize() == "r\na2\nb4\na1\n" + longValue + "\nb2\nb3\n");
+
+    // хвост и голова согласованы после переносов
+    a.pushBack("x");
+    a.pushFront("w");
+    rest.popBack();
+    rest.pushBack("end");
+    REQUIRE(a.serialize() == "w\nx\n");
+    REQUIRE(rest.size() == 7);
+}
+
+TEST_CASE("List: перенос узлов поддерживает индексы значений", "[List]")
+{
+    List indexed;
+    List plain;
+    indexed.enableValueIndex();
+    for (int i = 0; i < 6; ++i) {
+        indexed.pushBack("i" + std::to_string(i));
+        plain.pushBack("p" + std::to_string(i % 3));
+    }
+
+    indexed.concat(plain);   // индекс принимающего пополняется
+    REQUIRE(indexed.findNode("p2") != nullptr);
+    indexed.removeByValue("p1");
+    REQUIRE(indexed.size() == 10);
+
+    List other;
+    other.enableValueIndex();
+    indexed.splitAt(3, other);   // узлы уходят из индекса источника
+    REQUIRE(indexed.findNode("i4") == nullptr);
+    REQUIRE(indexed.findNode("i2") != nullptr);
+    REQUIRE(other.findNode("i4") != nullptr);
+    other.removeByValue("p0");
+    REQUIRE(other.serialize() == "i3\ni4\ni5\np2\np2\n");
+
+    indexed.splice(indexed.findNode("i0"), other);
+    REQUIRE(other.findNode("i3") == nullptr);
+    indexed.removeByValue("p2");
+    REQUIRE(indexed.serialize() == "i3\ni4\ni5\ni0\ni1\ni2\n");
+}
+
+
 // PRINT
 
 
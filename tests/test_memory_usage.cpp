@@ -0,0 +1,371 @@
+#include "catch_amalgamated.hpp"
+#include "memory_usage.h"
+
+#include "array.h"
+#include "compact_string_array.h"
+#include "forward_list.h"
+#include "list.h"
+#include "unrolled_list.h"
+#include "stack.h"
+#include "queue.h"
+#include "concurrent_queue.h"
+#include "work_stealing_deque.h"
+#include "priority_queue.h"
+#include "hashtable.h"
+#include "avltree.h"
+#include "bplus_tree.h"
+#include "persistent_avltree.h"
+#include "string_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+
+//  Считающий аллокатор
+//
+//  Глобальные operator new/delete этого тестового бинарника ведут учёт
+//  живых блоков по модели memory_usage::heapBlock(). Оценки memoryUsage()
+//  сравниваются с приростом этого счётчика.
+
+namespace
+{
+std::atomic<std::size_t> modelledHeapBytes{0};
+constexpr std::size_t kHeaderSize = 16;   // сохраняет выравнивание malloc
+
+std::size_t heapNow()
+{
+    return modelledHeapBytes.load(std::memory_order_relaxed);
+}
+
+std::string longValue(int index)
+{
+    // гарантированно длиннее SSO-буфера
+    return "long-value-that-does-not-fit-sso-" + std::to_string(index);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* raw = std::malloc(size + kHeaderSize);
+    if (raw == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(raw) = size;
+    modelledHeapBytes.fetch_add(memory_usage::heapBlock(size), std::memory_order_relaxed);
+    return static_cast<char*>(raw) + kHeaderSize;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    char* raw = static_cast<char*>(ptr) - kHeaderSize;
+    modelledHeapBytes.fetch_sub(memory_usage::heapBlock(*reinterpret_cast<std::size_t*>(raw)),
+                                std::memory_order_relaxed);
+    std::free(raw);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+
+// 1. МОДЕЛЬ БЛОКА КУЧИ
+
+
+TEST_CASE("memory_usage: модель блока и строк", "[Memory]")
+{
+    REQUIRE(memory_usage::heapBlock(0) == 32U);
+    REQUIRE(memory_usage::heapBlock(24) == 32U);
+    REQUIRE(memory_usage::heapBlock(25) == 48U);
+    REQUIRE(memory_usage::heapBlock(100) == 112U);
+
+    std::string shortText = "short";
+    std::string longText = longValue(1);
+    REQUIRE(memory_usage::stringHeap(shortText) == 0U);
+    REQUIRE(memory_usage::stringHeap(longText) == memory_usage::heapBlock(longText.capacity() + 1));
+}
+
+
+// 2. КОНТЕЙНЕРЫ ПРОТИВ СЧИТАЮЩЕГО АЛЛОКАТОРА
+
+
+TEST_CASE("memoryUsage: MyArray совпадает со счётчиком аллокатора", "[Memory][MyArray]")
+{
+    const std::size_t before = heapNow();
+    MyArray arr;
+    for (int i = 0; i < 100; ++i) {
+        arr.pushBack(i % 2 == 0 ? longValue(i) : std::string("s"));
+    }
+    arr.removeAt(0);   // освобождённый слот разрушается вместе со строкой
+
+    const std::size_t measured = heapNow() - before;
+    const std::size_t estimated = arr.memoryUsage() - sizeof(MyArray);
+    REQUIRE(measured == estimated);
+}
+
+TEST_CASE("memoryUsage: CompactStringArray — один блок вместо блока на строку", "[Memory][CompactStringArray]")
+{
+    MyArray arr;
+    for (int i = 0; i < 100; ++i) {
+        arr.pushBack(longValue(i));
+    }
+
+    const std::size_t before = heapNow();
+    const CompactStringArray compact(arr);
+    const std::size_t measured = heapNow() - before;
+    REQUIRE(measured == compact.memoryUsage() - sizeof(CompactStringArray));
+    REQUIRE(compact.memoryUsage() < arr.memoryUsage() / 2);
+}
+
+TEST_CASE("memoryUsage: списки, стек и очередь совпадают со счётчиком", "[Memory]")
+{
+    SECTION("ForwardList")
+    {
+        const std::size_t before = heapNow();
+        ForwardList list;
+        for (int i = 0; i < 50; ++i) {
+            list.pushFront(i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == list.memoryUsage() - sizeof(ForwardList));
+    }
+
+    SECTION("List")
+    {
+        const std::size_t before = heapNow();
+        List list;
+        for (int i = 0; i < 50; ++i) {
+            list.pushBack(i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == list.memoryUsage() - sizeof(List));
+    }
+
+    SECTION("списки с индексом значений")
+    {
+        const std::size_t before = heapNow();
+        List list;
+        ForwardList forward;
+        list.enableValueIndex();
+        forward.enableValueIndex();
+        for (int i = 0; i < 60; ++i) {
+            const std::string value = i % 4 == 0 ? longValue(i % 8) : std::to_string(i);
+            list.pushBack(value);
+            forward.pushBack(value);
+        }
+        list.removeByValue(longValue(0));
+        forward.removeAfter("1");
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == list.memoryUsage() - sizeof(List)
+                            + forward.memoryUsage() - sizeof(ForwardList));
+    }
+
+    SECTION("UnrolledList")
+    {
+        const std::size_t before = heapNow();
+        UnrolledList list;
+        for (int i = 0; i < 200; ++i) {
+            list.pushBack(i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        for (int i = 0; i < 200; i += 2) {
+            list.removeByValue(std::to_string(i));
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == list.memoryUsage() - sizeof(UnrolledList));
+    }
+
+    SECTION("Stack")
+    {
+        const std::size_t before = heapNow();
+        Stack stack;
+        for (int i = 0; i < 50; ++i) {
+            stack.push(i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == stack.memoryUsage() - sizeof(Stack));
+    }
+
+    SECTION("Queue")
+    {
+        const std::size_t before = heapNow();
+        Queue queue;
+        for (int i = 0; i < 50; ++i) {
+            queue.push(i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        for (int i = 0; i < 40; ++i) {
+            (void)queue.pop();   // опустевший блок остаётся запасным
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == queue.memoryUsage() - sizeof(Queue));
+    }
+
+    SECTION("SpscQueue и MpmcQueue")
+    {
+        const std::size_t before = heapNow();
+        SpscQueue spsc(64);
+        MpmcQueue mpmc(64);
+        for (int i = 0; i < 50; ++i) {
+            const std::string value = i % 3 == 0 ? longValue(i) : std::to_string(i);
+            spsc.push(value);
+            mpmc.push(value);
+        }
+        for (int i = 0; i < 20; ++i) {
+            (void)spsc.pop();   // слот остаётся пустой строкой без буфера
+            (void)mpmc.pop();
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == spsc.memoryUsage() - sizeof(SpscQueue) + mpmc.memoryUsage() - sizeof(MpmcQueue));
+    }
+
+    SECTION("WorkStealingDeque")
+    {
+        const std::size_t before = heapNow();
+        WorkStealingDeque deque(4);
+        for (int i = 0; i < 50; ++i) {
+            deque.push(i % 3 == 0 ? longValue(i) : std::to_string(i));   // кольцо растёт, старые остаются
+        }
+        std::string out;
+        for (int i = 0; i < 10; ++i) {
+            (void)deque.steal(out);
+            (void)deque.pop(out);
+        }
+        const std::size_t measured = heapNow() - before - memory_usage::stringHeap(out);
+        REQUIRE(measured == deque.memoryUsage() - sizeof(WorkStealingDeque));
+    }
+
+    SECTION("PriorityQueue")
+    {
+        const std::size_t before = heapNow();
+        PriorityQueue queue;
+        for (int i = 0; i < 50; ++i) {
+            queue.push((i * 7) % 13, i % 3 == 0 ? longValue(i) : std::to_string(i));
+        }
+        for (int i = 0; i < 20; ++i) {
+            (void)queue.pop();   // вместимость массива кучи не уменьшается
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == queue.memoryUsage() - sizeof(PriorityQueue));
+    }
+}
+
+TEST_CASE("memoryUsage: хеш-таблицы совпадают со счётчиком", "[Memory][HashTable]")
+{
+    SECTION("HashTable")
+    {
+        const std::size_t before = heapNow();
+        HashTable table;
+        for (int i = 0; i < 200; ++i) {
+            table.insert("key" + std::to_string(i), longValue(i));
+        }
+        table.erase("key7");
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == table.memoryUsage() - sizeof(HashTable));
+    }
+
+    SECTION("HashTableOpen")
+    {
+        const std::size_t before = heapNow();
+        HashTableOpen table;
+        for (int i = 0; i < 200; ++i) {
+            table.insert(longValue(i), std::to_string(i));
+        }
+        table.erase(longValue(3));
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == table.memoryUsage() - sizeof(HashTableOpen));
+    }
+
+    SECTION("HashTable с фильтром Блума")
+    {
+        const std::size_t before = heapNow();
+        HashTable table;
+        table.enableBloomFilter();
+        for (int i = 0; i < 200; ++i) {
+            table.insert("key" + std::to_string(i), longValue(i));
+        }
+        const std::size_t measured = heapNow() - before;
+        REQUIRE(measured == table.memoryUsage() - sizeof(HashTable));
+    }
+}
+
+TEST_CASE("memoryUsage: BPlusTree совпадает со счётчиком", "[Memory][BPlusTree]")
+{
+    // разделения и слияния узлов, строки и в куче, и в SSO
+    const std::size_t before = heapNow();
+    BPlusTree tree;
+    for (int i = 0; i < 500; ++i) {
+        tree.insert(i % 2 == 0 ? longValue(i) : std::to_string(i));
+    }
+    for (int i = 0; i < 400; i += 3) {
+        tree.remove(i % 2 == 0 ? longValue(i) : std::to_string(i));
+    }
+    const std::size_t measured = heapNow() - before;
+    REQUIRE(measured == tree.memoryUsage() - sizeof(BPlusTree));
+}
+
+TEST_CASE("memoryUsage: PersistentAvlTree совпадает со счётчиком", "[Memory][PersistentAvlTree]")
+{
+    // значения уже в пуле: считаются только узлы; снапшот не выделяет память
+    PersistentAvlTree warm;
+    for (int i = 0; i < 300; ++i) {
+        warm.insert(longValue(i));
+    }
+
+    const std::size_t before = heapNow();
+    PersistentAvlTree tree;
+    for (int i = 0; i < 300; ++i) {
+        tree.insert(longValue(i));
+    }
+    for (int i = 0; i < 300; i += 4) {
+        tree.remove(longValue(i));
+    }
+    REQUIRE(heapNow() - before == tree.memoryUsage() - sizeof(PersistentAvlTree));
+
+    const std::size_t beforeSnapshot = heapNow();
+    const PersistentAvlTree snapshot = tree;
+    REQUIRE(heapNow() == beforeSnapshot);
+    REQUIRE(snapshot.memoryUsage() == tree.memoryUsage());
+}
+
+TEST_CASE("memoryUsage: AvlTree и StringPool совпадают со счётчиком", "[Memory][AvlTree]")
+{
+    SECTION("узлы дерева без новых строк в пуле")
+    {
+        StringPool& pool = StringPool::global();
+        AvlTree source;
+        for (int i = 0; i < 100; ++i) {
+            source.insert(longValue(i));
+        }
+
+        const std::size_t poolBefore = pool.memoryUsage();
+        const std::size_t before = heapNow();
+        AvlTree copy(source);   // значения разделяются через пул
+        const std::size_t measured = heapNow() - before;
+
+        REQUIRE(pool.memoryUsage() == poolBefore);
+        REQUIRE(measured == copy.memoryUsage() - sizeof(AvlTree));
+    }
+
+    SECTION("собственный пул строк")
+    {
+        const std::size_t before = heapNow();
+        auto* pool = new StringPool();
+        InternedString handles[64];
+        for (int i = 0; i < 64; ++i) {
+            handles[i] = pool->intern(longValue(i % 40));
+        }
+        const std::size_t measured = heapNow() - before;
+        const std::size_t estimated = pool->memoryUsage() - sizeof(StringPool)
+                                    + memory_usage::heapBlock(sizeof(StringPool));
+        REQUIRE(measured == estimated);
+
+        for (auto& handle : handles) {
+            handle = InternedString{};
+        }
+        delete pool;
+    }
+}
@@ -0,0 +1,215 @@
+#include "catch_amalgamated.hpp"
+#include "persistent_avltree.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+std::vector<std::string> contentsOf(const PersistentAvlTree& tree)
+{
+    std::vector<std::string> values;
+    for (std::string_view value : tree) {
+        values.emplace_back(value);
+    }
+    return values;
+}
+} // namespace
+
+
+// 1. ВСТАВКА, ПОИСК, УДАЛЕНИЕ
+
+
+TEST_CASE("PersistentAvlTree: вставка, дубликаты, удаление и печать", "[PersistentAvlTree]")
+{
+    PersistentAvlTree tree;
+    REQUIRE(tree.empty());
+    REQUIRE(tree.begin() == tree.end());
+
+    tree.insert("b");
+    tree.insert("a");
+    tree.insert("c");
+    tree.insert("a");
+    REQUIRE(tree.size() == 3U);
+    REQUIRE(tree.contains("a"));
+    REQUIRE_FALSE(tree.contains("x"));
+    REQUIRE(contentsOf(tree) == std::vector<std::string>{"a", "b", "c"});
+
+    tree.remove("x");
+    tree.remove("b");
+    REQUIRE(contentsOf(tree) == std::vector<std::string>{"a", "c"});
+
+    std::ostringstream oss;
+    std::streambuf* oldBuf = std::cout.rdbuf(oss.rdbuf());
+    tree.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(oss.str() == "c\n  a\n");
+}
+
+TEST_CASE("PersistentAvlTree: вставки и удаления вперемешку совпадают с std::set", "[PersistentAvlTree]")
+{
+    PersistentAvlTree tree;
+    std::set<std::string> model;
+    std::uint32_t state = 77;
+    for (int step = 0; step < 20000; ++step) {
+        state = state * 1103515245U + 12345U;
+        const std::string value = std::to_string((state >> 8) % 5000);
+        if ((state >> 4) % 3 == 0) {
+            tree.remove(value);
+            model.erase(value);
+        } else {
+            tree.insert(value);
+            model.insert(value);
+        }
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(contentsOf(tree) == std::vector<std::string>(model.begin(), model.end()));
+
+    int mismatches = 0;
+    std::size_t index = 0;
+    for (const std::string& value : model) {
+        mismatches += tree.nth(index) == value ? 0 : 1;
+        mismatches += tree.rank(value) == index ? 0 : 1;
+        ++index;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(*tree.lowerBound("2500") == *model.lower_bound("2500"));
+    REQUIRE(*tree.upperBound("2500") == *model.upper_bound("2500"));
+    REQUIRE_THROWS_AS(tree.nth(model.size()), std::out_of_range);
+}
+
+
+// 2. ВЕРСИИ
+
+
+TEST_CASE("PersistentAvlTree: старые версии не меняются после изменений", "[PersistentAvlTree]")
+{
+    PersistentAvlTree tree;
+    std::vector<PersistentAvlTree> versions;
+    std::vector<std::size_t> sizes;
+    for (int i = 0; i < 200; ++i) {
+        versions.push_back(tree);
+        sizes.push_back(tree.size());
+        tree.insert(std::to_string(i));
+        if (i % 3 == 0) {
+            tree.remove(std::to_string(i / 2));
+        }
+    }
+
+    int mismatches = 0;
+    for (std::size_t v = 0; v < versions.size(); ++v) {
+        mismatches += versions[v].size() == sizes[v] ? 0 : 1;
+        mismatches += static_cast<std::size_t>(std::distance(versions[v].begin(), versions[v].end()))
+                   == sizes[v] ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(versions[10].contains("9"));
+    REQUIRE_FALSE(versions[9].contains("9"));
+
+    const PersistentAvlTree withX = tree.inserted("x");
+    const PersistentAvlTree withoutLast = tree.removed("199");
+    REQUIRE(withX.contains("x"));
+    REQUIRE_FALSE(tree.contains("x"));
+    REQUIRE(tree.contains("199"));
+    REQUIRE_FALSE(withoutLast.contains("199"));
+    REQUIRE(withoutLast.size() == tree.size() - 1);
+
+    // освобождение версий в любом порядке не трогает остальные
+    versions.erase(versions.begin() + 50, versions.begin() + 150);
+    REQUIRE(contentsOf(versions.back()).size() == sizes.back());
+}
+
+TEST_CASE("PersistentAvlTree: читатели обходят снапшоты, пока писатель меняет дерево", "[PersistentAvlTree]")
+{
+    PersistentAvlTree tree;
+    for (int i = 0; i < 2000; ++i) {
+        tree.insert(std::to_string(i));
+    }
+
+    // читатель получает снапшоты через очередь из одного слота под мьютексом
+    // только на время копирования указателя; обход идёт без блокировок
+    std::mutex slotMutex;
+    PersistentAvlTree slot = tree;
+    std::atomic<bool> done{false};
+    std::atomic<int> badSnapshots{0};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            PersistentAvlTree snapshot;
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                snapshot = slot;
+            }
+            std::size_t seen = 0;
+            std::string previous;
+            for (std::string_view value : snapshot) {
+                if (seen > 0 && !(previous < value)) {
+                    ++badSnapshots;
+                }
+                previous.assign(value);
+                ++seen;
+            }
+            if (seen != snapshot.size()) {
+                ++badSnapshots;
+            }
+        }
+    });
+
+    for (int i = 0; i < 3000; ++i) {
+        tree.insert("w" + std::to_string(i));
+        tree.remove(std::to_string(i % 2000));
+        if (i % 10 == 0) {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slot = tree;
+        }
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(badSnapshots == 0);
+    REQUIRE(tree.size() == 3000U);
+}
+
+
+// 3. СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("PersistentAvlTree: текстовый и бинарный снапшоты восстанавливают дерево", "[PersistentAvlTree]")
+{
+    PersistentAvlTree tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(std::to_string(i * 7));
+    }
+
+    PersistentAvlTree fromText;
+    fromText.insert("old");
+    const PersistentAvlTree oldVersion = fromText;
+    fromText.deserialize(tree.serialize());
+    REQUIRE(contentsOf(fromText) == contentsOf(tree));
+    REQUIRE(oldVersion.contains("old"));
+
+    std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+    tree.serializeBinary(binary);
+    PersistentAvlTree fromBinary;
+    fromBinary.deserializeBinary(binary);
+    REQUIRE(contentsOf(fromBinary) == contentsOf(tree));
+    REQUIRE(fromBinary.nth(500) == tree.nth(500));
+
+    // неупорядоченный текст вставляется по одному, обрезанный выбрасывает
+    fromText.deserialize("3\nc\na\nc\n");
+    REQUIRE(contentsOf(fromText) == std::vector<std::string>{"a", "c"});
+    REQUIRE_THROWS_AS(fromText.deserialize("3\nx\n"), std::runtime_error);
+    REQUIRE(fromText.size() == 2U);
+    fromText.deserialize("");
+    REQUIRE(fromText.empty());
+}
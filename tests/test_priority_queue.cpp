@@ -0,0 +1,177 @@
+// test_priority_queue.cpp
+#include "catch_amalgamated.hpp"
+#include "priority_queue.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// 1. БАЗОВЫЕ ОПЕРАЦИИ
+
+
+TEST_CASE("PriorityQueue: меньший приоритет выходит первым", "[PriorityQueue]")
+{
+    PriorityQueue pq;
+    REQUIRE(pq.empty());
+    REQUIRE_THROWS_AS(pq.pop(), std::out_of_range);
+    REQUIRE_THROWS_AS(pq.top(), std::out_of_range);
+    REQUIRE_THROWS_AS(pq.topPriority(), std::out_of_range);
+
+    pq.push(5, "five");
+    pq.push(-3, "minus-three");
+    pq.push(10, "ten");
+    pq.push(0, "zero");
+    REQUIRE(pq.size() == 4);
+    REQUIRE(pq.top() == "minus-three");
+    REQUIRE(pq.topPriority() == -3);
+
+    REQUIRE(pq.pop() == "minus-three");
+    REQUIRE(pq.pop() == "zero");
+    REQUIRE(pq.pop() == "five");
+    REQUIRE(pq.pop() == "ten");
+    REQUIRE(pq.empty());
+}
+
+
+// 2. РАВНЫЕ ПРИОРИТЕТЫ — FIFO
+
+
+TEST_CASE("PriorityQueue: при равных приоритетах порядок добавления", "[PriorityQueue]")
+{
+    PriorityQueue pq;
+    for (int i = 0; i < 40; ++i) {
+        pq.push(i % 2, "v" + std::to_string(i));
+    }
+    for (int i = 0; i < 40; i += 2) {
+        REQUIRE(pq.pop() == "v" + std::to_string(i));
+    }
+    for (int i = 1; i < 40; i += 2) {
+        REQUIRE(pq.pop() == "v" + std::to_string(i));
+    }
+}
+
+
+// 3. СЛУЧАЙНЫЕ ОПЕРАЦИИ ПРОТИВ ОТСОРТИРОВАННОЙ МОДЕЛИ
+
+
+TEST_CASE("PriorityQueue: случайные push/pop совпадают с моделью", "[PriorityQueue]")
+{
+    std::mt19937 rng(49);
+    std::uniform_int_distribution<int> priorityDist(-50, 50);
+    std::uniform_int_distribution<int> opDist(0, 2);
+
+    PriorityQueue pq;
+    // модель: (приоритет, номер) -> значение; минимум — первый элемент
+    std::vector<std::pair<std::pair<std::int64_t, int>, std::string>> model;
+    int order = 0;
+
+    for (int step = 0; step < 5000; ++step) {
+        if (opDist(rng) != 0 || model.empty()) {
+            const std::int64_t priority = priorityDist(rng);
+            const std::string value = std::string(step % 5 == 0 ? 40 : 1, 'x') + std::to_string(step);
+            pq.push(priority, value);
+            model.push_back({{priority, order++}, value});
+        } else {
+            const auto best = std::min_element(model.begin(), model.end());
+            REQUIRE(pq.topPriority() == best->first.first);
+            REQUIRE(pq.pop() == best->second);
+            model.erase(best);
+        }
+        REQUIRE(pq.size() == model.size());
+    }
+
+    std::sort(model.begin(), model.end());
+    for (const auto& entry : model) {
+        REQUIRE(pq.pop() == entry.second);
+    }
+    REQUIRE(pq.empty());
+}
+
+
+// 4. ТЕКСТОВАЯ СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("PriorityQueue: текстовая сериализация в порядке выдачи", "[PriorityQueue]")
+{
+    PriorityQueue pq;
+    pq.push(2, "b");
+    pq.push(1, "a with spaces");
+    pq.push(2, "c");
+    pq.push(-7, "");
+
+    const std::string text = pq.serialize();
+    REQUIRE(text == "-7 \n1 a with spaces\n2 b\n2 c\n");
+
+    PriorityQueue loaded;
+    loaded.push(100, "old");
+    loaded.deserialize(text);
+    REQUIRE(loaded.size() == 4);
+    REQUIRE(loaded.pop() == "");
+    REQUIRE(loaded.pop() == "a with spaces");
+    REQUIRE(loaded.pop() == "b");
+    REQUIRE(loaded.pop() == "c");
+
+    // файл в произвольном порядке — куча восстанавливается при загрузке
+    loaded.deserialize("9 z\n3 x\n3 y\n-1 w\n");
+    REQUIRE(loaded.pop() == "w");
+    REQUIRE(loaded.pop() == "x");
+    REQUIRE(loaded.pop() == "y");
+    REQUIRE(loaded.pop() == "z");
+
+    // после загрузки новые элементы встают за загруженными с тем же приоритетом
+    loaded.deserialize("5 first\n");
+    loaded.push(5, "second");
+    REQUIRE(loaded.pop() == "first");
+
+    PriorityQueue broken;
+    broken.push(1, "keep");
+    REQUIRE_THROWS_AS(broken.deserialize("1 ok\nnot-a-number x\n"), std::runtime_error);
+    REQUIRE(broken.size() == 1);
+    REQUIRE(broken.top() == "keep");
+}
+
+
+// 5. БИНАРНАЯ СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("PriorityQueue: бинарная сериализация и обрыв потока", "[PriorityQueue]")
+{
+    PriorityQueue pq;
+    for (int i = 0; i < 100; ++i) {
+        pq.push((i * 37) % 11 - 5, std::string(i % 7 == 0 ? 30 : 2, 'q') + std::to_string(i));
+    }
+
+    std::stringstream buffer;
+    pq.serializeBinary(buffer);
+    const std::string bytes = buffer.str();
+
+    PriorityQueue loaded;
+    loaded.deserializeBinary(buffer);
+    REQUIRE(loaded.size() == pq.size());
+    while (!pq.empty()) {
+        REQUIRE(loaded.topPriority() == pq.topPriority());
+        REQUIRE(loaded.pop() == pq.pop());
+    }
+
+    // обрезанный поток: исключение, очередь не меняется
+    PriorityQueue target;
+    target.push(0, "keep");
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    REQUIRE_THROWS_AS(target.deserializeBinary(truncated), std::runtime_error);
+    REQUIRE(target.size() == 1);
+    REQUIRE(target.top() == "keep");
+
+    // испорченный счётчик не ведёт к огромному резерву
+    std::string corrupt = bytes;
+    const std::uint64_t huge = std::uint64_t{1} << 60;
+    corrupt.replace(0, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+    std::stringstream corruptStream(corrupt);
+    REQUIRE_THROWS_AS(target.deserializeBinary(corruptStream), std::runtime_error);
+    REQUIRE(target.size() == 1);
+}
@@ -5,6 +5,11 @@
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <vector>
 
 
 // БАЗОВОЕ СОСТОЯНИЕ / CLEAR / ДЕСТРУКТОР
@@ -27,6 +32,21 @@ TEST_CASE("Queue: конструктор по умолчанию, empty, clear",
     REQUIRE(q.empty());
 }
 
+TEST_CASE("Queue: опустевшая через pop очередь держит запасной блок до очистки", "[Queue]")
+{
+    Queue q;
+    REQUIRE(q.memoryUsage() == sizeof(Queue));
+
+    q.push("a");
+    q.pop();
+    REQUIRE(q.empty());
+    REQUIRE(q.memoryUsage() > sizeof(Queue));
+
+    // очистка при загрузке освобождает и запасной блок
+    q.deserialize("");
+    REQUIRE(q.memoryUsage() == sizeof(Queue));
+}
+
 
 // PUSH / POP / FRONT / BACK / SIZE / EMPTY
 
@@ -91,6 +111,106 @@ TEST_CASE("Queue: push, pop, front, back — базовое поведение",
 }
 
 
+TEST_CASE("Queue: push и pop вперемешку через границы блоков совпадают с std::deque", "[Queue]")
+{
+    Queue queue;
+    std::deque<std::string> model;
+    std::uint32_t state = 5;
+    int mismatches = 0;
+    for (int step = 0; step < 20000; ++step) {
+        state = state * 1103515245U + 12345U;
+        // перекос в сторону push: очередь то растёт на несколько блоков, то пустеет
+        if ((state >> 8) % 5 < (step % 4000 < 2000 ? 3U : 2U) || model.empty()) {
+            const std::string value = std::to_string(step) + std::string(step % 3 == 0 ? 30 : 0, '#');
+            queue.push(value);
+            model.push_back(value);
+        } else {
+            mismatches += queue.pop() == model.front() ? 0 : 1;
+            model.pop_front();
+        }
+        if (!model.empty()) {
+            mismatches += queue.front() == model.front() && queue.back() == model.back() ? 0 : 1;
+        }
+        mismatches += queue.size() == model.size() ? 0 : 1;
+    }
+    REQUIRE(mismatches == 0);
+
+    Queue copy(queue);
+    while (!model.empty()) {
+        REQUIRE(copy.pop() == model.front());
+        model.pop_front();
+    }
+    REQUIRE(copy.empty());
+    REQUIRE_THROWS_AS(copy.pop(), std::out_of_range);
+}
+
+TEST_CASE("Queue: pushBatch и popBatch через границы блоков", "[Queue]")
+{
+    Queue q;
+    std::vector<std::string> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(std::to_string(i) + std::string(i % 4 == 0 ? 40 : 0, '#'));
+    }
+    REQUIRE(q.pushBatch(values.begin(), values.end()) == 100);
+    REQUIRE(q.size() == 100);
+
+    std::vector<std::string> out{"kept"};
+    REQUIRE(q.popBatch(45, out) == 45);
+    REQUIRE(out.size() == 46);
+    REQUIRE(out[0] == "kept");
+    REQUIRE(out[45] == values[44]);
+    REQUIRE(q.front() == values[45]);
+
+    // строки из временного вектора переезжают без копирования
+    std::vector<std::string> more{"x", "y"};
+    REQUIRE(q.pushBatch(std::make_move_iterator(more.begin()), std::make_move_iterator(more.end())) == 2);
+    REQUIRE(q.back() == "y");
+
+    out.clear();
+    REQUIRE(q.popBatch(1000, out) == 57);
+    REQUIRE(out.front() == values[45]);
+    REQUIRE(out.back() == "y");
+    REQUIRE(q.empty());
+    REQUIRE(q.popBatch(5, out) == 0);
+
+    // при пределе pushBatch останавливается на заполнении
+    q.setCapacityLimit(10);
+    REQUIRE(q.pushBatch(values.begin(), values.end()) == 10);
+    REQUIRE(q.back() == values[9]);
+}
+
+TEST_CASE("Queue: предел размера — tryPush возвращает false, push бросает", "[Queue]")
+{
+    Queue q;
+    q.setCapacityLimit(3);
+    REQUIRE(q.tryPush("a"));
+    std::string moved = "b";
+    q.push(std::move(moved));
+    q.push("c");
+    REQUIRE(q.full());
+    REQUIRE_FALSE(q.tryPush("d"));
+    REQUIRE_THROWS_AS(q.push("d"), std::overflow_error);
+    REQUIRE(q.size() == 3);
+
+    // место освобождается pop-ом; предел переезжает с копией и при swap
+    REQUIRE(q.pop() == "a");
+    REQUIRE(q.tryPush("d"));
+    Queue copy(q);
+    REQUIRE(copy.capacityLimit() == 3);
+    REQUIRE_FALSE(copy.tryPush("e"));
+
+    Queue other;
+    other.swap(copy);
+    REQUIRE(copy.capacityLimit() == 0);
+    REQUIRE(other.capacityLimit() == 3);
+
+    // загрузка предел не проверяет
+    q.deserialize("1\n2\n3\n4\n");
+    REQUIRE(q.size() == 4);
+    REQUIRE(q.full());
+}
+
+
 // PRINT
 
 
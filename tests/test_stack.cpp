@@ -2,7 +2,10 @@
 #include "catch_amalgamated.hpp"
 #include "stack.h"
 
+#include <cstdint>
+#include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 
@@ -129,3 +132,112 @@ TEST_CASE("Stack: binary serialize/deserialize пустого стека", "[Sta
 
     REQUIRE(restored.empty());
 }
+
+
+// 7. Непрерывное хранение: рост, перемещение, печать
+
+
+TEST_CASE("Stack: рост хранилища сохраняет порядок, pop отдаёт строку перемещением", "[Stack]")
+{
+    Stack s;
+    REQUIRE_THROWS_AS(s.pop(), std::out_of_range);
+
+    const std::string longValue(100, 'L');
+    for (int i = 0; i < 1000; ++i) {
+        s.push(i % 7 == 0 ? longValue + std::to_string(i) : std::to_string(i));
+    }
+    REQUIRE(s.size() == 1000);
+
+    std::string moved = "moved";
+    s.push(std::move(moved));
+    REQUIRE(s.pop() == "moved");
+
+    for (int i = 999; i >= 0; --i) {
+        const std::string expected = i % 7 == 0 ? longValue + std::to_string(i) : std::to_string(i);
+        REQUIRE(s.pop() == expected);
+    }
+    REQUIRE(s.empty());
+
+    s.reserve(10);
+    s.push("a");
+    s.push("b");
+    s.push("c");
+    std::ostringstream oss;
+    std::streambuf* oldBuf = std::cout.rdbuf(oss.rdbuf());
+    s.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(oss.str() == "[c, b, a]\n");
+}
+
+
+// 8. Предел размера
+
+
+TEST_CASE("Stack: предел размера — tryPush возвращает false, push бросает", "[Stack]")
+{
+    Stack s;
+    REQUIRE(s.capacityLimit() == 0);
+    s.setCapacityLimit(2);
+    REQUIRE(s.tryPush("a"));
+    s.push("b");
+    REQUIRE(s.full());
+    REQUIRE_FALSE(s.tryPush("c"));
+    REQUIRE_THROWS_AS(s.push("c"), std::overflow_error);
+    REQUIRE(s.size() == 2);
+
+    REQUIRE(s.pop() == "b");
+    REQUIRE(s.tryPush("c"));
+
+    // загрузка предел не проверяет, push после неё — проверяет
+    s.deserialize("x\ny\nz\n");
+    REQUIRE(s.size() == 3);
+    REQUIRE_FALSE(s.tryPush("w"));
+    s.setCapacityLimit(0);
+    REQUIRE(s.tryPush("w"));
+    REQUIRE(s.serialize() == "w\nx\ny\nz\n");
+}
+
+
+// 9. Загрузка без промежуточного вектора
+
+
+TEST_CASE("Stack: загрузка разворачивает порядок на месте, обрезанный поток не меняет стек", "[Stack]")
+{
+    Stack source;
+    for (int i = 0; i < 1000; ++i) {
+        source.push(i % 5 == 0 ? std::string(40, 'L') + std::to_string(i) : std::to_string(i));
+    }
+
+    Stack fromText;
+    fromText.deserialize(source.serialize());
+    REQUIRE(fromText.size() == 1000);
+    REQUIRE(fromText.serialize() == source.serialize());
+
+    std::ostringstream oss(std::ios::binary);
+    source.serializeBinary(oss);
+    const std::string bytes = oss.str();
+
+    Stack fromBinary;
+    fromBinary.push("old");
+    std::istringstream iss(bytes, std::ios::binary);
+    fromBinary.deserializeBinary(iss);
+    REQUIRE(fromBinary.size() == 1000);
+    REQUIRE(fromBinary.pop() == "999");
+    REQUIRE(fromBinary.serialize() == fromText.serialize().substr(4));
+
+    Stack kept;
+    kept.push("bottom");
+    kept.push("top");
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 3), std::ios::binary);
+    REQUIRE_THROWS_AS(kept.deserializeBinary(truncated), std::runtime_error);
+    REQUIRE(kept.size() == 2);
+
+    // испорченный счётчик не ведёт к огромному резерву
+    std::string corrupt = bytes;
+    const std::uint64_t huge = std::uint64_t{1} << 60;
+    corrupt.replace(0, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+    std::istringstream corruptStream(corrupt, std::ios::binary);
+    REQUIRE_THROWS_AS(kept.deserializeBinary(corruptStream), std::runtime_error);
+    REQUIRE(kept.size() == 2);
+    REQUIRE(kept.pop() == "top");
+}
@@ -0,0 +1,142 @@
+#include "catch_amalgamated.hpp"
+#include "string_pool.h"
+#include "avltree.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// 1. ИНТЕРНИРОВАНИЕ И РАВЕНСТВО
+
+
+TEST_CASE("StringPool: одинаковые строки дают один дескриптор", "[StringPool]")
+{
+    StringPool pool;
+    InternedString a = pool.intern("alpha");
+    InternedString b = pool.intern(std::string("alpha"));
+    InternedString c = pool.intern("beta");
+
+    REQUIRE(a == b);
+    REQUIRE(a.data() == b.data());   // один и тот же блок памяти
+    REQUIRE(a != c);
+    REQUIRE(a < c);
+    REQUIRE_FALSE(c < a);
+
+    REQUIRE(pool.size() == 2U);
+    REQUIRE(pool.textBytes() == 9U);
+    REQUIRE(pool.contains("alpha"));
+    REQUIRE_FALSE(pool.contains("gamma"));
+
+    REQUIRE(a.view() == "alpha");
+    REQUIRE(a.str() == "alpha");
+    REQUIRE(a.size() == 5U);
+    REQUIRE_FALSE(a.empty());
+}
+
+TEST_CASE("StringPool: пустая строка не занимает место в пуле", "[StringPool]")
+{
+    StringPool pool;
+    InternedString empty = pool.intern("");
+    InternedString defaulted;
+
+    REQUIRE(empty == defaulted);
+    REQUIRE(empty.empty());
+    REQUIRE(empty.view().empty());
+    REQUIRE(std::string(empty.data()).empty());
+    REQUIRE(pool.size() == 0U);
+    REQUIRE(pool.contains(""));
+}
+
+
+// 2. ВРЕМЯ ЖИЗНИ ЗАПИСЕЙ
+
+
+TEST_CASE("StringPool: запись удаляется вместе с последним дескриптором", "[StringPool]")
+{
+    StringPool pool;
+    {
+        InternedString first = pool.intern("key");
+        InternedString copy(first);
+        InternedString assigned;
+        assigned = copy;
+        REQUIRE(pool.size() == 1U);
+
+        InternedString moved(std::move(first));
+        REQUIRE(first.empty());
+        REQUIRE(moved == copy);
+        REQUIRE(pool.size() == 1U);
+    }
+    REQUIRE(pool.size() == 0U);
+    REQUIRE(pool.textBytes() == 0U);
+    REQUIRE_FALSE(pool.contains("key"));
+
+    // повторное интернирование создаёт запись заново
+    InternedString again = pool.intern("key");
+    REQUIRE(pool.size() == 1U);
+    REQUIRE(again.view() == "key");
+}
+
+TEST_CASE("StringPool: swap и вывод в поток", "[StringPool]")
+{
+    StringPool pool;
+    InternedString a = pool.intern("left");
+    InternedString b = pool.intern("right");
+    a.swap(b);
+    REQUIRE(a.view() == "right");
+    REQUIRE(b.view() == "left");
+
+    std::ostringstream oss;
+    oss << a << ' ' << b;
+    REQUIRE(oss.str() == "right left");
+}
+
+TEST_CASE("StringPool: конкурентное интернирование и освобождение", "[StringPool]")
+{
+    StringPool pool;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&pool]() {
+            for (int i = 0; i < 2000; ++i) {
+                InternedString first = pool.intern("v" + std::to_string(i % 50));
+                InternedString second = first;
+                (void)second;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    REQUIRE(pool.size() == 0U);
+}
+
+
+// 3. ОБЩИЕ ЗНАЧЕНИЯ В AVL-ДЕРЕВЬЯХ
+
+
+TEST_CASE("StringPool: деревья разделяют интернированные значения", "[StringPool][AvlTree]")
+{
+    StringPool& pool = StringPool::global();
+    const std::string value = "string-pool-shared-value";
+    REQUIRE_FALSE(pool.contains(value));
+
+    {
+        AvlTree first;
+        AvlTree second;
+        first.insert(value);
+        second.insert(value);
+        const std::size_t afterInsert = pool.size();
+
+        AvlTree copy(first);   // копия не создаёт новых строк
+        REQUIRE(pool.size() == afterInsert);
+        REQUIRE(copy.contains(value));
+        REQUIRE(pool.contains(value));
+
+        first.remove(value);
+        second.remove(value);
+        REQUIRE(pool.contains(value));   // ещё держит copy
+    }
+    REQUIRE_FALSE(pool.contains(value));
+}
@@ -0,0 +1,187 @@
+#include "catch_amalgamated.hpp"
+#include "unrolled_list.h"
+#include "list.h"
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+std::vector<std::string> contentsOf(const UnrolledList& list)
+{
+    return std::vector<std::string>(list.begin(), list.end());
+}
+} // namespace
+
+
+// 1. ОПЕРАЦИИ КАК У List
+
+
+TEST_CASE("UnrolledList: базовые операции, print и обход", "[UnrolledList]")
+{
+    UnrolledList list;
+    REQUIRE(list.empty());
+    REQUIRE(list.begin() == list.end());
+    list.popFront();
+    list.popBack();
+
+    list.pushBack("b");
+    list.pushFront("a");
+    list.pushBack("c");
+    list.insertAfter("b", "x");
+    list.insertBefore("a", "start");
+    list.removeBefore("start");   // у головы нет предшественника
+    list.removeAfter("c");        // после хвоста ничего нет
+    REQUIRE(list.size() == 5);
+    REQUIRE(contentsOf(list) == std::vector<std::string>{"start", "a", "b", "x", "c"});
+    REQUIRE(list.contains("x"));
+    REQUIRE_FALSE(list.contains("missing"));
+
+    std::ostringstream oss;
+    std::streambuf* oldBuf = std::cout.rdbuf(oss.rdbuf());
+    list.print();
+    std::cout.rdbuf(oldBuf);
+    REQUIRE(oss.str() == "[start<->a<->b<->x<->c]\n");
+
+    list.removeByValue("b");
+    list.popFront();
+    list.popBack();
+    REQUIRE(contentsOf(list) == std::vector<std::string>{"a", "x"});
+}
+
+TEST_CASE("UnrolledList: случайные операции совпадают с List", "[UnrolledList]")
+{
+    // достаточно элементов для деления блоков, удаления сливают их обратно
+    UnrolledList unrolled;
+    List list;
+    std::uint32_t state = 31;
+    auto next = [&state](std::uint32_t bound) {
+        state = state * 1103515245U + 12345U;
+        return (state >> 8) % bound;
+    };
+    for (int step = 0; step < 20000; ++step) {
+        const std::string a = "v" + std::to_string(next(300));
+        const std::string b = "v" + std::to_string(next(300)) + std::string(next(2) * 40, '#');
+        switch (next(10)) {
+        case 0:  unrolled.pushFront(b);        list.pushFront(b);        break;
+        case 1:
+        case 2:  unrolled.pushBack(b);         list.pushBack(b);         break;
+        case 3:  unrolled.insertAfter(a, b);   list.insertAfter(a, b);   break;
+        case 4:  unrolled.insertBefore(a, b);  list.insertBefore(a, b);  break;
+        case 5:  unrolled.removeAfter(a);      list.removeAfter(a);      break;
+        case 6:  unrolled.removeBefore(a);     list.removeBefore(a);     break;
+        case 7:  unrolled.popFront();          list.popFront();          break;
+        case 8:  unrolled.popBack();           list.popBack();           break;
+        default:
+            if (next(4) == 0) {
+                unrolled.removeByValue(a);
+                list.removeByValue(a);
+            }
+            break;
+        }
+    }
+    REQUIRE(unrolled.serialize() == list.serialize());
+    REQUIRE(unrolled.size() == contentsOf(unrolled).size());
+
+    // опустошение через удаление значений
+    for (int i = 0; i < 300; ++i) {
+        const std::string value = "v" + std::to_string(i);
+        unrolled.removeByValue(value);
+        unrolled.removeByValue(value + std::string(40, '#'));
+    }
+    REQUIRE(unrolled.empty());
+    REQUIRE(unrolled.begin() == unrolled.end());
+}
+
+TEST_CASE("UnrolledList: вставка собственного элемента при делении блока", "[UnrolledList]")
+{
+    UnrolledList list;
+    for (int i = 0; i < 32; ++i) {
+        list.pushBack(std::string(50, static_cast<char>('a' + i % 26)));
+    }
+    const std::string& first = *list.begin();
+    list.insertAfter(first, first);   // полный блок делится
+    list.pushFront(*list.begin());
+    REQUIRE(list.size() == 34);
+    REQUIRE(contentsOf(list)[2] == std::string(50, 'a'));
+}
+
+
+TEST_CASE("UnrolledList: работа у концов сдвигает окна блоков", "[UnrolledList]")
+{
+    // очередь и дек: окно блока уходит от края, блок сдвигается или
+    // заменяется новым, внутренняя вставка идёт в меньшую сторону
+    UnrolledList unrolled;
+    List list;
+    std::uint32_t state = 43;
+    auto next = [&state](std::uint32_t bound) {
+        state = state * 1103515245U + 12345U;
+        return (state >> 8) % bound;
+    };
+    for (int step = 0; step < 30000; ++step) {
+        const std::string value = "e" + std::to_string(step) + std::string(next(2) * 40, '#');
+        const std::uint32_t op = next(step % 3000 < 1500 ? 6 : 7);
+        switch (op) {
+        case 0:
+        case 1:  unrolled.pushBack(value);   list.pushBack(value);   break;
+        case 2:  unrolled.pushFront(value);  list.pushFront(value);  break;
+        case 3:  unrolled.popFront();        list.popFront();        break;
+        case 4:  unrolled.popBack();         list.popBack();         break;
+        case 5: {
+            const std::string anchor = "e" + std::to_string(next(static_cast<std::uint32_t>(step) + 1));
+            unrolled.insertBefore(anchor, value);
+            list.insertBefore(anchor, value);
+            break;
+        }
+        default: unrolled.popFront();        list.popFront();        break;
+        }
+    }
+    REQUIRE(unrolled.serialize() == list.serialize());
+    REQUIRE(unrolled.size() == contentsOf(unrolled).size());
+
+    while (!unrolled.empty()) {
+        unrolled.popFront();
+    }
+    unrolled.pushFront("a");
+    unrolled.pushBack("b");
+    REQUIRE(contentsOf(unrolled) == std::vector<std::string>{"a", "b"});
+}
+
+// 2. СЕРИАЛИЗАЦИЯ
+
+
+TEST_CASE("UnrolledList: форматы сериализации совпадают с List", "[UnrolledList]")
+{
+    UnrolledList unrolled;
+    List list;
+    for (int i = 0; i < 100; ++i) {
+        const std::string value = i % 7 == 0 ? "with spaces " + std::to_string(i) : std::to_string(i);
+        unrolled.pushBack(value);
+        list.pushBack(value);
+    }
+
+    REQUIRE(unrolled.serialize() == list.serialize());
+    std::ostringstream unrolledBinary(std::ios::binary);
+    std::ostringstream listBinary(std::ios::binary);
+    unrolled.serializeBinary(unrolledBinary);
+    list.serializeBinary(listBinary);
+    REQUIRE(unrolledBinary.str() == listBinary.str());
+
+    UnrolledList fromList;
+    fromList.pushBack("old");
+    std::istringstream iss(listBinary.str(), std::ios::binary);
+    fromList.deserializeBinary(iss);
+    REQUIRE(contentsOf(fromList) == contentsOf(unrolled));
+
+    UnrolledList fromText;
+    fromText.deserialize("a\n\nb\n");
+    REQUIRE(contentsOf(fromText) == std::vector<std::string>{"a", "b"});
+
+    std::istringstream truncated(std::string("\x05\0\0\0\0\0\0\0", 8), std::ios::binary);
+    REQUIRE_THROWS_AS(fromText.deserializeBinary(truncated), std::runtime_error);
+}
@@ -0,0 +1,112 @@
+// test_work_stealing_deque.cpp
+#include "catch_amalgamated.hpp"
+#include "work_stealing_deque.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// 1. ОДИН ПОТОК: СТЕК У ВЛАДЕЛЬЦА, ОЧЕРЕДЬ У ВОРА
+
+
+TEST_CASE("WorkStealingDeque: владелец забирает свежие задачи, вор — старые", "[WorkStealingDeque]")
+{
+    WorkStealingDeque deque(2);
+    std::string out;
+    REQUIRE(deque.empty());
+    REQUIRE_FALSE(deque.pop(out));
+    REQUIRE_FALSE(deque.steal(out));
+
+    // кольцо растёт с двух слотов, задачи при этом не теряются
+    const std::string longTask(50, 'T');
+    for (int i = 0; i < 100; ++i) {
+        deque.push(i % 4 == 0 ? longTask + std::to_string(i) : std::to_string(i));
+    }
+    REQUIRE(deque.size() == 100);
+
+    REQUIRE(deque.pop(out));
+    REQUIRE(out == "99");
+    REQUIRE(deque.steal(out));
+    REQUIRE(out == longTask + "0");
+    REQUIRE(deque.steal(out));
+    REQUIRE(out == "1");
+
+    // вперемешку с ростом: порядок у каждого конца сохраняется
+    deque.push("new");
+    REQUIRE(deque.pop(out));
+    REQUIRE(out == "new");
+    int expectedTop = 2;
+    int expectedBottom = 98;
+    while (expectedTop <= expectedBottom) {
+        REQUIRE(deque.steal(out));
+        REQUIRE(out == (expectedTop % 4 == 0 ? longTask : "") + std::to_string(expectedTop));
+        ++expectedTop;
+        if (expectedTop > expectedBottom) {
+            break;
+        }
+        REQUIRE(deque.pop(out));
+        REQUIRE(out == (expectedBottom % 4 == 0 ? longTask : "") + std::to_string(expectedBottom));
+        --expectedBottom;
+    }
+    REQUIRE(deque.empty());
+    REQUIRE_FALSE(deque.pop(out));
+
+    // оставшиеся задачи освобождает деструктор
+    deque.push(longTask);
+}
+
+
+// 2. ВЛАДЕЛЕЦ И ВОРЫ ОДНОВРЕМЕННО
+
+
+TEST_CASE("WorkStealingDeque: каждую задачу выполняют ровно один раз", "[WorkStealingDeque]")
+{
+    WorkStealingDeque deque(8);
+    constexpr int kTasks = 100000;
+    constexpr int kThieves = 3;
+
+    std::vector<std::atomic<int>> done(kTasks);
+    std::atomic<int> finished{0};
+    const auto run = [&](const std::string& task) {
+        done[std::stoi(task)].fetch_add(1);
+        finished.fetch_add(1);
+    };
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < kThieves; ++i) {
+        thieves.emplace_back([&]() {
+            std::string task;
+            while (finished.load() < kTasks) {
+                if (deque.steal(task)) {
+                    run(task);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // владелец кладёт пачками и сам забирает часть — гонка за последний элемент
+    std::string task;
+    for (int i = 0; i < kTasks; ++i) {
+        deque.push(std::to_string(i));
+        if (i % 3 == 0 && deque.pop(task)) {
+            run(task);
+        }
+    }
+    while (deque.pop(task)) {
+        run(task);
+    }
+    for (std::thread& thief : thieves) {
+        thief.join();
+    }
+
+    int wrong = 0;
+    for (const std::atomic<int>& count : done) {
+        wrong += count.load() == 1 ? 0 : 1;
+    }
+    REQUIRE(wrong == 0);
+    REQUIRE(deque.empty());
+}